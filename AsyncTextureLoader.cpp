@@ -0,0 +1,348 @@
+#include "AsyncTextureLoader.h"
+#include "GLStateCache.h"
+#include "GLTrace.h"
+#include "DdsImage.h"
+#include <SFML/Graphics/Image.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+namespace {
+    // Mid-grey: neutral under the lighting while the real texture streams in
+    const unsigned char kPlaceholderGrey = 128;
+
+    // Compressed formats the GL thread confirmed before any job starts
+    // (workers must not query GL state)
+    bool g_formatSupported[3] = { false, false, false };
+}
+
+AsyncTextureLoader::AsyncTextureLoader(ThreadPool& pool, size_t uploadBudgetBytes)
+    : m_pool(pool),
+      m_uploadBudgetBytes(uploadBudgetBytes),
+      m_failed(0) {
+    g_formatSupported[DDS_FORMAT_BC1] = DdsImage::isFormatSupported(DDS_FORMAT_BC1);
+    g_formatSupported[DDS_FORMAT_BC3] = DdsImage::isFormatSupported(DDS_FORMAT_BC3);
+    g_formatSupported[DDS_FORMAT_BC7] = DdsImage::isFormatSupported(DDS_FORMAT_BC7);
+}
+
+AsyncTextureLoader::~AsyncTextureLoader() {
+    // Workers may still be decoding or writing into a mapped PBO
+    m_pool.waitIdle();
+    for (auto& job : m_jobs) {
+        releaseJob(*job);
+    }
+}
+
+std::shared_ptr<Texture> AsyncTextureLoader::load(const std::string& filepath) {
+    auto job = std::make_shared<Job>();
+    job->paths.push_back(filepath);
+    job->texture = std::make_shared<Texture>();
+    job->texture->createPlaceholder(kPlaceholderGrey, kPlaceholderGrey, kPlaceholderGrey);
+
+    startJob(job);
+    return job->texture;
+}
+
+std::shared_ptr<TextureArray> AsyncTextureLoader::loadArray(const std::vector<std::string>& filepaths) {
+    auto job = std::make_shared<Job>();
+    job->paths = filepaths;
+    job->isArray = true;
+    job->layerCount = static_cast<int>(filepaths.size());
+    job->textureArray = std::make_shared<TextureArray>();
+    job->textureArray->createPlaceholder(job->layerCount, kPlaceholderGrey, kPlaceholderGrey, kPlaceholderGrey);
+
+    startJob(job);
+    return job->textureArray;
+}
+
+void AsyncTextureLoader::startJob(const std::shared_ptr<Job>& job) {
+    m_jobs.push_back(job);
+    m_pool.enqueue([job]() {
+        decode(*job);
+    });
+}
+
+// =====================================================
+// Worker side
+// =====================================================
+
+void AsyncTextureLoader::decode(Job& job) {
+    if (job.paths.empty()) {
+        job.error = "no files";
+        job.state = JOB_FAILED;
+        return;
+    }
+
+    if (decodeCompressed(job) || decodeImages(job)) {
+        job.state = JOB_DECODED;
+    }
+    else {
+        job.state = JOB_FAILED;
+    }
+}
+
+bool AsyncTextureLoader::decodeCompressed(Job& job) {
+    std::vector<DdsImage> images(job.paths.size());
+    for (size_t i = 0; i < job.paths.size(); ++i) {
+        if (!images[i].loadFromFile(Texture::getCompressedPath(job.paths[i]))) {
+            return false;
+        }
+
+        const DdsImage& first = images[0];
+        if (!g_formatSupported[images[i].getFormat()] ||
+            images[i].getFormat() != first.getFormat() ||
+            images[i].getWidth() != first.getWidth() || images[i].getHeight() != first.getHeight() ||
+            images[i].getLevels().size() != first.getLevels().size()) {
+            return false;
+        }
+    }
+
+    // Per level, all layers back to back: one region per glCompressedTexImage3D
+    job.pixels.clear();
+    job.levels.clear();
+    for (size_t level = 0; level < images[0].getLevels().size(); ++level) {
+        LevelRegion region;
+        region.width = images[0].getLevels()[level].width;
+        region.height = images[0].getLevels()[level].height;
+        region.offset = job.pixels.size();
+
+        for (const auto& image : images) {
+            const std::vector<uint8_t>& data = image.getLevels()[level].data;
+            job.pixels.insert(job.pixels.end(), data.begin(), data.end());
+        }
+
+        region.size = job.pixels.size() - region.offset;
+        job.levels.push_back(region);
+    }
+
+    job.compressedFormat = images[0].getGLFormat();
+    job.formatName = images[0].getFormatName();
+    return true;
+}
+
+bool AsyncTextureLoader::decodeImages(Job& job) {
+    std::vector<sf::Image> images(job.paths.size());
+    unsigned int width = 0;
+    unsigned int height = 0;
+
+    for (size_t i = 0; i < job.paths.size(); ++i) {
+        if (!images[i].loadFromFile(job.paths[i])) {
+            job.error = "failed to decode " + job.paths[i];
+            return false;
+        }
+
+        // Flip image vertically (OpenGL expects origin at bottom-left)
+        images[i].flipVertically();
+
+        width = std::max(width, images[i].getSize().x);
+        height = std::max(height, images[i].getSize().y);
+    }
+
+    size_t layerBytes = static_cast<size_t>(width) * height * 4;
+    job.pixels.resize(layerBytes * images.size());
+
+    for (size_t i = 0; i < images.size(); ++i) {
+        sf::Vector2u size = images[i].getSize();
+        unsigned char* dst = job.pixels.data() + layerBytes * i;
+
+        if (size.x == width && size.y == height) {
+            std::memcpy(dst, images[i].getPixelsPtr(), layerBytes);
+        }
+        else {
+            std::vector<unsigned char> resized = TextureArray::resample(images[i].getPixelsPtr(), size.x, size.y, width, height);
+            std::memcpy(dst, resized.data(), layerBytes);
+        }
+    }
+
+    LevelRegion region;
+    region.width = width;
+    region.height = height;
+    region.offset = 0;
+    region.size = job.pixels.size();
+
+    job.levels.clear();
+    job.levels.push_back(region);
+    job.compressedFormat = 0;
+    job.formatName = "RGBA";
+    return true;
+}
+
+// =====================================================
+// GL thread
+// =====================================================
+
+void AsyncTextureLoader::update() {
+    size_t budget = m_uploadBudgetBytes;
+    bool mappedAny = false;
+
+    for (size_t i = 0; i < m_jobs.size();) {
+        Job& job = *m_jobs[i];
+        bool done = false;
+
+        switch (job.state.load()) {
+        case JOB_DECODED:
+            // Always let one job through so a texture bigger than the budget still loads
+            if (!mappedAny || job.pixels.size() <= budget) {
+                budget -= std::min(budget, job.pixels.size());
+                mappedAny = true;
+                if (!beginCopy(m_jobs[i])) {
+                    job.state = JOB_FAILED;
+                }
+            }
+            break;
+
+        case JOB_COPIED:
+            issueUpload(job);
+            break;
+
+        case JOB_UPLOADING: {
+            GLenum status = glClientWaitSync(job.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+            if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+                done = true;
+            }
+            break;
+        }
+
+        case JOB_FAILED:
+            std::cerr << "Async texture load failed: " << job.error << std::endl;
+            ++m_failed;
+            done = true;
+            break;
+
+        default:
+            break;  // A worker owns the job right now
+        }
+
+        if (done) {
+            releaseJob(job);
+            m_jobs.erase(m_jobs.begin() + i);
+        }
+        else {
+            ++i;
+        }
+    }
+}
+
+void AsyncTextureLoader::finishAll() {
+    while (!m_jobs.empty()) {
+        update();
+        if (!m_jobs.empty()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+bool AsyncTextureLoader::beginCopy(const std::shared_ptr<Job>& job) {
+    GLsizeiptr size = static_cast<GLsizeiptr>(job->pixels.size());
+    MAZE_GL_TRACE_UPLOAD(job->pixels.size());  // The texture calls later only copy on the GPU
+
+    glGenBuffers(1, &job->pbo);
+    GLStateCache::get().bindBuffer(GL_PIXEL_UNPACK_BUFFER, job->pbo);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    job->mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+    if (!job->mapped) {
+        // Mapping failed (rare); let the driver copy instead
+        glBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, size, job->pixels.data());
+        GLStateCache::get().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        job->state = JOB_COPIED;
+        return true;
+    }
+    GLStateCache::get().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    // The memcpy into driver memory happens on a worker, not in this frame
+    job->state = JOB_COPYING;
+    m_pool.enqueue([job]() {
+        std::memcpy(job->mapped, job->pixels.data(), job->pixels.size());
+        job->state = JOB_COPIED;
+    });
+    return true;
+}
+
+void AsyncTextureLoader::issueUpload(Job& job) {
+    GLStateCache::get().bindBuffer(GL_PIXEL_UNPACK_BUFFER, job.pbo);
+    if (job.mapped) {
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        job.mapped = nullptr;
+    }
+
+    GLenum target = job.isArray ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D;
+    GLuint textureId = job.isArray ? job.textureArray->getTextureId() : job.texture->getTextureId();
+    GLStateCache::get().bindTexture(target, textureId);
+
+    // Pointers are offsets into the bound unpack buffer
+    int levelCount = static_cast<int>(job.levels.size());
+    for (int level = 0; level < levelCount; ++level) {
+        const LevelRegion& region = job.levels[level];
+        const void* offset = reinterpret_cast<const void*>(region.offset);
+
+        if (job.compressedFormat != 0) {
+            if (job.isArray) {
+                glCompressedTexImage3D(target, level, job.compressedFormat, region.width, region.height,
+                    job.layerCount, 0, static_cast<GLsizei>(region.size), offset);
+            }
+            else {
+                glCompressedTexImage2D(target, level, job.compressedFormat, region.width, region.height,
+                    0, static_cast<GLsizei>(region.size), offset);
+            }
+        }
+        else if (job.isArray) {
+            glTexImage3D(target, level, GL_RGBA8, region.width, region.height, job.layerCount, 0,
+                GL_RGBA, GL_UNSIGNED_BYTE, offset);
+        }
+        else {
+            glTexImage2D(target, level, GL_RGBA8, region.width, region.height, 0,
+                GL_RGBA, GL_UNSIGNED_BYTE, offset);
+        }
+    }
+
+    GLStateCache::get().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    // Uncompressed images get their mips on the GPU, as Texture::loadFromFile does
+    if (job.compressedFormat == 0) {
+        glGenerateMipmap(target);
+        levelCount = 1;
+        for (unsigned int s = std::max(job.levels[0].width, job.levels[0].height); s > 1; s /= 2) {
+            ++levelCount;
+        }
+    }
+
+    if (job.isArray) {
+        TextureArray::setSamplingParameters(levelCount);
+    }
+    else {
+        glTexParameteri(target, GL_TEXTURE_MIN_FILTER, levelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+        glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+    }
+    GLStateCache::get().bindTexture(target, 0);
+
+    job.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    job.state = JOB_UPLOADING;
+
+    std::cout << "Streamed texture: " << job.paths[0];
+    if (job.isArray) std::cout << " (+" << job.layerCount - 1 << " layers)";
+    std::cout << " (" << job.levels[0].width << "x" << job.levels[0].height << ", " << job.formatName
+        << ", " << job.pixels.size() / 1024 << " KB)" << std::endl;
+
+    // The PBO holds the data now
+    std::vector<unsigned char>().swap(job.pixels);
+}
+
+void AsyncTextureLoader::releaseJob(Job& job) {
+    if (job.mapped) {
+        GLStateCache::get().bindBuffer(GL_PIXEL_UNPACK_BUFFER, job.pbo);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        GLStateCache::get().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        job.mapped = nullptr;
+    }
+    if (job.pbo != 0) {
+        GLStateCache::get().deleteBuffer(job.pbo);
+        job.pbo = 0;
+    }
+    if (job.fence) {
+        glDeleteSync(job.fence);
+        job.fence = nullptr;
+    }
+}
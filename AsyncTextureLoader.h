@@ -0,0 +1,110 @@
+#ifndef ASYNCTEXTURELOADER_H
+#define ASYNCTEXTURELOADER_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <gl/glew/glew.h>
+#include "Texture.h"
+#include "TextureArray.h"
+#include "ThreadPool.h"
+
+/**
+ * @class AsyncTextureLoader
+ * @brief Decodes images on a ThreadPool and streams them to the GPU through PBOs
+ *
+ * load()/loadArray() return a texture at once, showing a small placeholder.
+ * Each job then goes through these steps:
+ *   worker: read .dds or decode the image (and resample array layers)
+ *   main:   map a pixel buffer object     worker: copy the pixels into it
+ *   main:   unmap, upload from the PBO, fence   main: fence signalled, PBO freed
+ * The texture keeps its GL name throughout, so callers never rebind anything.
+ * update() must be called on the GL thread, typically once per frame. It
+ * maps at most uploadBudgetBytes of new data per call so frames stay smooth.
+ */
+class AsyncTextureLoader {
+public:
+    explicit AsyncTextureLoader(ThreadPool& pool, size_t uploadBudgetBytes = 32 * 1024 * 1024);
+    ~AsyncTextureLoader();
+
+    AsyncTextureLoader(const AsyncTextureLoader&) = delete;
+    AsyncTextureLoader& operator=(const AsyncTextureLoader&) = delete;
+
+    /**
+     * @brief Start loading a 2D texture (a sibling .dds is preferred, as in Texture)
+     */
+    std::shared_ptr<Texture> load(const std::string& filepath);
+
+    /**
+     * @brief Start loading a texture array, one file per layer
+     */
+    std::shared_ptr<TextureArray> loadArray(const std::vector<std::string>& filepaths);
+
+    /**
+     * @brief Advance pending jobs; GL thread only, never blocks on a worker
+     */
+    void update();
+
+    /**
+     * @brief Block until every job has finished (loading screens, tools)
+     */
+    void finishAll();
+
+    size_t getPendingCount() const { return m_jobs.size(); }
+    int getFailedCount() const { return m_failed; }
+
+private:
+    enum JobState {
+        JOB_DECODING,     // Worker reading the files
+        JOB_DECODED,      // Waiting for a PBO
+        JOB_COPYING,      // Worker copying into the mapped PBO
+        JOB_COPIED,       // Ready to unmap and upload
+        JOB_UPLOADING,    // Upload issued, waiting on the fence
+        JOB_FAILED
+    };
+
+    struct LevelRegion {
+        unsigned int width;
+        unsigned int height;
+        size_t offset;   // Into the pixel buffer; covers every layer of the level
+        size_t size;
+    };
+
+    struct Job {
+        std::vector<std::string> paths;
+        bool isArray = false;
+        std::shared_ptr<Texture> texture;
+        std::shared_ptr<TextureArray> textureArray;
+
+        std::atomic<int> state{ JOB_DECODING };
+        std::string error;
+
+        // Decoded data, laid out exactly as it goes into the PBO
+        std::vector<unsigned char> pixels;
+        std::vector<LevelRegion> levels;
+        GLenum compressedFormat = 0;  // 0 for RGBA8
+        const char* formatName = "RGBA";
+        int layerCount = 1;
+
+        GLuint pbo = 0;
+        void* mapped = nullptr;
+        GLsync fence = nullptr;
+    };
+
+    ThreadPool& m_pool;
+    size_t m_uploadBudgetBytes;
+    std::vector<std::shared_ptr<Job>> m_jobs;
+    int m_failed;
+
+    void startJob(const std::shared_ptr<Job>& job);
+    static void decode(Job& job);
+    static bool decodeCompressed(Job& job);
+    static bool decodeImages(Job& job);
+
+    bool beginCopy(const std::shared_ptr<Job>& job);
+    void issueUpload(Job& job);
+    void releaseJob(Job& job);
+};
+
+#endif // ASYNCTEXTURELOADER_H
@@ -0,0 +1,384 @@
+#include "Benchmarks.h"
+#include "SimdMath.h"
+#include "Renderer.h"
+#include "Maze.h"
+#include "ObservationRenderer.h"
+#include "ThreadPool.h"
+#include <SFML/Window/Context.hpp>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+    typedef std::chrono::high_resolution_clock BenchClock;
+
+    // Keeps results alive so the optimizer cannot drop the measured loops
+    volatile float g_sink = 0.0f;
+
+    template <typename Fn>
+    double measureNs(int iterations, Fn&& fn) {
+        fn(); // warm-up
+        auto start = BenchClock::now();
+        for (int i = 0; i < iterations; ++i) {
+            fn();
+        }
+        auto end = BenchClock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    }
+
+    void printRow(const char* name, std::size_t elements, double scalarNs, double simdNs) {
+        std::cout << "  " << std::left << std::setw(28) << name
+            << std::right << std::setw(12) << std::fixed << std::setprecision(2) << scalarNs / elements
+            << std::setw(12) << simdNs / elements
+            << std::setw(10) << std::setprecision(2) << (simdNs > 0.0 ? scalarNs / simdNs : 0.0) << "x"
+            << std::endl;
+    }
+
+    float randomFloat(float lo, float hi) {
+        return lo + (hi - lo) * (static_cast<float>(std::rand()) / RAND_MAX);
+    }
+
+    // ---- Scalar reference code (the pre-SimdMath implementations) ----
+
+    typedef std::array<float, 16> ScalarMat;
+
+    ScalarMat scalarMultiply(const ScalarMat& a, const ScalarMat& b) {
+        ScalarMat r{};
+        for (int c = 0; c < 4; ++c) {
+            for (int row = 0; row < 4; ++row) {
+                float sum = 0.0f;
+                for (int k = 0; k < 4; ++k) {
+                    sum += a[k * 4 + row] * b[c * 4 + k];
+                }
+                r[c * 4 + row] = sum;
+            }
+        }
+        return r;
+    }
+
+    Vector3 scalarTransform(const ScalarMat& m, const Vector3& p) {
+        return Vector3(
+            m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12],
+            m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13],
+            m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14]
+        );
+    }
+
+    bool scalarAABBVisible(const float planes[6][4], const AABB& box) {
+        for (int i = 0; i < 6; ++i) {
+            float px = planes[i][0] > 0.0f ? box.max.x : box.min.x;
+            float py = planes[i][1] > 0.0f ? box.max.y : box.min.y;
+            float pz = planes[i][2] > 0.0f ? box.max.z : box.min.z;
+            if (planes[i][0] * px + planes[i][1] * py + planes[i][2] * pz + planes[i][3] < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void scalarExtractPlanes(const ScalarMat& m, float planes[6][4]) {
+        for (int i = 0; i < 3; ++i) {
+            for (int k = 0; k < 4; ++k) {
+                float row3 = m[k * 4 + 3];
+                float rowI = m[k * 4 + i];
+                planes[i * 2][k] = row3 + rowI;
+                planes[i * 2 + 1][k] = row3 - rowI;
+            }
+        }
+        for (int i = 0; i < 6; ++i) {
+            float len = std::sqrt(planes[i][0] * planes[i][0] + planes[i][1] * planes[i][1] + planes[i][2] * planes[i][2]);
+            for (int k = 0; k < 4; ++k) planes[i][k] /= len;
+        }
+    }
+}
+
+int Benchmarks::runMath() {
+    const std::size_t count = 4096;
+    const int iterations = 2000;
+
+    std::srand(1234);
+
+    std::vector<Vector3> points(count);
+    for (auto& p : points) {
+        p = Vector3(randomFloat(-50.0f, 50.0f), randomFloat(0.0f, 3.0f), randomFloat(-50.0f, 50.0f));
+    }
+    std::vector<Vector3> output(count);
+    std::vector<Vector3> work(count);
+
+    std::vector<AABB> boxes(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        boxes[i] = AABB::fromCenter(points[i], Vector3(1.0f, 1.5f, 1.0f));
+    }
+    std::vector<unsigned char> visible(count);
+
+    Mat4 view = Mat4::view(Vector3(1, 0, 0), Vector3(0, 1, 0), Vector3(0, 0, -1), Vector3(0, 1.7f, 0));
+    Mat4 proj = Mat4::perspective(60.0f, 16.0f / 9.0f, 0.1f, 100.0f);
+    Mat4 viewProj = proj * view;
+
+    ScalarMat scalarView, scalarProj;
+    for (int i = 0; i < 16; ++i) {
+        scalarView[i] = view.data()[i];
+        scalarProj[i] = proj.data()[i];
+    }
+    ScalarMat scalarViewProj = scalarMultiply(scalarProj, scalarView);
+
+    std::cout << "SimdMath microbenchmarks (backend: " << simd::backendName() << ")" << std::endl;
+    std::cout << "  " << std::left << std::setw(28) << "operation"
+        << std::right << std::setw(12) << "scalar ns" << std::setw(12) << "simd ns" << std::setw(11) << "speedup"
+        << std::endl;
+
+    // Matrix multiply
+    {
+        double scalarNs = measureNs(iterations, [&]() {
+            ScalarMat r = scalarViewProj;
+            for (int i = 0; i < 256; ++i) r = scalarMultiply(r, scalarView);
+            g_sink = g_sink + r[0];
+        });
+        double simdNs = measureNs(iterations, [&]() {
+            Mat4 r = viewProj;
+            for (int i = 0; i < 256; ++i) r = r * view;
+            g_sink = g_sink + r.data()[0];
+        });
+        printRow("mat4 * mat4", 256, scalarNs, simdNs);
+    }
+
+    // Batched transform
+    {
+        double scalarNs = measureNs(iterations, [&]() {
+            for (std::size_t i = 0; i < count; ++i) output[i] = scalarTransform(scalarViewProj, points[i]);
+            g_sink = g_sink + output[count / 2].x;
+        });
+        double simdNs = measureNs(iterations, [&]() {
+            transformPoints(viewProj, points.data(), output.data(), count);
+            g_sink = g_sink + output[count / 2].x;
+        });
+        printRow("transform points", count, scalarNs, simdNs);
+    }
+
+    // Batched normalize
+    {
+        double scalarNs = measureNs(iterations, [&]() {
+            for (std::size_t i = 0; i < count; ++i) work[i] = points[i].normalize();
+            g_sink = g_sink + work[count / 2].x;
+        });
+        double simdNs = measureNs(iterations, [&]() {
+            work = points;
+            normalizeBatch(work.data(), count);
+            g_sink = g_sink + work[count / 2].x;
+        });
+        printRow("normalize", count, scalarNs, simdNs);
+    }
+
+    // Frustum vs AABB
+    {
+        float planes[6][4];
+        scalarExtractPlanes(scalarViewProj, planes);
+        Frustum frustum(viewProj);
+
+        std::size_t scalarVisible = 0;
+        std::size_t simdVisible = 0;
+        double scalarNs = measureNs(iterations, [&]() {
+            scalarVisible = 0;
+            for (std::size_t i = 0; i < count; ++i) {
+                visible[i] = scalarAABBVisible(planes, boxes[i]) ? 1 : 0;
+                scalarVisible += visible[i];
+            }
+        });
+        double simdNs = measureNs(iterations, [&]() {
+            simdVisible = frustum.cullAABBs(boxes.data(), count, visible.data());
+        });
+        printRow("frustum vs AABB", count, scalarNs, simdNs);
+
+        if (scalarVisible != simdVisible) {
+            std::cerr << "  MISMATCH: scalar culled to " << scalarVisible
+                << " boxes, SIMD to " << simdVisible << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+namespace {
+    // CPU time to issue fn's GL calls; the GPU is drained outside the timed region
+    template <typename Fn>
+    double measureSubmissionUs(int iterations, Fn&& fn) {
+        fn();
+        glFinish();
+
+        double totalUs = 0.0;
+        for (int i = 0; i < iterations; ++i) {
+            auto start = BenchClock::now();
+            fn();
+            auto end = BenchClock::now();
+            totalUs += std::chrono::duration<double, std::micro>(end - start).count();
+            glFinish();
+        }
+        return totalUs / iterations;
+    }
+}
+
+int Benchmarks::runSubmission() {
+    const int iterations = 200;
+
+    sf::ContextSettings settings(24, 8, 0, 3, 3);
+    sf::Context context(settings, 64, 64);
+
+    Renderer renderer;
+    if (!renderer.initialize() || !renderer.finishShaders()) {
+        std::cerr << "Submission benchmark: renderer setup failed" << std::endl;
+        return 1;
+    }
+    renderer.setViewport(64, 64);
+
+    // Compare draw submission alone; the pre-pass would submit the batch twice
+    renderer.setDepthPrepassEnabled(false);
+
+    // A large maze so there are enough chunks to see the per-draw cost
+    Maze maze(201, 201);
+    MazeMaterials materials;
+    materials.floorLayer = 0;
+    materials.ceilingLayer = 1;
+    materials.wallLayer = 2;
+
+    std::vector<MazeChunk> chunks;
+    maze.generateChunkMeshes(chunks, materials);
+
+    TextureArray textures;
+    textures.createPlaceholder(3, 128, 128, 128);
+
+    Vector3 start = maze.getStartPosition();
+    Camera camera(Vector3(start.x, 1.7f, start.z), 45.0f, -10.0f);
+    renderer.beginFrameWithFlashlight(camera, maze.getExitPosition(), 0.0f, true, 1.0f);
+
+    const float identity[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+    bool indirectSupported = renderer.isIndirectDrawSupported();
+
+    // Only submission cost is of interest, so skip rasterization entirely
+    glEnable(GL_RASTERIZER_DISCARD);
+
+    std::cout << "Maze chunk submission (" << chunks.size() << " chunks, CPU us per frame, "
+        << iterations << " frames)" << std::endl;
+    std::cout << "  " << std::right << std::setw(8) << "chunks"
+        << std::setw(14) << "per-chunk" << std::setw(14) << "multi-draw" << std::setw(14) << "indirect"
+        << std::setw(11) << "speedup" << std::endl;
+
+    std::vector<const Mesh*> visible;
+    for (size_t count = 1; ; count *= 4) {
+        count = std::min(count, chunks.size());
+
+        visible.clear();
+        for (size_t i = 0; i < count; ++i) {
+            visible.push_back(&chunks[i].mesh);
+        }
+
+        double perChunkUs = measureSubmissionUs(iterations, [&]() {
+            for (const Mesh* mesh : visible) {
+                renderer.renderMesh(*mesh, textures, identity);
+            }
+        });
+
+        renderer.setIndirectDrawEnabled(false);
+        double multiDrawUs = measureSubmissionUs(iterations, [&]() {
+            renderer.renderMeshBatch(visible, textures, identity);
+        });
+
+        double indirectUs = 0.0;
+        if (indirectSupported) {
+            renderer.setIndirectDrawEnabled(true);
+            indirectUs = measureSubmissionUs(iterations, [&]() {
+                renderer.renderMeshBatch(visible, textures, identity);
+            });
+        }
+
+        double bestBatchUs = indirectSupported ? std::min(multiDrawUs, indirectUs) : multiDrawUs;
+        std::cout << "  " << std::setw(8) << count << std::fixed << std::setprecision(1)
+            << std::setw(14) << perChunkUs << std::setw(14) << multiDrawUs;
+        if (indirectSupported) {
+            std::cout << std::setw(14) << indirectUs;
+        }
+        else {
+            std::cout << std::setw(14) << "n/a";
+        }
+        std::cout << std::setw(10) << std::setprecision(1) << (bestBatchUs > 0.0 ? perChunkUs / bestBatchUs : 0.0)
+            << "x" << std::endl;
+
+        if (count == chunks.size()) break;
+    }
+
+    glDisable(GL_RASTERIZER_DISCARD);
+    return 0;
+}
+
+int Benchmarks::runObservations() {
+    const int agentCount = 256;
+    const int iterations = 20;
+
+    Maze maze(31, 31, 1);
+    CollectibleManager collectibles;
+    collectibles.initialize(maze, 1);
+
+    // Agents spread along the solution path, each looking a different way
+    std::vector<Vector3> path = maze.findPath();
+    std::vector<AgentPose> poses(agentCount);
+    for (int i = 0; i < agentCount; ++i) {
+        Vector3 cell = path[(i * 7) % path.size()];
+        poses[i].position = Vector3(cell.x, 1.7f, cell.z);
+        poses[i].yaw = static_cast<float>((i * 37) % 360);
+        poses[i].pitch = static_cast<float>((i % 5) * 4 - 8);
+    }
+
+    ThreadPool pool;
+    std::vector<float> tensor;
+
+    std::cout << "Observation rendering (" << agentCount << " agents, "
+        << iterations << " batches, pool of " << pool.getThreadCount() << " threads)" << std::endl;
+    std::cout << "  " << std::left << std::setw(12) << "resolution"
+        << std::right << std::setw(16) << "1 thread" << std::setw(16) << "pool"
+        << std::setw(11) << "speedup" << std::endl;
+
+    const int sizes[] = { 32, 64, 128 };
+    for (int size : sizes) {
+        double agentFramesPerSecond[2] = { 0.0, 0.0 };
+        for (int threaded = 0; threaded < 2; ++threaded) {
+            ObservationRenderer renderer(threaded ? &pool : nullptr);
+            renderer.setResolution(size, size);
+            renderer.setMaze(maze);
+            renderer.setOrbs(collectibles.getCollectibles());
+            tensor.resize(renderer.getTensorSize(agentCount));
+
+            double batchNs = measureNs(iterations, [&]() {
+                renderer.render(poses.data(), agentCount, tensor.data());
+                g_sink = g_sink + tensor[tensor.size() / 2];
+            });
+            agentFramesPerSecond[threaded] = batchNs > 0.0 ? agentCount * 1.0e9 / batchNs : 0.0;
+        }
+
+        std::cout << "  " << std::left << std::setw(12) << (std::to_string(size) + "x" + std::to_string(size))
+            << std::right << std::fixed << std::setprecision(0)
+            << std::setw(12) << agentFramesPerSecond[0] << " f/s"
+            << std::setw(12) << agentFramesPerSecond[1] << " f/s"
+            << std::setw(10) << std::setprecision(2)
+            << (agentFramesPerSecond[0] > 0.0 ? agentFramesPerSecond[1] / agentFramesPerSecond[0] : 0.0)
+            << "x" << std::endl;
+    }
+    return 0;
+}
+
+int Benchmarks::run(const std::string& name) {
+    if (name == "math") {
+        return runMath();
+    }
+    if (name == "submission") {
+        return runSubmission();
+    }
+    if (name == "observations") {
+        return runObservations();
+    }
+
+    std::cerr << "Unknown benchmark '" << name << "'. Available: math, submission, observations" << std::endl;
+    return 1;
+}
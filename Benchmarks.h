@@ -0,0 +1,36 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <string>
+
+/**
+ * @brief Developer microbenchmarks, run with `3D-Maze --bench <name>`
+ *
+ * Each benchmark prints its results to stdout and returns a process exit code.
+ */
+namespace Benchmarks {
+    /**
+     * @brief Compare SimdMath against the scalar Vector3 / std::array code it replaced
+     */
+    int runMath();
+
+    /**
+     * @brief CPU cost of drawing N maze chunks one by one versus one multi-draw
+     *
+     * Creates its own offscreen GL context; run from the game directory so
+     * the shaders are found.
+     */
+    int runSubmission();
+
+    /**
+     * @brief Agent-frames per second of ObservationRenderer, one thread versus the pool
+     */
+    int runObservations();
+
+    /**
+     * @brief Dispatch by name; prints the list of benchmarks for unknown names
+     */
+    int run(const std::string& name);
+}
+
+#endif // BENCHMARKS_H
@@ -15,24 +15,14 @@ Camera::Camera(const Vector3& position, float yaw, float pitch)
 
 void Camera::moveForward(float distance) {
     // Move only on horizontal plane (ignore Y component)
-    Vector3 horizontalFront = m_front;
-    horizontalFront.y = 0.0f;
-    float length = horizontalFront.length();
-    if (length > 0.0f) {
-        horizontalFront = horizontalFront * (1.0f / length);
-    }
-    m_position += horizontalFront * distance;
+    Vec4 horizontalFront = Vec4(m_front).flattened().normalized3();
+    m_position = (Vec4(m_position) + horizontalFront * distance).toVector3();
 }
 
 void Camera::moveBackward(float distance) {
     // Move only on horizontal plane (ignore Y component)
-    Vector3 horizontalFront = m_front;
-    horizontalFront.y = 0.0f;
-    float length = horizontalFront.length();
-    if (length > 0.0f) {
-        horizontalFront = horizontalFront * (1.0f / length);
-    }
-    m_position -= horizontalFront * distance;
+    Vec4 horizontalFront = Vec4(m_front).flattened().normalized3();
+    m_position = (Vec4(m_position) - horizontalFront * distance).toVector3();
 }
 
 void Camera::moveLeft(float distance) {
@@ -54,6 +44,12 @@ void Camera::rotate(float deltaYaw, float deltaPitch) {
     updateCameraVectors();
 }
 
+void Camera::setOrientation(float yaw, float pitch) {
+    m_yaw = 0.0f;
+    m_pitch = 0.0f;
+    rotate(yaw, pitch);
+}
+
 void Camera::updateCameraVectors() {
     // Calculate new front vector
     float yawRad = m_yaw * M_PI / 180.0f;
@@ -70,32 +66,19 @@ void Camera::updateCameraVectors() {
     m_up = m_right.cross(m_front).normalize();
 }
 
-std::array<float, 16> Camera::getViewMatrix() const {
+Mat4 Camera::getViewMatrix() const {
     Vector3 f = m_front.normalize();
     Vector3 r = m_right.normalize();
     Vector3 u = m_up.normalize();
 
-    std::array<float, 16> view = {
-        r.x,  u.x, -f.x,  0.0f,  // Column 0
-        r.y,  u.y, -f.y,  0.0f,  // Column 1
-        r.z,  u.z, -f.z,  0.0f,  // Column 2
-        -r.dot(m_position), -u.dot(m_position), f.dot(m_position), 1.0f // Column 3
-    };
-
-    return view;
+    return Mat4::view(r, u, f, m_position);
 }
 
-std::array<float, 16> Camera::getProjectionMatrix(float fov, float aspect, float near, float far) const {
+Mat4 Camera::getProjectionMatrix(float fov, float aspect, float near, float far) const {
     // Perspective projection matrix (column-major for OpenGL)
-    float tanHalfFov = std::tan(fov * M_PI / 360.0f);
-
-    // CRITICAL: Proper column-major projection matrix
-    std::array<float, 16> proj = {
-        1.0f / (aspect * tanHalfFov), 0.0f, 0.0f, 0.0f,
-        0.0f, 1.0f / tanHalfFov, 0.0f, 0.0f,
-        0.0f, 0.0f, -(far + near) / (far - near), -1.0f,
-        0.0f, 0.0f, -(2.0f * far * near) / (far - near), 0.0f
-    };
+    return Mat4::perspective(fov, aspect, near, far);
+}
 
-    return proj;
+Frustum Camera::getFrustum(float fov, float aspect, float near, float far) const {
+    return Frustum(getProjectionMatrix(fov, aspect, near, far) * getViewMatrix());
 }
\ No newline at end of file
@@ -2,7 +2,7 @@
 #define CAMERA_H
 
 #include "Vector3.h"
-#include <array>
+#include "SimdMath.h"
 
 /**
  * @class Camera
@@ -23,22 +23,30 @@ public:
 
     // Camera rotation
     void rotate(float deltaYaw, float deltaPitch);
+    void setOrientation(float yaw, float pitch);
 
     // Getters
     Vector3 getPosition() const { return m_position; }
     Vector3 getFront() const { return m_front; }
     Vector3 getUp() const { return m_up; }
     Vector3 getRight() const { return m_right; }
+    float getYaw() const { return m_yaw; }
+    float getPitch() const { return m_pitch; }
 
     /**
      * @brief Get view matrix (LookAt matrix)
      */
-    std::array<float, 16> getViewMatrix() const;
+    Mat4 getViewMatrix() const;
 
     /**
      * @brief Get projection matrix (perspective)
      */
-    std::array<float, 16> getProjectionMatrix(float fov, float aspect, float near, float far) const;
+    Mat4 getProjectionMatrix(float fov, float aspect, float near, float far) const;
+
+    /**
+     * @brief Get the view frustum for culling (same parameters as the projection)
+     */
+    Frustum getFrustum(float fov, float aspect, float near, float far) const;
 
     // Setters
     void setPosition(const Vector3& position) { m_position = position; }
@@ -0,0 +1,72 @@
+#include "CameraPath.h"
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+    // How far ahead along the path the camera looks
+    const float kLookAhead = 1.5f;
+    const float kPitch = -5.0f;
+}
+
+CameraPath::CameraPath(const std::vector<Vector3>& points, float speed)
+    : m_points(points), m_speed(speed), m_length(0.0f) {
+    m_distances.reserve(m_points.size());
+    for (size_t i = 0; i < m_points.size(); ++i) {
+        if (i > 0) {
+            m_length += (m_points[i] - m_points[i - 1]).length();
+        }
+        m_distances.push_back(m_length);
+    }
+}
+
+Vector3 CameraPath::pointAt(float distance) const {
+    distance = std::max(0.0f, std::min(distance, m_length));
+
+    // First point at or beyond the distance
+    size_t next = std::lower_bound(m_distances.begin(), m_distances.end(), distance) - m_distances.begin();
+    if (next == 0) {
+        return m_points.front();
+    }
+    if (next >= m_points.size()) {
+        return m_points.back();
+    }
+
+    float segment = m_distances[next] - m_distances[next - 1];
+    float t = segment > 0.0f ? (distance - m_distances[next - 1]) / segment : 0.0f;
+    return m_points[next - 1] + (m_points[next] - m_points[next - 1]) * t;
+}
+
+void CameraPath::sample(float time, Vector3& position, float& yaw, float& pitch) const {
+    pitch = kPitch;
+    if (m_points.empty()) {
+        position = Vector3(0.0f, 0.0f, 0.0f);
+        yaw = -90.0f;
+        return;
+    }
+    if (m_length <= 0.0f) {
+        position = m_points.front();
+        yaw = -90.0f;
+        return;
+    }
+
+    // There and back: the second half of each cycle walks the path reversed
+    float travelled = std::fmod(time * m_speed, 2.0f * m_length);
+    bool returning = travelled > m_length;
+    float distance = returning ? 2.0f * m_length - travelled : travelled;
+    float ahead = returning ? distance - kLookAhead : distance + kLookAhead;
+
+    position = pointAt(distance);
+    Vector3 target = pointAt(ahead);
+
+    // Within kLookAhead of either end the target clamps onto the position
+    if ((target - position).length() < 1e-3f) {
+        target = pointAt(returning ? distance + kLookAhead : distance - kLookAhead);
+        target = position + (position - target);
+    }
+
+    yaw = static_cast<float>(std::atan2(target.z - position.z, target.x - position.x) * 180.0 / M_PI);
+}
@@ -0,0 +1,40 @@
+#ifndef CAMERAPATH_H
+#define CAMERAPATH_H
+
+#include "Vector3.h"
+#include <vector>
+
+/**
+ * @class CameraPath
+ * @brief Scripted walk along a polyline, for reproducible benchmark runs
+ *
+ * Moves at constant speed from the first point to the last and back again,
+ * looking a little way ahead along the path. Sampling depends only on the
+ * time passed in, so two runs with the same path see the same frames.
+ */
+class CameraPath {
+public:
+    /**
+     * @param points Feet-level positions, e.g. from Maze::findPath
+     * @param speed Walking speed in units per second
+     */
+    explicit CameraPath(const std::vector<Vector3>& points, float speed = 2.5f);
+
+    /**
+     * @brief Position and view direction (degrees, as Camera uses them) at a time
+     */
+    void sample(float time, Vector3& position, float& yaw, float& pitch) const;
+
+    float getLength() const { return m_length; }
+    bool isEmpty() const { return m_points.empty(); }
+
+private:
+    std::vector<Vector3> m_points;
+    std::vector<float> m_distances;  // Path length up to each point
+    float m_speed;
+    float m_length;
+
+    Vector3 pointAt(float distance) const;
+};
+
+#endif // CAMERAPATH_H
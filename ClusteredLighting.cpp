@@ -0,0 +1,193 @@
+#include "ClusteredLighting.h"
+#include "GLStateCache.h"
+#include "GLTrace.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+    /**
+     * @brief Tiles along one screen axis covered by [center - radius, center + radius]
+     *
+     * The interval is in view space, at view depths zNear..zFar (both in
+     * front of the camera). Each end projects furthest out at whichever
+     * depth makes it so: the nearest for an end on the outer side of the
+     * axis, the farthest for one on the inner side.
+     * @return false if the interval is entirely off screen
+     */
+    bool tileRange(float center, float radius, float zNear, float zFar, float tanHalfFov, int tiles,
+                   int& first, int& last) {
+        float low = center - radius;
+        float high = center + radius;
+        float ndcLow = low / ((low < 0.0f ? zNear : zFar) * tanHalfFov);
+        float ndcHigh = high / ((high > 0.0f ? zNear : zFar) * tanHalfFov);
+        if (ndcLow > 1.0f || ndcHigh < -1.0f) {
+            return false;
+        }
+
+        first = static_cast<int>(std::floor((ndcLow * 0.5f + 0.5f) * tiles));
+        last = static_cast<int>(std::floor((ndcHigh * 0.5f + 0.5f) * tiles));
+        first = std::max(0, std::min(first, tiles - 1));
+        last = std::max(0, std::min(last, tiles - 1));
+        return true;
+    }
+}
+
+ClusteredLighting::ClusteredLighting()
+    : m_tableBuffer(0),
+      m_tableTexture(0),
+      m_indexBuffer(0),
+      m_indexTexture(0),
+      m_lightCount(0),
+      m_sliceScale(0.0f),
+      m_sliceBias(0.0f),
+      m_table(kClusterCount * 2, 0) {
+    std::fill(m_sliceDepths, m_sliceDepths + kSlices + 1, 0.0f);
+}
+
+ClusteredLighting::~ClusteredLighting() {
+    release();
+}
+
+bool ClusteredLighting::create() {
+    release();
+
+    GLStateCache& state = GLStateCache::get();
+    glGenBuffers(1, &m_tableBuffer);
+    glGenBuffers(1, &m_indexBuffer);
+    glGenTextures(1, &m_tableTexture);
+    glGenTextures(1, &m_indexTexture);
+
+    // A name only becomes a buffer once bound, and glTexBuffer needs one
+    state.bindBuffer(GL_TEXTURE_BUFFER, m_tableBuffer);
+    state.bindBuffer(GL_TEXTURE_BUFFER, m_indexBuffer);
+
+    state.bindTexture(GL_TEXTURE_BUFFER, m_tableTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32UI, m_tableBuffer);
+    state.bindTexture(GL_TEXTURE_BUFFER, m_indexTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R16UI, m_indexBuffer);
+    state.bindTexture(GL_TEXTURE_BUFFER, 0);
+
+    if (glGetError() != GL_NO_ERROR) {
+        std::cerr << "ERROR: Cannot create light cluster buffers" << std::endl;
+        release();
+        return false;
+    }
+    return true;
+}
+
+int ClusteredLighting::sliceOf(float depth) const {
+    int slice = static_cast<int>(std::floor(std::log(depth) * m_sliceScale + m_sliceBias));
+    return std::max(0, std::min(slice, kSlices - 1));
+}
+
+void ClusteredLighting::build(const std::vector<PointLight>& lights, const Mat4& view,
+                              float fovDegrees, float aspect, float nearPlane, float farPlane) {
+    m_lightCount = std::min(lights.size(), static_cast<size_t>(kMaxPointLights));
+
+    const float tanHalfY = static_cast<float>(std::tan(fovDegrees * M_PI / 360.0));
+    const float tanHalfX = tanHalfY * aspect;
+    m_sliceScale = kSlices / std::log(farPlane / nearPlane);
+    m_sliceBias = -std::log(nearPlane) * m_sliceScale;
+    for (int slice = 0; slice <= kSlices; ++slice) {
+        m_sliceDepths[slice] = nearPlane * std::pow(farPlane / nearPlane, static_cast<float>(slice) / kSlices);
+    }
+
+    m_assignments.clear();
+    for (size_t i = 0; i < m_lightCount; ++i) {
+        const PointLight& light = lights[i];
+        Vector3 center = view.transformPoint(light.position);
+        float depth = -center.z;  // The view looks down -Z
+        float radius = light.radius;
+        if (radius <= 0.0f || depth + radius < nearPlane || depth - radius > farPlane) {
+            continue;
+        }
+
+        int firstSlice = sliceOf(std::max(depth - radius, nearPlane));
+        int lastSlice = sliceOf(std::min(depth + radius, farPlane));
+        for (int slice = firstSlice; slice <= lastSlice; ++slice) {
+            // The part of the sphere inside this slice, and its widest cross-section
+            float zNear = std::max(m_sliceDepths[slice], depth - radius);
+            float zFar = std::min(m_sliceDepths[slice + 1], depth + radius);
+            float offset = depth < zNear ? zNear - depth : (depth > zFar ? depth - zFar : 0.0f);
+            float section = std::sqrt(std::max(radius * radius - offset * offset, 0.0f));
+
+            int firstX, lastX, firstY, lastY;
+            if (!tileRange(center.x, section, zNear, zFar, tanHalfX, kTilesX, firstX, lastX) ||
+                !tileRange(center.y, section, zNear, zFar, tanHalfY, kTilesY, firstY, lastY)) {
+                continue;
+            }
+
+            for (int y = firstY; y <= lastY; ++y) {
+                for (int x = firstX; x <= lastX; ++x) {
+                    Assignment assignment;
+                    assignment.cluster = static_cast<uint32_t>(x + kTilesX * (y + kTilesY * slice));
+                    assignment.light = static_cast<uint16_t>(i);
+                    m_assignments.push_back(assignment);
+                }
+            }
+        }
+    }
+
+    // Counting sort by cluster; lights keep their order within a cluster
+    std::fill(m_table.begin(), m_table.end(), 0u);
+    for (const Assignment& assignment : m_assignments) {
+        ++m_table[assignment.cluster * 2 + 1];
+    }
+    uint32_t offset = 0;
+    for (int cluster = 0; cluster < kClusterCount; ++cluster) {
+        m_table[cluster * 2] = offset;
+        offset += m_table[cluster * 2 + 1];
+    }
+
+    m_lightIndices.resize(m_assignments.size());
+    for (const Assignment& assignment : m_assignments) {
+        uint32_t& next = m_table[assignment.cluster * 2];
+        m_lightIndices[next++] = assignment.light;
+    }
+    // The fill advanced each offset to the end of its run; step back
+    for (int cluster = 0; cluster < kClusterCount; ++cluster) {
+        m_table[cluster * 2] -= m_table[cluster * 2 + 1];
+    }
+}
+
+void ClusteredLighting::upload() {
+    if (m_tableBuffer == 0) return;
+
+    // Orphaned every frame, like the indirect draw buffer
+    GLStateCache& state = GLStateCache::get();
+    const size_t tableBytes = m_table.size() * sizeof(uint32_t);
+    state.bindBuffer(GL_TEXTURE_BUFFER, m_tableBuffer);
+    MAZE_GL_TRACE_UPLOAD(tableBytes);
+    glBufferData(GL_TEXTURE_BUFFER, tableBytes, m_table.data(), GL_STREAM_DRAW);
+
+    // A buffer texture needs storage even when no cluster has a light
+    static const uint16_t kEmpty = 0;
+    const size_t indexBytes = m_lightIndices.size() * sizeof(uint16_t);
+    state.bindBuffer(GL_TEXTURE_BUFFER, m_indexBuffer);
+    MAZE_GL_TRACE_UPLOAD(indexBytes);
+    glBufferData(GL_TEXTURE_BUFFER, indexBytes > 0 ? indexBytes : sizeof(kEmpty),
+        indexBytes > 0 ? static_cast<const void*>(m_lightIndices.data()) : &kEmpty, GL_STREAM_DRAW);
+}
+
+void ClusteredLighting::bind(unsigned int tableUnit, unsigned int indexUnit) const {
+    GLStateCache& state = GLStateCache::get();
+    state.bindTexture(tableUnit, GL_TEXTURE_BUFFER, m_tableTexture);
+    state.bindTexture(indexUnit, GL_TEXTURE_BUFFER, m_indexTexture);
+}
+
+void ClusteredLighting::release() {
+    GLStateCache& state = GLStateCache::get();
+    state.deleteTexture(m_tableTexture);
+    state.deleteTexture(m_indexTexture);
+    state.deleteBuffer(m_tableBuffer);
+    state.deleteBuffer(m_indexBuffer);
+    m_tableTexture = 0;
+    m_indexTexture = 0;
+    m_tableBuffer = 0;
+    m_indexBuffer = 0;
+}
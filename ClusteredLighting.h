@@ -0,0 +1,112 @@
+#ifndef CLUSTEREDLIGHTING_H
+#define CLUSTEREDLIGHTING_H
+
+#include <gl/glew/glew.h>
+#include <cstdint>
+#include <vector>
+#include "SimdMath.h"
+#include "Vector3.h"
+
+/**
+ * @brief A light that fades to nothing at its radius
+ *
+ * Surfaces receive color * N.L * (1 - distance / radius)^2, the falloff
+ * the portal light has always used, so a light never reaches past its
+ * radius and can be binned exactly.
+ */
+struct PointLight {
+    Vector3 position;
+    float radius;
+    Vector3 color;  // Intensity folded in
+};
+
+// Must match MAX_POINT_LIGHTS in fragment.glsl
+const int kMaxPointLights = 256;
+
+/**
+ * @class ClusteredLighting
+ * @brief Bins point lights into view-space clusters for the surface shader
+ *
+ * The view frustum is cut into kTilesX x kTilesY screen tiles and kSlices
+ * depth slices spaced exponentially between the near and far planes, so
+ * clusters stay roughly cubic. build() tests each light's sphere against
+ * every slice it spans and the tiles its cross-section covers there, all
+ * on the CPU, then sorts the (cluster, light) pairs into one light index
+ * list. upload() sends two texture buffers: per cluster the offset and
+ * count of its run in the list (GL_RG32UI), and the list itself
+ * (GL_R16UI). A fragment finds its cluster from gl_FragCoord and its view
+ * depth and loops over only those lights.
+ *
+ * The light positions and colours themselves are not stored here; the
+ * Renderer streams them in the PointLights uniform block, in the order
+ * given to build().
+ */
+class ClusteredLighting {
+public:
+    // Must match CLUSTER_TILES_X/Y and CLUSTER_SLICES in fragment.glsl
+    static const int kTilesX = 16;
+    static const int kTilesY = 9;
+    static const int kSlices = 24;
+    static const int kClusterCount = kTilesX * kTilesY * kSlices;
+
+    ClusteredLighting();
+    ~ClusteredLighting();
+
+    ClusteredLighting(const ClusteredLighting&) = delete;
+    ClusteredLighting& operator=(const ClusteredLighting&) = delete;
+
+    /**
+     * @brief Create the texture buffers
+     * @return false (with a message on stderr) if GL could not make them
+     */
+    bool create();
+
+    /**
+     * @brief Bin up to kMaxPointLights lights for one camera (CPU only)
+     * @param view World-to-view matrix of the frame
+     * @param fovDegrees Vertical field of view of the frame's projection
+     */
+    void build(const std::vector<PointLight>& lights, const Mat4& view,
+               float fovDegrees, float aspect, float nearPlane, float farPlane);
+
+    /**
+     * @brief Send the cluster table and light index list built last
+     */
+    void upload();
+
+    /**
+     * @brief Bind the cluster table and the light index list as buffer textures
+     */
+    void bind(unsigned int tableUnit, unsigned int indexUnit) const;
+
+    // Depth slice of view depth z: floor(log(z) * scale + bias)
+    float getSliceScale() const { return m_sliceScale; }
+    float getSliceBias() const { return m_sliceBias; }
+
+    size_t getLightCount() const { return m_lightCount; }
+    size_t getAssignmentCount() const { return m_lightIndices.size(); }  // Lights summed over clusters
+
+private:
+    struct Assignment {
+        uint32_t cluster;
+        uint16_t light;
+    };
+
+    GLuint m_tableBuffer;
+    GLuint m_tableTexture;
+    GLuint m_indexBuffer;
+    GLuint m_indexTexture;
+
+    size_t m_lightCount;
+    float m_sliceScale;
+    float m_sliceBias;
+    float m_sliceDepths[kSlices + 1];        // View depth where each slice starts; last is far
+    std::vector<uint32_t> m_table;           // Offset, count per cluster
+    std::vector<uint16_t> m_lightIndices;
+    std::vector<Assignment> m_assignments;   // Scratch, reused every build
+
+    int sliceOf(float depth) const;
+    void release();
+};
+
+#endif // CLUSTEREDLIGHTING_H
@@ -41,13 +41,19 @@ Vector3 Collectible::getPosition() const {
 	);
 }
 
+AABB Collectible::getBounds() const {
+	// Sphere mesh radius is 0.4 scaled by the pulse (max 1.0)
+	const float extent = 0.4f * m_pulse;
+	return AABB::fromCenter(getPosition(), Vector3(extent, extent, extent));
+}
+
 CollectibleManager::CollectibleManager()
 	: m_collectedCount(0),
 	m_newCollection(false),
 	m_lastCollectionPos(0, 0, 0) {
 }
 
-void CollectibleManager::initialize(const Maze& maze) {
+void CollectibleManager::initialize(const Maze& maze, unsigned int seed) {
 	m_collectibles.clear();
 	m_collectedCount = 0;
 	m_newCollection = false;
@@ -60,7 +66,7 @@ void CollectibleManager::initialize(const Maze& maze) {
 	Vector3 startPos = maze.getStartPosition();
 	Vector3 endPos = maze.getExitPosition();
 
-	std::srand(static_cast<unsigned int>(std::time(nullptr)));
+	std::srand(seed);
 
 	int placedCount = 0;
 	int maxCollectibles = 10; // Place 10 collectibles
@@ -79,15 +85,16 @@ void CollectibleManager::initialize(const Maze& maze) {
 		Vector3 pos(worldX, 0.0f, worldZ);
 
 		// Don't place near start or end
-		float distToStart = (pos - startPos).length();
-		float distToEnd = (pos - endPos).length();
+		Vec4 candidate(pos);
+		float distToStart = (candidate - Vec4(startPos)).length3();
+		float distToEnd = (candidate - Vec4(endPos)).length3();
 
 		if (distToStart < 3.0f || distToEnd < 3.0f) continue;
 
 		// Don't place too close to existing collectibles
 		bool tooClose = false;
 		for (const auto& existing : m_collectibles) {
-			float dist = (pos - existing.getPosition()).length();
+			float dist = (candidate - Vec4(existing.getPosition())).length3();
 			if (dist < 3.0f) { // Reduced from 4.0f for more placement options
 				tooClose = true;
 				break;
@@ -118,9 +125,7 @@ void CollectibleManager::checkCollisions(const Vector3& playerPos, float playerR
 		Vector3 collectPos = collectible.getPosition();
 
 		// Calculate distance (ignore Y for easier collection)
-		float dx = playerPos.x - collectPos.x;
-		float dz = playerPos.z - collectPos.z;
-		float distance = std::sqrt(dx * dx + dz * dz);
+		float distance = (Vec4(playerPos) - Vec4(collectPos)).flattened().length3();
 
 		// INCREASED collision distance for easier collection
 		float collisionDist = playerRadius + collectible.getRadius() + 0.7f; // Added 0.7f margin
@@ -132,4 +137,4 @@ void CollectibleManager::checkCollisions(const Vector3& playerPos, float playerR
 			m_lastCollectionPos = collectPos;
 		}
 	}
-}
\ No newline at end of file
+}
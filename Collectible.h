@@ -68,6 +68,7 @@
 
 #pragma once
 #include "Vector3.h"
+#include "SimdMath.h"
 #include <vector>
 
 class Maze;
@@ -86,6 +87,9 @@ public:
     float getRotation() const { return m_rotation; }
     float getPulse() const { return m_pulse; }
 
+    // World-space bounds of the rendered orb (includes pulse scale)
+    AABB getBounds() const;
+
     bool isCollected() const { return m_collected; }
     void collect() { m_collected = true; }
 
@@ -103,7 +107,8 @@ class CollectibleManager {
 public:
     CollectibleManager();
 
-    void initialize(const Maze& maze);
+    // The same seed always gives the same placement
+    void initialize(const Maze& maze, unsigned int seed);
     void update(float deltaTime);
     void checkCollisions(const Vector3& playerPos, float playerRadius);
 
@@ -0,0 +1,546 @@
+#include "DdsImage.h"
+#include <SFML/Graphics/Image.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    // Header field values (DDS files are little-endian, as are all our targets)
+    const uint32_t kDdsMagic = 0x20534444;  // "DDS "
+    const uint32_t kHeaderSize = 124;
+    const uint32_t kPixelFormatSize = 32;
+
+    const uint32_t DDSD_CAPS = 0x1, DDSD_HEIGHT = 0x2, DDSD_WIDTH = 0x4;
+    const uint32_t DDSD_PIXELFORMAT = 0x1000, DDSD_MIPMAPCOUNT = 0x20000, DDSD_LINEARSIZE = 0x80000;
+    const uint32_t DDPF_FOURCC = 0x4;
+    const uint32_t DDSCAPS_COMPLEX = 0x8, DDSCAPS_TEXTURE = 0x1000, DDSCAPS_MIPMAP = 0x400000;
+
+    const uint32_t DXGI_FORMAT_BC1_UNORM = 71;
+    const uint32_t DXGI_FORMAT_BC3_UNORM = 77;
+    const uint32_t DXGI_FORMAT_BC7_UNORM = 98;
+    const uint32_t D3D10_RESOURCE_DIMENSION_TEXTURE2D = 3;
+
+    // Larger than any GL_MAX_TEXTURE_SIZE we run on. Files load on worker
+    // threads with no context to ask, so this is a fixed sanity bound.
+    const unsigned int kMaxDimension = 16384;
+
+    // Word offsets inside the 124-byte header
+    enum HeaderWord {
+        H_SIZE = 0, H_FLAGS = 1, H_HEIGHT = 2, H_WIDTH = 3, H_LINEAR_SIZE = 4,
+        H_MIP_COUNT = 6, H_WRITER = 10, H_PF_SIZE = 18, H_PF_FLAGS = 19, H_PF_FOURCC = 20, H_CAPS = 26,
+        H_WORD_COUNT = 31
+    };
+
+    uint32_t fourCC(char a, char b, char c, char d) {
+        return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) |
+            (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+    }
+
+    // Set in a reserved header word by saveToFile: rows are already bottom-up
+    const uint32_t kWriterTag = fourCC('M', 'A', 'Z', 'E');
+
+    // ---- BC1 / BC3 encoding (principal-axis range fit) ----
+
+    uint16_t packRgb565(const float c[3]) {
+        int r = static_cast<int>(std::min(std::max(c[0], 0.0f), 255.0f) * 31.0f / 255.0f + 0.5f);
+        int g = static_cast<int>(std::min(std::max(c[1], 0.0f), 255.0f) * 63.0f / 255.0f + 0.5f);
+        int b = static_cast<int>(std::min(std::max(c[2], 0.0f), 255.0f) * 31.0f / 255.0f + 0.5f);
+        return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+    void unpackRgb565(uint16_t c, int out[3]) {
+        int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+        out[0] = (r << 3) | (r >> 2);
+        out[1] = (g << 2) | (g >> 4);
+        out[2] = (b << 3) | (b >> 2);
+    }
+
+    // 16 RGBA pixels in, 8 bytes out. Always uses the 4-colour mode.
+    void encodeColorBlock(const uint8_t* pixels, uint8_t* out) {
+        float mean[3] = { 0.0f, 0.0f, 0.0f };
+        for (int i = 0; i < 16; ++i) {
+            for (int c = 0; c < 3; ++c) mean[c] += pixels[i * 4 + c];
+        }
+        for (int c = 0; c < 3; ++c) mean[c] /= 16.0f;
+
+        // Covariance, then a few power iterations for the dominant axis
+        float cov[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+        for (int i = 0; i < 16; ++i) {
+            float r = pixels[i * 4 + 0] - mean[0];
+            float g = pixels[i * 4 + 1] - mean[1];
+            float b = pixels[i * 4 + 2] - mean[2];
+            cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+            cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+        }
+
+        float axis[3] = { 1.0f, 1.0f, 1.0f };
+        for (int iter = 0; iter < 4; ++iter) {
+            float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+            float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+            float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+            float len = std::max(std::max(std::fabs(x), std::fabs(y)), std::fabs(z));
+            if (len < 1e-6f) break;  // Flat block: any axis will do
+            axis[0] = x / len; axis[1] = y / len; axis[2] = z / len;
+        }
+
+        // Extremes along the axis
+        float minDot = 1e30f, maxDot = -1e30f;
+        for (int i = 0; i < 16; ++i) {
+            float d = (pixels[i * 4 + 0] - mean[0]) * axis[0] +
+                (pixels[i * 4 + 1] - mean[1]) * axis[1] +
+                (pixels[i * 4 + 2] - mean[2]) * axis[2];
+            minDot = std::min(minDot, d);
+            maxDot = std::max(maxDot, d);
+        }
+
+        float axisLenSq = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+        float maxColor[3], minColor[3];
+        for (int c = 0; c < 3; ++c) {
+            float scale = axisLenSq > 0.0f ? axis[c] / axisLenSq : 0.0f;
+            maxColor[c] = mean[c] + maxDot * scale;
+            minColor[c] = mean[c] + minDot * scale;
+        }
+
+        // Pull the endpoints in by 1/16 of the range: the extremes are then
+        // represented by the interpolated entries with less error overall
+        for (int c = 0; c < 3; ++c) {
+            float inset = (maxColor[c] - minColor[c]) / 16.0f;
+            maxColor[c] -= inset;
+            minColor[c] += inset;
+        }
+
+        uint16_t c0 = packRgb565(maxColor);
+        uint16_t c1 = packRgb565(minColor);
+        if (c0 < c1) std::swap(c0, c1);
+
+        out[0] = static_cast<uint8_t>(c0 & 0xFF); out[1] = static_cast<uint8_t>(c0 >> 8);
+        out[2] = static_cast<uint8_t>(c1 & 0xFF); out[3] = static_cast<uint8_t>(c1 >> 8);
+
+        uint32_t indices = 0;
+        if (c0 != c1) {
+            int p[4][3];
+            unpackRgb565(c0, p[0]);
+            unpackRgb565(c1, p[1]);
+            for (int c = 0; c < 3; ++c) {
+                p[2][c] = (2 * p[0][c] + p[1][c]) / 3;
+                p[3][c] = (p[0][c] + 2 * p[1][c]) / 3;
+            }
+
+            for (int i = 0; i < 16; ++i) {
+                int best = 0, bestDist = 1 << 30;
+                for (int k = 0; k < 4; ++k) {
+                    int dr = pixels[i * 4 + 0] - p[k][0];
+                    int dg = pixels[i * 4 + 1] - p[k][1];
+                    int db = pixels[i * 4 + 2] - p[k][2];
+                    int dist = dr * dr + dg * dg + db * db;
+                    if (dist < bestDist) { bestDist = dist; best = k; }
+                }
+                indices |= static_cast<uint32_t>(best) << (i * 2);
+            }
+        }
+        // c0 == c1 means a flat block; all-zero indices select c0
+
+        for (int i = 0; i < 4; ++i) out[4 + i] = static_cast<uint8_t>(indices >> (i * 8));
+    }
+
+    // 16 RGBA pixels in, 8 bytes of BC3 alpha out (8-value mode)
+    void encodeAlphaBlock(const uint8_t* pixels, uint8_t* out) {
+        int a0 = 0, a1 = 255;
+        for (int i = 0; i < 16; ++i) {
+            a0 = std::max(a0, static_cast<int>(pixels[i * 4 + 3]));
+            a1 = std::min(a1, static_cast<int>(pixels[i * 4 + 3]));
+        }
+
+        out[0] = static_cast<uint8_t>(a0);
+        out[1] = static_cast<uint8_t>(a1);
+
+        uint64_t indices = 0;
+        if (a0 != a1) {
+            int palette[8] = { a0, a1 };
+            for (int k = 1; k < 7; ++k) {
+                palette[k + 1] = ((7 - k) * a0 + k * a1) / 7;
+            }
+
+            for (int i = 0; i < 16; ++i) {
+                int a = pixels[i * 4 + 3];
+                int best = 0, bestDist = 256;
+                for (int k = 0; k < 8; ++k) {
+                    int dist = std::abs(a - palette[k]);
+                    if (dist < bestDist) { bestDist = dist; best = k; }
+                }
+                indices |= static_cast<uint64_t>(best) << (i * 3);
+            }
+        }
+
+        for (int i = 0; i < 6; ++i) out[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+    }
+
+    // Copy a 4x4 block, clamping at the image edge for non-multiple-of-4 sizes
+    void fetchBlock(const uint8_t* rgba, unsigned int width, unsigned int height,
+                    unsigned int bx, unsigned int by, uint8_t* block) {
+        for (unsigned int y = 0; y < 4; ++y) {
+            unsigned int sy = std::min(by * 4 + y, height - 1);
+            for (unsigned int x = 0; x < 4; ++x) {
+                unsigned int sx = std::min(bx * 4 + x, width - 1);
+                std::memcpy(block + (y * 4 + x) * 4, rgba + (sy * width + sx) * 4, 4);
+            }
+        }
+    }
+
+    // 2x2 box filter; the last row/column is reused for odd sizes
+    std::vector<uint8_t> downsample(const std::vector<uint8_t>& src, unsigned int width, unsigned int height,
+                                    unsigned int dstWidth, unsigned int dstHeight) {
+        std::vector<uint8_t> dst(static_cast<size_t>(dstWidth) * dstHeight * 4);
+        for (unsigned int y = 0; y < dstHeight; ++y) {
+            unsigned int y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+            for (unsigned int x = 0; x < dstWidth; ++x) {
+                unsigned int x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+                for (int c = 0; c < 4; ++c) {
+                    int sum = src[(y0 * width + x0) * 4 + c] + src[(y0 * width + x1) * 4 + c] +
+                        src[(y1 * width + x0) * 4 + c] + src[(y1 * width + x1) * 4 + c];
+                    dst[(y * dstWidth + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+        return dst;
+    }
+
+    // ---- Vertical flip of BC1 / BC3 data, block by block ----
+
+    // Reverse the first rows pixel rows of a colour block: one index byte per row
+    void flipColorBlock(uint8_t* block, unsigned int rows) {
+        std::reverse(block + 4, block + 4 + rows);
+    }
+
+    // Same for a BC3 alpha block: 48 bits of 3-bit indices after the endpoints, 12 per row
+    void flipAlphaBlock(uint8_t* block, unsigned int rows) {
+        uint64_t bits = 0;
+        for (int i = 0; i < 6; ++i) bits |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+
+        uint64_t flipped = bits;
+        for (unsigned int row = 0; row < rows; ++row) {
+            unsigned int target = rows - 1 - row;
+            flipped &= ~(0xFFFull << (12 * target));
+            flipped |= ((bits >> (12 * row)) & 0xFFFull) << (12 * target);
+        }
+        for (int i = 0; i < 6; ++i) block[2 + i] = static_cast<uint8_t>(flipped >> (8 * i));
+    }
+
+    // Block rows can only be reversed when no block straddles the flip
+    bool canFlipLevel(unsigned int height) {
+        return height <= 4 || height % 4 == 0;
+    }
+
+    // Reverse the block rows, then the pixel rows inside each block (see canFlipLevel)
+    void flipLevel(std::vector<uint8_t>& data, DdsFormat format, unsigned int width, unsigned int height) {
+        const size_t blockSize = format == DDS_FORMAT_BC1 ? 8 : 16;
+        const size_t rowBytes = static_cast<size_t>((width + 3) / 4) * blockSize;
+        const unsigned int blockRows = (height + 3) / 4;
+        for (unsigned int row = 0; row < blockRows / 2; ++row) {
+            std::swap_ranges(data.begin() + row * rowBytes, data.begin() + (row + 1) * rowBytes,
+                data.begin() + (blockRows - 1 - row) * rowBytes);
+        }
+
+        const unsigned int rows = std::min(height, 4u);
+        for (size_t offset = 0; offset < data.size(); offset += blockSize) {
+            if (format == DDS_FORMAT_BC3) {
+                flipAlphaBlock(&data[offset], rows);
+                flipColorBlock(&data[offset + 8], rows);
+            }
+            else {
+                flipColorBlock(&data[offset], rows);
+            }
+        }
+    }
+}
+
+DdsImage::DdsImage() : m_format(DDS_FORMAT_BC1) {}
+
+size_t DdsImage::blockBytes(DdsFormat format) {
+    return format == DDS_FORMAT_BC1 ? 8 : 16;
+}
+
+size_t DdsImage::levelSize(DdsFormat format, unsigned int width, unsigned int height) {
+    return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * blockBytes(format);
+}
+
+bool DdsImage::loadFromFile(const std::string& filepath) {
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        return false;  // Callers fall back to the source image
+    }
+
+    uint32_t magic = 0;
+    uint32_t header[H_WORD_COUNT];
+    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!file || magic != kDdsMagic || header[H_SIZE] != kHeaderSize || header[H_PF_SIZE] != kPixelFormatSize) {
+        std::cerr << "Invalid DDS file: " << filepath << std::endl;
+        return false;
+    }
+
+    if (!(header[H_PF_FLAGS] & DDPF_FOURCC)) {
+        std::cerr << "Unsupported DDS format (uncompressed): " << filepath << std::endl;
+        return false;
+    }
+
+    uint32_t code = header[H_PF_FOURCC];
+    if (code == fourCC('D', 'X', 'T', '1')) {
+        m_format = DDS_FORMAT_BC1;
+    }
+    else if (code == fourCC('D', 'X', 'T', '5')) {
+        m_format = DDS_FORMAT_BC3;
+    }
+    else if (code == fourCC('D', 'X', '1', '0')) {
+        uint32_t dx10[5];
+        file.read(reinterpret_cast<char*>(dx10), sizeof(dx10));
+        if (!file) {
+            std::cerr << "Truncated DDS file: " << filepath << std::endl;
+            return false;
+        }
+        if (dx10[0] == DXGI_FORMAT_BC1_UNORM) m_format = DDS_FORMAT_BC1;
+        else if (dx10[0] == DXGI_FORMAT_BC3_UNORM) m_format = DDS_FORMAT_BC3;
+        else if (dx10[0] == DXGI_FORMAT_BC7_UNORM) m_format = DDS_FORMAT_BC7;
+        else {
+            std::cerr << "Unsupported DXGI format " << dx10[0] << " in " << filepath << std::endl;
+            return false;
+        }
+    }
+    else {
+        std::cerr << "Unsupported DDS compression in " << filepath << std::endl;
+        return false;
+    }
+
+    unsigned int width = header[H_WIDTH];
+    unsigned int height = header[H_HEIGHT];
+    unsigned int mipCount = (header[H_FLAGS] & DDSD_MIPMAPCOUNT) ? std::max(header[H_MIP_COUNT], 1u) : 1u;
+    if (width == 0 || height == 0 || width > kMaxDimension || height > kMaxDimension) {
+        std::cerr << "Invalid DDS dimensions in " << filepath << std::endl;
+        return false;
+    }
+
+    // A corrupt header must not make us allocate more than the file holds
+    std::streamoff dataStart = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::streamoff remaining = file.tellg() - dataStart;
+    file.seekg(dataStart);
+
+    m_levels.clear();
+    for (unsigned int i = 0; i < mipCount; ++i) {
+        size_t size = levelSize(m_format, width, height);
+        if (static_cast<std::streamoff>(size) > remaining) {
+            std::cerr << "Truncated DDS file: " << filepath << std::endl;
+            m_levels.clear();
+            return false;
+        }
+        remaining -= static_cast<std::streamoff>(size);
+
+        Level level;
+        level.width = width;
+        level.height = height;
+        level.data.resize(size);
+        file.read(reinterpret_cast<char*>(level.data.data()), level.data.size());
+        if (!file) {
+            std::cerr << "Truncated DDS file: " << filepath << std::endl;
+            m_levels.clear();
+            return false;
+        }
+        m_levels.push_back(std::move(level));
+
+        if (width == 1 && height == 1) break;
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+    }
+
+    // Other tools store the top row first; ours are already in GL order.
+    // BC7 is taken as authored bottom-up (see the class comment).
+    // The whole chain or none of it, so every LOD has the same orientation.
+    if (header[H_WRITER] != kWriterTag && m_format != DDS_FORMAT_BC7) {
+        bool flippable = true;
+        for (const Level& level : m_levels) {
+            flippable = flippable && canFlipLevel(level.height);
+        }
+
+        if (flippable) {
+            for (Level& level : m_levels) {
+                flipLevel(level.data, m_format, level.width, level.height);
+            }
+        }
+        else {
+            std::cerr << "WARNING: Cannot flip " << getFormatName() << " levels of " << filepath
+                << " (height not a multiple of 4), it will be upside down" << std::endl;
+        }
+    }
+
+    return true;
+}
+
+bool DdsImage::saveToFile(const std::string& filepath) const {
+    if (m_levels.empty()) {
+        return false;
+    }
+
+    uint32_t header[H_WORD_COUNT];
+    std::memset(header, 0, sizeof(header));
+    header[H_SIZE] = kHeaderSize;
+    header[H_FLAGS] = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+    header[H_HEIGHT] = m_levels[0].height;
+    header[H_WIDTH] = m_levels[0].width;
+    header[H_LINEAR_SIZE] = static_cast<uint32_t>(m_levels[0].data.size());
+    header[H_MIP_COUNT] = static_cast<uint32_t>(m_levels.size());
+    header[H_WRITER] = kWriterTag;
+    header[H_PF_SIZE] = kPixelFormatSize;
+    header[H_PF_FLAGS] = DDPF_FOURCC;
+    header[H_CAPS] = DDSCAPS_TEXTURE | (m_levels.size() > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0);
+
+    switch (m_format) {
+    case DDS_FORMAT_BC1: header[H_PF_FOURCC] = fourCC('D', 'X', 'T', '1'); break;
+    case DDS_FORMAT_BC3: header[H_PF_FOURCC] = fourCC('D', 'X', 'T', '5'); break;
+    case DDS_FORMAT_BC7: header[H_PF_FOURCC] = fourCC('D', 'X', '1', '0'); break;
+    }
+
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to write DDS file: " << filepath << std::endl;
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&kDdsMagic), sizeof(kDdsMagic));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    if (m_format == DDS_FORMAT_BC7) {
+        uint32_t dx10[5] = { DXGI_FORMAT_BC7_UNORM, D3D10_RESOURCE_DIMENSION_TEXTURE2D, 0, 1, 0 };
+        file.write(reinterpret_cast<const char*>(dx10), sizeof(dx10));
+    }
+    for (const auto& level : m_levels) {
+        file.write(reinterpret_cast<const char*>(level.data.data()), level.data.size());
+    }
+
+    return static_cast<bool>(file);
+}
+
+bool DdsImage::compress(const uint8_t* rgba, unsigned int width, unsigned int height, DdsFormat format) {
+    if (format == DDS_FORMAT_BC7) {
+        std::cerr << "BC7 encoding is not supported, use BC1 or BC3" << std::endl;
+        return false;
+    }
+    if (width == 0 || height == 0) {
+        return false;
+    }
+
+    m_format = format;
+    m_levels.clear();
+
+    std::vector<uint8_t> pixels(rgba, rgba + static_cast<size_t>(width) * height * 4);
+    uint8_t block[64];
+
+    while (true) {
+        Level level;
+        level.width = width;
+        level.height = height;
+        level.data.resize(levelSize(format, width, height));
+
+        uint8_t* out = level.data.data();
+        unsigned int blocksX = (width + 3) / 4;
+        unsigned int blocksY = (height + 3) / 4;
+        for (unsigned int by = 0; by < blocksY; ++by) {
+            for (unsigned int bx = 0; bx < blocksX; ++bx) {
+                fetchBlock(pixels.data(), width, height, bx, by, block);
+                if (format == DDS_FORMAT_BC3) {
+                    encodeAlphaBlock(block, out);
+                    out += 8;
+                }
+                encodeColorBlock(block, out);
+                out += 8;
+            }
+        }
+        m_levels.push_back(std::move(level));
+
+        if (width == 1 && height == 1) break;
+
+        unsigned int nextWidth = std::max(width / 2, 1u);
+        unsigned int nextHeight = std::max(height / 2, 1u);
+        pixels = downsample(pixels, width, height, nextWidth, nextHeight);
+        width = nextWidth;
+        height = nextHeight;
+    }
+
+    return true;
+}
+
+bool DdsImage::convertImageFile(const std::string& imagePath, const std::string& ddsPath) {
+    auto start = std::chrono::steady_clock::now();
+
+    sf::Image image;
+    if (!image.loadFromFile(imagePath)) {
+        std::cerr << "Failed to load image: " << imagePath << std::endl;
+        return false;
+    }
+
+    // Store in OpenGL row order so the runtime never flips compressed blocks
+    image.flipVertically();
+
+    sf::Vector2u size = image.getSize();
+    const sf::Uint8* pixels = image.getPixelsPtr();
+
+    bool hasAlpha = false;
+    for (size_t i = 0; i < static_cast<size_t>(size.x) * size.y; ++i) {
+        if (pixels[i * 4 + 3] != 255) {
+            hasAlpha = true;
+            break;
+        }
+    }
+
+    DdsImage dds;
+    if (!dds.compress(pixels, size.x, size.y, hasAlpha ? DDS_FORMAT_BC3 : DDS_FORMAT_BC1)) {
+        return false;
+    }
+    if (!dds.saveToFile(ddsPath)) {
+        return false;
+    }
+
+    // What glTexImage2D + glGenerateMipmap would have allocated (chain ~ 4/3)
+    size_t rgbaBytes = static_cast<size_t>(size.x) * size.y * 4 * 4 / 3;
+    float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << imagePath << " -> " << ddsPath << " (" << size.x << "x" << size.y << ", "
+        << dds.getFormatName() << ", " << dds.getLevels().size() << " mips, "
+        << dds.getDataSize() / 1024 << " KB vs " << rgbaBytes / 1024 << " KB RGBA, "
+        << static_cast<int>(ms) << " ms)" << std::endl;
+    return true;
+}
+
+bool DdsImage::isFormatSupported(DdsFormat format) {
+    if (format == DDS_FORMAT_BC7) {
+        return GLEW_VERSION_4_2 || GLEW_ARB_texture_compression_bptc;
+    }
+    return GLEW_EXT_texture_compression_s3tc != 0;
+}
+
+GLenum DdsImage::getGLFormat() const {
+    switch (m_format) {
+    case DDS_FORMAT_BC1: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+    case DDS_FORMAT_BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case DDS_FORMAT_BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM_ARB;
+    }
+    return 0;
+}
+
+const char* DdsImage::getFormatName() const {
+    switch (m_format) {
+    case DDS_FORMAT_BC1: return "BC1";
+    case DDS_FORMAT_BC3: return "BC3";
+    case DDS_FORMAT_BC7: return "BC7";
+    }
+    return "?";
+}
+
+size_t DdsImage::getDataSize() const {
+    size_t total = 0;
+    for (const auto& level : m_levels) {
+        total += level.data.size();
+    }
+    return total;
+}
@@ -0,0 +1,94 @@
+#ifndef DDSIMAGE_H
+#define DDSIMAGE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <gl/glew/glew.h>
+
+/**
+ * @brief Block-compressed formats understood by DdsImage
+ */
+enum DdsFormat {
+    DDS_FORMAT_BC1,   // RGB, 1-bit alpha, 8 bytes per 4x4 block
+    DDS_FORMAT_BC3,   // RGBA, 16 bytes per block
+    DDS_FORMAT_BC7    // RGBA high quality, 16 bytes per block (load only)
+};
+
+/**
+ * @class DdsImage
+ * @brief A block-compressed image with its full mip chain, stored as .dds
+ *
+ * Files written by this class keep OpenGL row order (first row = bottom of
+ * the image) and are tagged as such, so levels upload as-is. Files from
+ * other tools are top-down by the DDS convention: BC1/BC3 blocks are
+ * flipped while loading. The encoder produces BC1/BC3; BC7 files made by
+ * external tools load but cannot be written, and cannot be flipped
+ * without re-encoding, so they must be authored bottom-up (e.g. texconv
+ * -vflip).
+ */
+class DdsImage {
+public:
+    struct Level {
+        unsigned int width;
+        unsigned int height;
+        std::vector<uint8_t> data;
+    };
+
+    DdsImage();
+
+    /**
+     * @brief Read a .dds file (DXT1, DXT5 or DX10 BC1/BC3/BC7)
+     * @return false if the file is missing or not in a supported format
+     */
+    bool loadFromFile(const std::string& filepath);
+
+    /**
+     * @brief Write the image as .dds (DX10 header only for BC7)
+     */
+    bool saveToFile(const std::string& filepath) const;
+
+    /**
+     * @brief Build the mip chain with a box filter and compress every level
+     * @param rgba Top mip level, tightly packed RGBA8, OpenGL row order
+     * @param format DDS_FORMAT_BC1 or DDS_FORMAT_BC3
+     */
+    bool compress(const uint8_t* rgba, unsigned int width, unsigned int height, DdsFormat format);
+
+    /**
+     * @brief Offline conversion: decode any image sf::Image reads, write .dds
+     *
+     * Opaque images become BC1, images with alpha BC3.
+     */
+    static bool convertImageFile(const std::string& imagePath, const std::string& ddsPath);
+
+    /**
+     * @brief True if the current GL context can sample the format
+     */
+    static bool isFormatSupported(DdsFormat format);
+
+    /**
+     * @brief Matching glCompressedTexImage2D internal format
+     */
+    GLenum getGLFormat() const;
+
+    DdsFormat getFormat() const { return m_format; }
+    const char* getFormatName() const;
+    unsigned int getWidth() const { return m_levels.empty() ? 0 : m_levels[0].width; }
+    unsigned int getHeight() const { return m_levels.empty() ? 0 : m_levels[0].height; }
+    const std::vector<Level>& getLevels() const { return m_levels; }
+
+    /**
+     * @brief Total compressed size of all levels in bytes
+     */
+    size_t getDataSize() const;
+
+private:
+    DdsFormat m_format;
+    std::vector<Level> m_levels;
+
+    static size_t blockBytes(DdsFormat format);
+    static size_t levelSize(DdsFormat format, unsigned int width, unsigned int height);
+};
+
+#endif // DDSIMAGE_H
@@ -0,0 +1,95 @@
+#include "DynamicResolution.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Fraction of the way to the ideal scale taken per measurement
+    const float kSmoothing = 0.2f;
+
+    // Ignore measurements within this fraction of the target
+    const float kDeadBand = 0.08f;
+}
+
+DynamicResolution::DynamicResolution(float targetMilliseconds, float minScale)
+    : m_queryIndex(0),
+      m_queryActive(false),
+      m_targetMilliseconds(targetMilliseconds),
+      m_minScale(minScale),
+      m_scale(1.0f),
+      m_lastGpuMilliseconds(0.0f),
+      m_enabled(true) {
+    glGenQueries(kQueryCount, m_queries);
+    for (int i = 0; i < kQueryCount; ++i) {
+        m_queryIssued[i] = false;
+    }
+}
+
+DynamicResolution::~DynamicResolution() {
+    glDeleteQueries(kQueryCount, m_queries);
+}
+
+void DynamicResolution::beginFrame() {
+    if (!m_enabled) {
+        return;
+    }
+
+    collectResults();
+
+    // Every slot still in flight: the GPU is far behind, skip measuring this frame
+    if (m_queryIssued[m_queryIndex]) {
+        return;
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, m_queries[m_queryIndex]);
+    m_queryActive = true;
+}
+
+void DynamicResolution::endFrame() {
+    if (!m_queryActive) {
+        return;
+    }
+
+    glEndQuery(GL_TIME_ELAPSED);
+    m_queryActive = false;
+    m_queryIssued[m_queryIndex] = true;
+    m_queryIndex = (m_queryIndex + 1) % kQueryCount;
+}
+
+void DynamicResolution::collectResults() {
+    // Slots are issued in ring order, so the oldest is the one about to be reused
+    for (int i = 0; i < kQueryCount; ++i) {
+        int slot = (m_queryIndex + i) % kQueryCount;
+        if (!m_queryIssued[slot]) {
+            continue;
+        }
+
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(m_queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;  // Newer queries cannot be done either
+        }
+
+        GLuint64 elapsedNs = 0;
+        glGetQueryObjectui64v(m_queries[slot], GL_QUERY_RESULT, &elapsedNs);
+        m_queryIssued[slot] = false;
+
+        applyMeasurement(static_cast<float>(elapsedNs) / 1.0e6f);
+    }
+}
+
+void DynamicResolution::applyMeasurement(float gpuMilliseconds) {
+    m_lastGpuMilliseconds = gpuMilliseconds;
+    if (gpuMilliseconds <= 0.0f) {
+        return;
+    }
+
+    float ratio = m_targetMilliseconds / gpuMilliseconds;
+    if (std::fabs(1.0f - ratio) < kDeadBand) {
+        return;
+    }
+
+    // Cost is proportional to pixel count, which goes with scale squared
+    float ideal = m_scale * std::sqrt(ratio);
+    ideal = std::max(m_minScale, std::min(ideal, 1.0f));
+    m_scale += (ideal - m_scale) * kSmoothing;
+}
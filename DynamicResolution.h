@@ -0,0 +1,63 @@
+#ifndef DYNAMICRESOLUTION_H
+#define DYNAMICRESOLUTION_H
+
+#include <gl/glew/glew.h>
+
+/**
+ * @class DynamicResolution
+ * @brief Picks a render scale each frame from measured GPU time
+ *
+ * beginFrame()/endFrame() bracket the scene's GPU work with a
+ * GL_TIME_ELAPSED query. Results are read back a few frames later from a
+ * small ring of queries, so the CPU never waits for the GPU. Fragment cost
+ * grows with pixel count, i.e. with scale squared, so each result moves
+ * the scale towards scale * sqrt(target / measured), smoothed and with a
+ * dead band so it does not hunt around the target.
+ */
+class DynamicResolution {
+public:
+    /**
+     * @param targetMilliseconds GPU budget for the scene
+     * @param minScale Lowest scale per axis (1.0 = native)
+     */
+    explicit DynamicResolution(float targetMilliseconds = 14.0f, float minScale = 0.5f);
+    ~DynamicResolution();
+
+    DynamicResolution(const DynamicResolution&) = delete;
+    DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+    void beginFrame();
+    void endFrame();
+
+    float getScale() const { return m_enabled ? m_scale : 1.0f; }
+    float getLastGpuMilliseconds() const { return m_lastGpuMilliseconds; }
+
+    void setTargetMilliseconds(float milliseconds) { m_targetMilliseconds = milliseconds; }
+    float getTargetMilliseconds() const { return m_targetMilliseconds; }
+
+    // Disabled: scale stays 1.0 and no queries are issued
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+    bool isEnabled() const { return m_enabled; }
+
+private:
+    static const int kQueryCount = 4;
+
+    GLuint m_queries[kQueryCount];
+    bool m_queryIssued[kQueryCount];
+    int m_queryIndex;
+    bool m_queryActive;
+
+    float m_targetMilliseconds;
+    float m_minScale;
+    float m_scale;
+    float m_lastGpuMilliseconds;
+    bool m_enabled;
+
+    /**
+     * @brief Read every finished query, oldest first, and update the scale
+     */
+    void collectResults();
+    void applyMeasurement(float gpuMilliseconds);
+};
+
+#endif // DYNAMICRESOLUTION_H
@@ -0,0 +1,43 @@
+#ifndef FRAMESNAPSHOT_H
+#define FRAMESNAPSHOT_H
+
+#include "Camera.h"
+#include "Collectible.h"
+#include "SimdMath.h"
+#include "Vector3.h"
+#include <SFML/Graphics/Color.hpp>
+#include <vector>
+
+/**
+ * @struct FrameSnapshot
+ * @brief Everything Game::render reads from the simulation for one frame
+ *
+ * Filled by Game::buildSnapshot after update() and never changed once
+ * published, so rendering can run on another thread while the simulation
+ * moves on (see TripleBuffer). Only plain values and copies live here,
+ * no pointers back into simulation state.
+ */
+struct FrameSnapshot {
+    unsigned long long frameNumber = 0;
+    float time = 0.0f;               // Game::m_totalTime, drives shader animation
+
+    Camera camera;
+    bool flashlightOn = false;
+    float flashlightIntensity = 0.0f;
+
+    // Uncollected orbs only, with their bounds in the same order for culling
+    std::vector<Collectible> orbs;
+    std::vector<AABB> orbBounds;
+
+    // HUD
+    float levelTime = 0.0f;          // Timer shown top left
+    Vector3 playerPosition;          // Minimap dot
+    int collectedCount = 0;
+    int totalCount = 0;
+    float batteryPercent = 1.0f;
+    bool lowBattery = false;
+    sf::Color flashColor = sf::Color::Transparent;  // Collection flash, alpha applied
+    bool won = false;
+};
+
+#endif // FRAMESNAPSHOT_H
@@ -0,0 +1,261 @@
+#include "GLStateCache.h"
+#include "GLTrace.h"
+#include <iostream>
+
+GLStateCache& GLStateCache::get() {
+    static GLStateCache cache;
+    return cache;
+}
+
+GLStateCache::GLStateCache()
+    : m_issued(0),
+    m_skipped(0),
+    m_lastIssued(0),
+    m_lastSkipped(0),
+    m_totalIssued(0),
+    m_totalSkipped(0),
+    m_frameCount(0) {
+    invalidate();
+}
+
+void GLStateCache::countIssued() {
+    ++m_issued;
+    MAZE_GL_TRACE_COUNT(GLTRACE_STATE_CALLS, 1);
+}
+
+void GLStateCache::countSkipped() {
+    ++m_skipped;
+    MAZE_GL_TRACE_COUNT(GLTRACE_REDUNDANT_STATE, 1);
+}
+
+bool GLStateCache::update(GLuint& current, GLuint value) {
+    if (current == value) {
+        countSkipped();
+        return false;
+    }
+    current = value;
+    countIssued();
+    return true;
+}
+
+int GLStateCache::bufferSlot(GLenum target) {
+    switch (target) {
+    case GL_ARRAY_BUFFER: return BUFFER_ARRAY;
+    case GL_UNIFORM_BUFFER: return BUFFER_UNIFORM;
+    case GL_DRAW_INDIRECT_BUFFER: return BUFFER_DRAW_INDIRECT;
+    case GL_PIXEL_UNPACK_BUFFER: return BUFFER_PIXEL_UNPACK;
+    case GL_COPY_READ_BUFFER: return BUFFER_COPY_READ;
+    case GL_COPY_WRITE_BUFFER: return BUFFER_COPY_WRITE;
+    default: return -1;
+    }
+}
+
+int GLStateCache::capabilitySlot(GLenum capability) {
+    switch (capability) {
+    case GL_BLEND: return CAPABILITY_BLEND;
+    case GL_DEPTH_TEST: return CAPABILITY_DEPTH_TEST;
+    case GL_CULL_FACE: return CAPABILITY_CULL_FACE;
+    default: return -1;
+    }
+}
+
+GLuint* GLStateCache::findTextureSlot(unsigned int unit, GLenum target) {
+    if (unit >= static_cast<unsigned int>(kMaxTextureUnits)) {
+        return nullptr;
+    }
+    switch (target) {
+    case GL_TEXTURE_2D: return &m_units[unit].texture2D;
+    case GL_TEXTURE_2D_ARRAY: return &m_units[unit].texture2DArray;
+    default: return nullptr;
+    }
+}
+
+void GLStateCache::useProgram(GLuint program) {
+    if (update(m_program, program)) {
+        glUseProgram(program);
+    }
+}
+
+void GLStateCache::bindVertexArray(GLuint vao) {
+    if (update(m_vertexArray, vao)) {
+        glBindVertexArray(vao);
+    }
+}
+
+void GLStateCache::bindBuffer(GLenum target, GLuint buffer) {
+    int slot = bufferSlot(target);
+    if (slot < 0) {
+        countIssued();
+        glBindBuffer(target, buffer);
+    }
+    else if (update(m_buffers[slot], buffer)) {
+        glBindBuffer(target, buffer);
+    }
+}
+
+void GLStateCache::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+    // The offset changes every frame, so the indexed binding itself is not worth tracking
+    countIssued();
+    glBindBufferRange(target, index, buffer, offset, size);
+
+    int slot = bufferSlot(target);
+    if (slot >= 0) {
+        m_buffers[slot] = buffer;
+    }
+}
+
+void GLStateCache::activeTexture(unsigned int unit) {
+    if (update(m_activeUnit, unit)) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+}
+
+void GLStateCache::bindTexture(unsigned int unit, GLenum target, GLuint texture) {
+    GLuint* slot = findTextureSlot(unit, target);
+    if (slot && *slot == texture) {
+        countSkipped();
+        return;
+    }
+
+    activeTexture(unit);
+    countIssued();
+    glBindTexture(target, texture);
+    if (slot) {
+        *slot = texture;
+    }
+}
+
+void GLStateCache::bindTexture(GLenum target, GLuint texture) {
+    // Uploads do not care which unit they use; pick one if nothing is known yet
+    bindTexture(m_activeUnit == kUnknown ? 0u : m_activeUnit, target, texture);
+}
+
+void GLStateCache::setEnabled(GLenum capability, bool enabled) {
+    int slot = capabilitySlot(capability);
+    if (slot >= 0 && !update(m_capabilities[slot], enabled ? GL_TRUE : GL_FALSE)) {
+        return;
+    }
+    if (slot < 0) {
+        countIssued();
+    }
+
+    if (enabled) {
+        glEnable(capability);
+    }
+    else {
+        glDisable(capability);
+    }
+}
+
+void GLStateCache::blendFunc(GLenum source, GLenum destination) {
+    if (m_blendSource == source && m_blendDestination == destination) {
+        countSkipped();
+        return;
+    }
+    m_blendSource = source;
+    m_blendDestination = destination;
+    countIssued();
+    glBlendFunc(source, destination);
+}
+
+void GLStateCache::depthFunc(GLenum function) {
+    if (update(m_depthFunc, function)) {
+        glDepthFunc(function);
+    }
+}
+
+void GLStateCache::depthMask(bool write) {
+    if (update(m_depthMask, write ? GL_TRUE : GL_FALSE)) {
+        glDepthMask(write ? GL_TRUE : GL_FALSE);
+    }
+}
+
+void GLStateCache::colorMask(bool write) {
+    if (update(m_colorMask, write ? GL_TRUE : GL_FALSE)) {
+        GLboolean value = write ? GL_TRUE : GL_FALSE;
+        glColorMask(value, value, value, value);
+    }
+}
+
+void GLStateCache::cullFace(GLenum face) {
+    if (update(m_cullFace, face)) {
+        glCullFace(face);
+    }
+}
+
+void GLStateCache::deleteBuffer(GLuint buffer) {
+    if (buffer == 0) return;
+    glDeleteBuffers(1, &buffer);
+
+    // GL unbinds a deleted buffer from every target of this context
+    for (GLuint& bound : m_buffers) {
+        if (bound == buffer) bound = 0;
+    }
+}
+
+void GLStateCache::deleteTexture(GLuint texture) {
+    if (texture == 0) return;
+    glDeleteTextures(1, &texture);
+
+    for (TextureUnit& unit : m_units) {
+        if (unit.texture2D == texture) unit.texture2D = 0;
+        if (unit.texture2DArray == texture) unit.texture2DArray = 0;
+    }
+}
+
+void GLStateCache::deleteVertexArray(GLuint vao) {
+    if (vao == 0) return;
+    glDeleteVertexArrays(1, &vao);
+    if (m_vertexArray == vao) {
+        m_vertexArray = 0;
+    }
+}
+
+void GLStateCache::restoreDefaults() {
+    useProgram(0);
+    bindVertexArray(0);
+    bindBuffer(GL_ARRAY_BUFFER, 0);
+    bindTexture(0, GL_TEXTURE_2D, 0);
+
+    setEnabled(GL_DEPTH_TEST, false);
+    setEnabled(GL_BLEND, false);
+    setEnabled(GL_CULL_FACE, false);
+    depthMask(true);
+    colorMask(true);
+}
+
+void GLStateCache::invalidate() {
+    m_program = kUnknown;
+    m_vertexArray = kUnknown;
+    for (GLuint& buffer : m_buffers) buffer = kUnknown;
+    m_activeUnit = kUnknown;
+    for (TextureUnit& unit : m_units) {
+        unit.texture2D = kUnknown;
+        unit.texture2DArray = kUnknown;
+    }
+    for (GLuint& capability : m_capabilities) capability = kUnknown;
+    m_blendSource = kUnknown;
+    m_blendDestination = kUnknown;
+    m_depthFunc = kUnknown;
+    m_depthMask = kUnknown;
+    m_colorMask = kUnknown;
+    m_cullFace = kUnknown;
+}
+
+void GLStateCache::beginFrame() {
+    m_lastIssued = m_issued;
+    m_lastSkipped = m_skipped;
+    m_totalIssued += m_issued;
+    m_totalSkipped += m_skipped;
+    ++m_frameCount;
+    m_issued = 0;
+    m_skipped = 0;
+}
+
+void GLStateCache::logSummary() const {
+    if (m_frameCount == 0) return;
+
+    std::cout << "GL state calls: " << m_lastSkipped << " of " << (m_lastIssued + m_lastSkipped)
+        << " skipped last frame, " << m_totalSkipped / m_frameCount << " of "
+        << (m_totalIssued + m_totalSkipped) / m_frameCount << " per frame on average" << std::endl;
+}
@@ -0,0 +1,155 @@
+#ifndef GLSTATECACHE_H
+#define GLSTATECACHE_H
+
+#include <gl/glew/glew.h>
+
+/**
+ * @class GLStateCache
+ * @brief Shadow copy of the bindings and fixed-function state the renderer touches
+ *
+ * Every program, vertex array, buffer and texture bind and every blend,
+ * depth, cull and colour mask change goes through here; a call whose value
+ * matches what was last set is skipped. Only the state listed below is tracked. Other
+ * targets and capabilities pass straight through to GL and count as issued.
+ *
+ * Anything that changes GL state behind the cache's back (SFML's 2D
+ * drawing, a new context) must be followed by invalidate(), after which
+ * the next call for each piece of state is always issued. Objects must be
+ * deleted through the delete functions so a recycled name is never taken
+ * for one that is still bound.
+ *
+ * There is one instance for the process: the game renders from a single
+ * context at a time, and only the thread that currently owns it may call in.
+ * The element array binding is part of the bound vertex array, so it is
+ * never cached.
+ */
+class GLStateCache {
+public:
+    /**
+     * @brief The process-wide cache
+     */
+    static GLStateCache& get();
+
+    GLStateCache(const GLStateCache&) = delete;
+    GLStateCache& operator=(const GLStateCache&) = delete;
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vao);
+    void bindBuffer(GLenum target, GLuint buffer);
+
+    /**
+     * @brief glBindBufferRange, which also replaces the target's generic binding
+     */
+    void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+    /**
+     * @brief Bind a texture to a unit, switching the active unit only if needed
+     */
+    void bindTexture(unsigned int unit, GLenum target, GLuint texture);
+
+    /**
+     * @brief Bind a texture to whichever unit is active (for uploads)
+     */
+    void bindTexture(GLenum target, GLuint texture);
+    void activeTexture(unsigned int unit);
+
+    void setEnabled(GLenum capability, bool enabled);
+    void blendFunc(GLenum source, GLenum destination);
+    void depthFunc(GLenum function);
+    void depthMask(bool write);
+    void colorMask(bool write);  // All four channels together
+    void cullFace(GLenum face);
+
+    void deleteBuffer(GLuint buffer);
+    void deleteTexture(GLuint texture);
+    void deleteVertexArray(GLuint vao);
+
+    /**
+     * @brief Unbind everything tracked and restore SFML's expected defaults
+     *
+     * Call before pushGLStates(): program, vertex array, array buffer and
+     * texture unit 0 are cleared, depth test, blending and culling are off
+     * and depth and colour writes are on.
+     */
+    void restoreDefaults();
+
+    /**
+     * @brief Forget all tracked values; call after popGLStates() or a context switch
+     */
+    void invalidate();
+
+    /**
+     * @brief Close the current frame's counts and start new ones
+     */
+    void beginFrame();
+
+    // Calls sent to GL / skipped in the last closed frame
+    unsigned int getIssuedCalls() const { return m_lastIssued; }
+    unsigned int getSkippedCalls() const { return m_lastSkipped; }
+
+    /**
+     * @brief Print last frame's and the average per-frame counts to stdout
+     */
+    void logSummary() const;
+
+private:
+    static const int kMaxTextureUnits = 16;
+    static const GLuint kUnknown = ~0u;
+
+    enum BufferSlot {
+        BUFFER_ARRAY,
+        BUFFER_UNIFORM,
+        BUFFER_DRAW_INDIRECT,
+        BUFFER_PIXEL_UNPACK,
+        BUFFER_COPY_READ,
+        BUFFER_COPY_WRITE,
+        BUFFER_SLOT_COUNT
+    };
+
+    enum CapabilitySlot {
+        CAPABILITY_BLEND,
+        CAPABILITY_DEPTH_TEST,
+        CAPABILITY_CULL_FACE,
+        CAPABILITY_SLOT_COUNT
+    };
+
+    struct TextureUnit {
+        GLuint texture2D;
+        GLuint texture2DArray;
+    };
+
+    GLuint m_program;
+    GLuint m_vertexArray;
+    GLuint m_buffers[BUFFER_SLOT_COUNT];
+    unsigned int m_activeUnit;  // kUnknown if not known
+    TextureUnit m_units[kMaxTextureUnits];
+
+    // kUnknown, GL_FALSE or GL_TRUE
+    GLuint m_capabilities[CAPABILITY_SLOT_COUNT];
+    GLenum m_blendSource;
+    GLenum m_blendDestination;
+    GLenum m_depthFunc;
+    GLuint m_depthMask;
+    GLuint m_colorMask;
+    GLenum m_cullFace;
+
+    unsigned int m_issued;
+    unsigned int m_skipped;
+    unsigned int m_lastIssued;
+    unsigned int m_lastSkipped;
+    unsigned long long m_totalIssued;
+    unsigned long long m_totalSkipped;
+    unsigned long long m_frameCount;
+
+    GLStateCache();
+
+    // True if value must be sent; records it and counts the call either way
+    bool update(GLuint& current, GLuint value);
+    void countIssued();
+    void countSkipped();
+    GLuint* findTextureSlot(unsigned int unit, GLenum target);
+    static int bufferSlot(GLenum target);
+    static int capabilitySlot(GLenum capability);
+};
+
+#endif // GLSTATECACHE_H
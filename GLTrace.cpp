@@ -0,0 +1,118 @@
+#include "GLTrace.h"
+
+#if defined(MAZE_GL_TRACE)
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+GLTrace& GLTrace::get() {
+    static GLTrace trace;
+    return trace;
+}
+
+GLTrace::GLTrace() : m_frameCount(0), m_frameOpen(false) {
+    findOrAddPass("Frame");
+    m_stack.push_back(0);
+}
+
+int GLTrace::findOrAddPass(const char* name) {
+    // A handful of passes, so a linear scan beats hashing a string every call
+    for (size_t i = 0; i < m_passes.size(); ++i) {
+        if (m_passes[i].name == name || std::strcmp(m_passes[i].name, name) == 0) {
+            return static_cast<int>(i);
+        }
+    }
+
+    PassCounters pass;
+    std::memset(&pass, 0, sizeof(pass));
+    pass.name = name;
+    m_passes.push_back(pass);
+    return static_cast<int>(m_passes.size()) - 1;
+}
+
+void GLTrace::beginFrame() {
+    // Work before the first frame (loading) is not a frame, so it is dropped
+    for (PassCounters& pass : m_passes) {
+        for (int i = 0; i < GLTRACE_COUNTER_COUNT; ++i) {
+            if (m_frameOpen) {
+                pass.last[i] = pass.current[i];
+                pass.total[i] += pass.current[i];
+            }
+            pass.current[i] = 0;
+        }
+    }
+    if (m_frameOpen) {
+        ++m_frameCount;
+    }
+    m_frameOpen = true;
+
+    // A pass left open (an early return) must not swallow the next frame
+    m_stack.resize(1);
+}
+
+void GLTrace::beginPass(const char* name) {
+    m_stack.push_back(findOrAddPass(name));
+}
+
+void GLTrace::endPass() {
+    if (m_stack.size() > 1) {
+        m_stack.pop_back();
+    }
+}
+
+void GLTrace::recordDraw(GLenum mode, GLsizei count, GLsizei instances) {
+    unsigned long long primitives = 0;
+    switch (mode) {
+    case GL_TRIANGLES: primitives = count / 3; break;
+    case GL_TRIANGLE_STRIP:
+    case GL_TRIANGLE_FAN: primitives = count > 2 ? count - 2 : 0; break;
+    default: break;
+    }
+
+    add(GLTRACE_DRAW_CALLS, 1);
+    add(GLTRACE_TRIANGLES, primitives * static_cast<unsigned long long>(instances));
+}
+
+void GLTrace::logSummary() const {
+    if (m_frameCount == 0) return;
+
+    static const char* const kHeaders[GLTRACE_COUNTER_COUNT] = {
+        "draws", "tris", "uniforms", "lookups", "state", "redundant", "uploads", "bytes"
+    };
+
+    // Each cell is "last frame / average per frame"
+    char cell[64];
+    std::cout << "GL calls per frame (last / average of " << m_frameCount << " frames)" << std::endl;
+    std::string line = "  Pass            ";
+    for (const char* header : kHeaders) {
+        std::snprintf(cell, sizeof(cell), " %22s", header);
+        line += cell;
+    }
+    std::cout << line << std::endl;
+
+    unsigned long long lastSum[GLTRACE_COUNTER_COUNT] = {};
+    unsigned long long totalSum[GLTRACE_COUNTER_COUNT] = {};
+    auto printRow = [&](const char* name, const unsigned long long* last, const unsigned long long* total) {
+        std::snprintf(cell, sizeof(cell), "  %-16s", name);
+        line = cell;
+        for (int i = 0; i < GLTRACE_COUNTER_COUNT; ++i) {
+            std::snprintf(cell, sizeof(cell), " %10llu /%10.1f", last[i],
+                static_cast<double>(total[i]) / static_cast<double>(m_frameCount));
+            line += cell;
+        }
+        std::cout << line << std::endl;
+    };
+
+    for (const PassCounters& pass : m_passes) {
+        printRow(pass.name, pass.last, pass.total);
+        for (int i = 0; i < GLTRACE_COUNTER_COUNT; ++i) {
+            lastSum[i] += pass.last[i];
+            totalSum[i] += pass.total[i];
+        }
+    }
+    printRow("Total", lastSum, totalSum);
+}
+
+#endif // MAZE_GL_TRACE
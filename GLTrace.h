@@ -0,0 +1,101 @@
+#ifndef GLTRACE_H
+#define GLTRACE_H
+
+/*
+ * Optional GL instrumentation. Define MAZE_GL_TRACE to count, per frame and
+ * per GPU profiler pass, the draws, triangles, uniform calls and uniform
+ * location lookups, state calls (and how many the GLStateCache found
+ * redundant) and the bytes uploaded to buffers and textures. Without it
+ * every MAZE_GL_TRACE_* macro expands to ((void)0), its arguments are never
+ * evaluated and GLTrace is not compiled at all.
+ */
+#if defined(MAZE_GL_TRACE)
+
+#include <gl/glew/glew.h>
+#include <vector>
+
+enum GLTraceCounter {
+    GLTRACE_DRAW_CALLS,
+    GLTRACE_TRIANGLES,
+    GLTRACE_UNIFORM_CALLS,
+    GLTRACE_UNIFORM_LOOKUPS,   // glGetUniformLocation
+    GLTRACE_STATE_CALLS,       // Binds and state changes sent to GL
+    GLTRACE_REDUNDANT_STATE,   // ... and those skipped as redundant
+    GLTRACE_UPLOAD_CALLS,
+    GLTRACE_UPLOAD_BYTES,
+    GLTRACE_COUNTER_COUNT
+};
+
+/**
+ * @class GLTrace
+ * @brief Per-frame, per-pass counters behind the MAZE_GL_TRACE_* macros
+ *
+ * Work is charged to the innermost open GpuProfiler pass, or to "Frame"
+ * outside any pass; a pass opened several times in a frame is summed.
+ * Like GLStateCache there is one instance, used by the thread that owns
+ * the context.
+ */
+class GLTrace {
+public:
+    static GLTrace& get();
+
+    GLTrace(const GLTrace&) = delete;
+    GLTrace& operator=(const GLTrace&) = delete;
+
+    /**
+     * @brief Close the current frame's counts and start new ones
+     */
+    void beginFrame();
+
+    /**
+     * @brief Open a pass; name must stay valid (use a literal)
+     */
+    void beginPass(const char* name);
+    void endPass();
+
+    void add(GLTraceCounter counter, unsigned long long amount) { m_passes[m_stack.back()].current[counter] += amount; }
+    void recordDraw(GLenum mode, GLsizei count, GLsizei instances);
+
+    /**
+     * @brief Print last frame's counts and the per-frame averages of each pass to stdout
+     */
+    void logSummary() const;
+
+private:
+    struct PassCounters {
+        const char* name;
+        unsigned long long current[GLTRACE_COUNTER_COUNT];
+        unsigned long long last[GLTRACE_COUNTER_COUNT];
+        unsigned long long total[GLTRACE_COUNTER_COUNT];
+    };
+
+    std::vector<PassCounters> m_passes;  // [0] is "Frame"
+    std::vector<int> m_stack;            // Open passes, innermost last
+    unsigned long long m_frameCount;     // Closed frames
+    bool m_frameOpen;
+
+    GLTrace();
+    int findOrAddPass(const char* name);
+};
+
+#define MAZE_GL_TRACE_FRAME() GLTrace::get().beginFrame()
+#define MAZE_GL_TRACE_BEGIN_PASS(name) GLTrace::get().beginPass(name)
+#define MAZE_GL_TRACE_END_PASS() GLTrace::get().endPass()
+#define MAZE_GL_TRACE_DRAW(mode, count, instances) GLTrace::get().recordDraw((mode), (count), (instances))
+#define MAZE_GL_TRACE_COUNT(counter, amount) GLTrace::get().add((counter), (amount))
+#define MAZE_GL_TRACE_UPLOAD(bytes) (GLTrace::get().add(GLTRACE_UPLOAD_CALLS, 1), GLTrace::get().add(GLTRACE_UPLOAD_BYTES, (bytes)))
+#define MAZE_GL_TRACE_LOG() GLTrace::get().logSummary()
+
+#else
+
+#define MAZE_GL_TRACE_FRAME() ((void)0)
+#define MAZE_GL_TRACE_BEGIN_PASS(name) ((void)0)
+#define MAZE_GL_TRACE_END_PASS() ((void)0)
+#define MAZE_GL_TRACE_DRAW(mode, count, instances) ((void)0)
+#define MAZE_GL_TRACE_COUNT(counter, amount) ((void)0)
+#define MAZE_GL_TRACE_UPLOAD(bytes) ((void)0)
+#define MAZE_GL_TRACE_LOG() ((void)0)
+
+#endif // MAZE_GL_TRACE
+
+#endif // GLTRACE_H
@@ -1,9 +1,70 @@
 #include "Game.h"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
 #include <cmath>
+#include <fstream>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include "CameraPath.h"
+#include "GLStateCache.h"
+#include "GLTrace.h"
+#include "NoiseTexture.h"
+#include "SoftwareRenderer.h"
+
+namespace {
+	// Closer than this (horizontally) the portal fills enough of the screen
+	// to be drawn at half resolution
+	const float kPortalHalfResolutionDistance = 4.0f;
+
+	// Each orb lights the walls around it in its own orange, scaled by its pulse
+	const float kOrbLightRadius = 3.0f;
+	const Vector3 kOrbLightColor(0.6f, 0.36f, 0.06f);
+
+	void printFrameTimes(std::vector<float> frameTimes, const char* label = "Frame time") {
+		if (frameTimes.empty()) return;
+
+		std::sort(frameTimes.begin(), frameTimes.end());
+		double total = 0.0;
+		for (float t : frameTimes) total += t;
+
+		auto percentile = [&](float p) {
+			return frameTimes[static_cast<size_t>(p / 100.0f * (frameTimes.size() - 1) + 0.5f)];
+		};
+
+		std::cout << std::fixed << std::setprecision(3)
+			<< label << " (ms): avg " << total / frameTimes.size()
+			<< "  min " << frameTimes.front()
+			<< "  p50 " << percentile(50.0f)
+			<< "  p95 " << percentile(95.0f)
+			<< "  p99 " << percentile(99.0f)
+			<< "  max " << frameTimes.back() << std::endl;
+	}
+
+	bool isCaptureFrame(const HeadlessOptions& options, int frame) {
+		return std::find(options.captureFrames.begin(), options.captureFrames.end(), frame) != options.captureFrames.end();
+	}
 
-Game::Game() : m_deltaTime(0.0f), m_totalTime(0.0f), m_walkTime(0.0f) {}
+	std::string capturePath(const HeadlessOptions& options, int frame) {
+		char name[32];
+		std::snprintf(name, sizeof(name), "frame_%05d.png", frame);
+		return options.outputDirectory + "/" + name;
+	}
+}
+
+constexpr float Game::kSimulationStep;
+constexpr float Game::kMaxFrameTime;
+
+Game::Game()
+	: m_deltaTime(0.0f),
+	  m_totalTime(0.0f),
+	  m_walkTime(0.0f),
+	  m_levelTime(0.0f),
+	  m_accumulator(0.0),
+	  m_interpolation(1.0f),
+	  m_previousTotalTime(0.0f) {}
 
 bool Game::initialize() {
 	if (!createWindow()) {
@@ -17,11 +78,33 @@ bool Game::initialize() {
 	return true;
 }
 
+bool Game::initializeHeadless(const HeadlessOptions& options) {
+	m_headlessOptions = options;
+	m_recordPath = options.recordPath;
+
+	m_headlessContext = std::make_unique<HeadlessContext>();
+	if (!m_headlessContext->create(options.width, options.height)) {
+		std::cerr << "ERROR: Failed to create headless context" << std::endl;
+		return false;
+	}
+
+	if (!initializeResources()) {
+		return false;
+	}
+
+	m_renderer->getDynamicResolution()->setEnabled(options.dynamicResolution);
+	m_renderer->setLightGridEnabled(options.lightGrid);
+
+	// Captures must not depend on how fast the workers decoded the textures
+	m_textureLoader->finishAll();
+	return true;
+}
+
 bool Game::createWindow() {
 	sf::ContextSettings settings;
 	settings.depthBits = 24;
 	settings.stencilBits = 8;
-	settings.antialiasingLevel = 4;
+	settings.antialiasingLevel = 0;  // The offscreen scene target does its own 4x MSAA
 	settings.majorVersion = 3;
 	settings.minorVersion = 3;
 	settings.attributeFlags = sf::ContextSettings::Default;
@@ -55,62 +138,113 @@ bool Game::initializeResources() {
 		return false;
 	}
 
-	sf::Vector2u windowSize = m_window->getSize();
+	sf::Vector2u windowSize = m_window ? m_window->getSize()
+		: sf::Vector2u(m_headlessContext->getWidth(), m_headlessContext->getHeight());
 	m_renderer->setViewport(windowSize.x, windowSize.y);
+	if (m_headlessContext) {
+		m_renderer->setOutputFramebuffer(m_headlessContext->getFramebuffer());
+	}
 
-	m_maze = std::make_unique<Maze>(15, 15);
+	m_gpuProfiler = std::make_unique<GpuProfiler>();
 
-	m_wallMesh = std::make_unique<Mesh>();
-	m_floorMesh = std::make_unique<Mesh>();
-	m_ceilingMesh = std::make_unique<Mesh>();
-	m_teleportMesh = std::make_unique<Mesh>();
+	// Submit the remaining shaders before anything else; they compile while
+	// meshes, textures and audio load, and are collected further down
+	m_teleportShader = std::make_unique<ShaderProgram>();
+	bool teleportSubmitted = m_teleportShader->submitFromFile("shaders/teleport_vertex.glsl", "shaders/teleport_fragment.glsl");
 
-	m_maze->generateMeshes(*m_wallMesh, *m_floorMesh, *m_ceilingMesh);
-	m_maze->generateTeleportMesh(*m_teleportMesh);
+	m_collectibleShader = std::make_unique<ShaderProgram>();
+	bool collectibleSubmitted = m_collectibleShader->submitFromFile("shaders/collectible_vertex.glsl", "shaders/collectible_fragment.glsl");
 
-	if (!m_wallMesh->isValid() || !m_floorMesh->isValid() || !m_ceilingMesh->isValid()) {
-		std::cerr << "ERROR: Mesh generation failed" << std::endl;
-		return false;
+	// Headless runs use a fixed seed so every run sees the same maze. Others
+	// pick one here rather than in Maze so a recording can store it
+	unsigned int seed = m_headlessContext ? m_headlessOptions.seed : 0;
+	if (seed == 0) {
+		seed = static_cast<unsigned int>(std::time(nullptr));
 	}
+	m_maze = std::make_unique<Maze>(15, 15, seed);
 
-	m_wallTexture = std::make_unique<Texture>();
-	m_floorTexture = std::make_unique<Texture>();
-	m_ceilingTexture = std::make_unique<Texture>();
-
-	if (!m_wallTexture->loadFromFile("textures/wall.png")) {
-		std::cerr << "ERROR: Failed to load wall texture" << std::endl;
-		return false;
+	if (!m_recordPath.empty()) {
+		m_recorder = std::make_unique<RenderRecorder>();
+		if (!m_recorder->open(m_recordPath, seed, windowSize.x, windowSize.y)) {
+			return false;
+		}
 	}
 
-	if (!m_floorTexture->loadFromFile("textures/floor.png")) {
-		std::cerr << "ERROR: Failed to load floor texture" << std::endl;
-		return false;
+	// === MATERIALS: every surface texture is a layer of one array ===
+	// Layer order: floor, ceiling, then one layer per wall variant
+	std::vector<std::string> materialFiles = { "textures/floor.png", "textures/ceiling.png", "textures/wall.png" };
+	if (!std::ifstream(materialFiles[1]).good()) {
+		std::cout << "  WARNING: ceiling.png not found, using floor.png" << std::endl;
+		materialFiles[1] = materialFiles[0];
 	}
 
-	if (!m_ceilingTexture->loadFromFile("textures/ceiling.png")) {
-		std::cout << "  WARNING: ceiling.png not found, using floor.png" << std::endl;
-		if (!m_ceilingTexture->loadFromFile("textures/floor.png")) {
-			std::cerr << "ERROR: Failed to load ceiling fallback" << std::endl;
-			return false;
+	MazeMaterials materials;
+	materials.floorLayer = 0;
+	materials.ceilingLayer = 1;
+	materials.wallLayer = 2;
+	materials.wallVariantCount = 1;
+
+	// Optional wall variants, assigned per wall cell
+	const char* wallVariants[] = { "textures/wall2.png" };
+	for (const char* variant : wallVariants) {
+		if (std::ifstream(variant).good()) {
+			materialFiles.push_back(variant);
+			materials.wallVariantCount++;
 		}
 	}
 
-	m_teleportShader = std::make_unique<ShaderProgram>();
-	if (!m_teleportShader->loadFromFile("shaders/teleport_vertex.glsl", "shaders/teleport_fragment.glsl")) {
-		std::cerr << "Failed to load teleport shaders!" << std::endl;
-		return false;
+	// Decoded on worker threads and streamed in over the next frames; the
+	// maze shows a grey placeholder until then (and stays grey on failure)
+	m_threadPool = std::make_unique<ThreadPool>();
+	m_textureLoader = std::make_unique<AsyncTextureLoader>(*m_threadPool);
+	m_materials = m_textureLoader->loadArray(materialFiles);
+
+	m_teleportMesh = std::make_unique<Mesh>();
+
+	// Chunks are culled against the view frustum and drawn in one batch
+	m_maze->generateChunkMeshes(m_mazeChunks, materials);
+	m_maze->generateTeleportMesh(*m_teleportMesh);
+
+	// Ambient, overhead and portal light never change for a maze: bake them
+	// once so the surface shader only adds what moves. Only seeds that come
+	// round again are cached: headless runs, replays and recorded sessions
+	// (their replay rebuilds the same maze). A clock seed never repeats, so
+	// its bake stays in memory rather than filling the cache directory.
+	Lightmap lightmap;
+	LightmapBaker baker(m_threadPool.get());
+	LightmapLighting staticLighting = Renderer::getStaticLighting(m_maze->getExitPosition());
+	if (m_headlessContext || m_recorder) {
+		baker.loadOrBake(*m_maze, seed, staticLighting, lightmap);
 	}
+	else {
+		baker.bake(*m_maze, staticLighting, lightmap);
+	}
+	m_renderer->setLightmap(lightmap);
+	m_renderer->setLightGridMaze(*m_maze);
+
+	// The portal samples its noise instead of hashing it per fragment
+	const int noiseSize = 256;
+	std::vector<unsigned char> noise = NoiseTexture::generateFbm(noiseSize, 16, 4, 1);
+	m_portalNoise = std::make_unique<Texture>();
+	m_portalNoise->createSingleChannel(noiseSize, noiseSize, noise.data());
+
+	m_chunkBounds.clear();
+	for (const MazeChunk& chunk : m_mazeChunks) {
+		m_chunkBounds.push_back(chunk.bounds);
+	}
+	m_chunkVisible.resize(m_mazeChunks.size());
+	m_chunkDistances.resize(m_mazeChunks.size());
 
-	m_collectibleShader = std::make_unique<ShaderProgram>();
-	if (!m_collectibleShader->loadFromFile("shaders/collectible_vertex.glsl", "shaders/collectible_fragment.glsl")) {
-		std::cerr << "WARNING: Failed to load collectible shaders" << std::endl;
+	if (m_mazeChunks.empty() || !m_mazeChunks[0].mesh.isValid()) {
+		std::cerr << "ERROR: Mesh generation failed" << std::endl;
+		return false;
 	}
 
 	m_collectibleMesh = std::make_unique<Mesh>();
 	generateSphereMesh(*m_collectibleMesh, 0.4f, 16, 16);
 
 	m_collectibleManager = std::make_unique<CollectibleManager>();
-	m_collectibleManager->initialize(*m_maze);
+	m_collectibleManager->initialize(*m_maze, seed);
 
 	// === REMOVED: Particle system (replaced with screen flash) ===
 	// m_particleSystem = std::make_unique<ParticleSystem>();
@@ -131,10 +265,33 @@ bool Game::initializeResources() {
 	m_audioManager->loadSound("collect", "audio/collect.wav");
 	m_audioManager->loadSound("footstep", "audio/footstep.wav");
 	m_audioManager->loadSound("win", "audio/win.wav");
-	m_audioManager->playMusic("ambient", true, 30.0f);
+	if (m_window) {
+		m_audioManager->playMusic("ambient", true, 30.0f);
+	}
+
+	// === Collect the shaders submitted above ===
+	if (!m_renderer->finishShaders()) {
+		std::cerr << "ERROR: Failed to initialize renderer" << std::endl;
+		return false;
+	}
+
+	if (!teleportSubmitted || !m_teleportShader->finish()) {
+		std::cerr << "Failed to load teleport shaders!" << std::endl;
+		return false;
+	}
+
+	if (!collectibleSubmitted || !m_collectibleShader->finish()) {
+		std::cerr << "WARNING: Failed to load collectible shaders" << std::endl;
+	}
+
+	if (m_renderer->getProgramCache()) {
+		m_renderer->getProgramCache()->printStats();
+	}
 
 	Vector3 startPos = m_maze->getStartPosition();
 	m_player = std::make_unique<Player>(startPos);
+	m_previousEyePosition = m_player->getCamera().getPosition();
+	m_previousPlayerPosition = m_player->getPosition();
 
 	m_inputHandler = std::make_unique<InputHandler>();
 
@@ -148,23 +305,405 @@ bool Game::initializeResources() {
 
 	sf::Vector2u windowCenter = windowSize / 2u;
 	m_inputHandler->initializeMousePosition(windowCenter.x, windowCenter.y);
-	sf::Mouse::setPosition(sf::Vector2i(windowCenter.x, windowCenter.y), *m_window);
+	if (m_window) {
+		sf::Mouse::setPosition(sf::Vector2i(windowCenter.x, windowCenter.y), *m_window);
+	}
 
 	return true;
 }
 
+void Game::setLightGridEnabled(bool enabled) {
+	m_renderer->setLightGridEnabled(enabled);
+}
+
 void Game::run() {
 	m_clock.restart();
 
-	while (m_window->isOpen() && !m_inputHandler->shouldExit()) {
-		m_deltaTime = m_clock.restart().asSeconds();
+	if (m_pipelined) {
+		runPipelined();
+	}
+	else {
+		while (m_window->isOpen() && !m_inputHandler->shouldExit() && !m_quitRequested) {
+			processInput();
+			advanceSimulation(m_clock.restart().asSeconds());
+			renderCurrentState();
+		}
+	}
 
+	m_gpuProfiler->logSummary();
+	GLStateCache::get().logSummary();
+	MAZE_GL_TRACE_LOG();
+	m_window->close();
+}
+
+void Game::runPipelined() {
+	std::cout << "Pipelined mode: rendering on a separate thread" << std::endl;
+
+	// The GL context belongs to the render thread until it is joined
+	m_window->setActive(false);
+	m_publishedFrames = 0;
+	m_acquiredFrames = 0;
+	m_stopRendering = false;
+	m_renderThread = std::thread(&Game::renderThreadMain, this);
+
+	while (m_window->isOpen() && !m_inputHandler->shouldExit() && !m_quitRequested) {
 		processInput();
-		update();
-		render();
+		advanceSimulation(m_clock.restart().asSeconds());
+
+		buildSnapshot(m_snapshots.writeSlot());
+		m_snapshots.publish();
+
+		// Wait until the render thread has taken this frame, then simulate
+		// the next one while it draws; the simulation is never further ahead
+		std::unique_lock<std::mutex> lock(m_frameMutex);
+		++m_publishedFrames;
+		m_frameSignal.notify_all();
+		m_frameSignal.wait(lock, [this]() { return m_stopRendering || m_acquiredFrames == m_publishedFrames; });
+		if (m_stopRendering) {
+			break;  // Render thread failed to start
+		}
 	}
 
-	m_window->close();
+	{
+		std::lock_guard<std::mutex> lock(m_frameMutex);
+		m_stopRendering = true;
+	}
+	m_frameSignal.notify_all();
+	m_renderThread.join();
+
+	// Back on this thread for the summary and for releasing GL objects
+	m_window->setActive(true);
+}
+
+void Game::renderThreadMain() {
+	if (!m_window->setActive(true)) {
+		std::cerr << "ERROR: Failed to activate the GL context on the render thread" << std::endl;
+		std::lock_guard<std::mutex> lock(m_frameMutex);
+		m_stopRendering = true;
+		m_frameSignal.notify_all();
+		return;
+	}
+
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(m_frameMutex);
+			m_frameSignal.wait(lock, [this]() { return m_stopRendering || m_acquiredFrames != m_publishedFrames; });
+			if (m_stopRendering) {
+				break;
+			}
+			m_snapshots.acquire();
+			m_acquiredFrames = m_publishedFrames;
+		}
+		m_frameSignal.notify_all();
+
+		render(m_snapshots.readSlot());
+	}
+
+	m_window->setActive(false);
+}
+
+int Game::runHeadless() {
+	const HeadlessOptions& options = m_headlessOptions;
+	const float frameStep = 1.0f / 60.0f;
+
+	CameraPath path(m_maze->findPath());
+	if (path.isEmpty()) {
+		std::cerr << "ERROR: Maze has no path from start to exit" << std::endl;
+		return 1;
+	}
+
+	std::FILE* stats = nullptr;
+	if (!options.statsPath.empty()) {
+		stats = std::fopen(options.statsPath.c_str(), "w");
+		if (!stats) {
+			std::cerr << "ERROR: Cannot write " << options.statsPath << std::endl;
+			return 1;
+		}
+		std::fprintf(stats, "frame,cpu_ms,gpu_ms,render_scale\n");
+	}
+
+	std::vector<float> frameTimes;
+	frameTimes.reserve(options.frames);
+	int failedCaptures = 0;
+
+	std::cout << "Headless run: " << options.frames << " frames at " << options.width << "x" << options.height
+		<< ", seed " << options.seed << std::endl;
+
+	for (int frame = 0; frame < options.frames; ++frame) {
+		auto start = std::chrono::steady_clock::now();
+
+		Vector3 position;
+		float yaw = 0.0f;
+		float pitch = 0.0f;
+		path.sample(m_totalTime, position, yaw, pitch);
+		m_player->setPosition(position);
+		m_player->getCamera().setOrientation(yaw, pitch);
+
+		advanceSimulation(frameStep);
+		renderCurrentState();
+
+		// Without a swap to pace it, only a finish makes the frame time include the GPU work
+		glFinish();
+		float cpuMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+		frameTimes.push_back(cpuMilliseconds);
+
+		if (stats) {
+			std::fprintf(stats, "%d,%.3f,%.3f,%.3f\n", frame, cpuMilliseconds,
+				m_gpuProfiler->getLastMilliseconds("Frame"), m_renderer->getRenderScale());
+		}
+
+		if (isCaptureFrame(options, frame)) {
+			std::string path = capturePath(options, frame);
+			if (m_headlessContext->saveImage(path)) {
+				std::cout << "  Captured " << path << std::endl;
+			}
+			else {
+				++failedCaptures;
+			}
+		}
+	}
+
+	if (stats) {
+		std::fclose(stats);
+	}
+
+	printFrameTimes(frameTimes);
+	m_gpuProfiler->logSummary();
+	GLStateCache::get().logSummary();
+	MAZE_GL_TRACE_LOG();
+
+	return failedCaptures == 0 ? 0 : 1;
+}
+
+int Game::runReplay(RenderRecording& recording, const ReplayOptions& options) {
+	if (recording.getFrameCount() == 0) {
+		std::cerr << "ERROR: Recording has no complete frames" << std::endl;
+		return 1;
+	}
+
+	std::FILE* stats = nullptr;
+	if (!options.statsPath.empty()) {
+		stats = std::fopen(options.statsPath.c_str(), "w");
+		if (!stats) {
+			std::cerr << "ERROR: Cannot write " << options.statsPath << std::endl;
+			return 1;
+		}
+		std::fprintf(stats, "frame,submit_ms,gpu_ms\n");
+	}
+
+	std::cout << "Replay: " << recording.getFrameCount() << " frames x " << options.loops << " at "
+		<< recording.getWidth() << "x" << recording.getHeight() << ", seed " << recording.getSeed()
+		<< ", " << recording.getByteSize() / 1024 << " KB" << (options.nullBackend ? ", null backend" : "")
+		<< (options.depthPrepass ? "" : ", no depth pre-pass") << (options.lightmap ? "" : ", no lightmap")
+		<< (options.lightGrid ? ", light grid" : "") << std::endl;
+
+	// Every command still reaches the driver; the GPU just discards the
+	// primitives, leaving CPU submission cost on its own
+	if (options.nullBackend) {
+		glEnable(GL_RASTERIZER_DISCARD);
+	}
+	m_renderer->setDepthPrepassEnabled(options.depthPrepass);
+	m_renderer->setLightmapEnabled(options.lightmap);
+	m_renderer->setLightGridEnabled(options.lightGrid);
+
+	std::vector<float> submitTimes;
+	submitTimes.reserve(static_cast<size_t>(recording.getFrameCount()) * options.loops);
+	std::vector<unsigned int> chunkIndices;
+	std::vector<OrbDraw> orbs;
+	std::vector<PointLight> lights;
+	int frame = 0;
+
+	auto replayStart = std::chrono::steady_clock::now();
+	auto frameStart = replayStart;
+
+	for (int loop = 0; loop < options.loops; ++loop) {
+		recording.rewind();
+
+		RenderRecording::Command command;
+		while (recording.next(command)) {
+			switch (command.type) {
+			case RENDER_COMMAND_BEGIN_FRAME: {
+				SceneCommand scene;
+				if (command.size != sizeof(scene)) break;
+				frameStart = std::chrono::steady_clock::now();
+				std::memcpy(&scene, command.data, sizeof(scene));
+				beginScene(scene);
+				break;
+			}
+			case RENDER_COMMAND_SET_LIGHTS: {
+				lights.resize(command.size / sizeof(PointLight));
+				if (!lights.empty()) {
+					std::memcpy(lights.data(), command.data, lights.size() * sizeof(PointLight));
+				}
+				setLights(lights);
+				break;
+			}
+			case RENDER_COMMAND_DRAW_CHUNKS: {
+				size_t count = command.size / sizeof(uint32_t);
+				chunkIndices.resize(count);
+				for (size_t i = 0; i < count; ++i) {
+					uint32_t index;
+					std::memcpy(&index, command.data + i * sizeof(index), sizeof(index));
+					chunkIndices[i] = index;
+				}
+				drawChunks(chunkIndices);
+				break;
+			}
+			case RENDER_COMMAND_DRAW_ORBS: {
+				float time;
+				if (command.size < sizeof(time)) break;
+				std::memcpy(&time, command.data, sizeof(time));
+				orbs.resize((command.size - sizeof(time)) / sizeof(OrbDraw));
+				if (!orbs.empty()) {
+					std::memcpy(orbs.data(), command.data + sizeof(time), orbs.size() * sizeof(OrbDraw));
+				}
+				drawOrbs(time, orbs);
+				break;
+			}
+			case RENDER_COMMAND_DRAW_PORTAL: {
+				float time;
+				if (command.size != sizeof(time)) break;
+				std::memcpy(&time, command.data, sizeof(time));
+				drawPortal(time);
+				break;
+			}
+			case RENDER_COMMAND_END_FRAME: {
+				endScene();
+				m_gpuProfiler->endFrame();
+
+				// No glFinish: this is the time to hand the frame to the driver
+				float submitMilliseconds = std::chrono::duration<float, std::milli>(
+					std::chrono::steady_clock::now() - frameStart).count();
+				submitTimes.push_back(submitMilliseconds);
+
+				if (stats) {
+					std::fprintf(stats, "%d,%.3f,%.3f\n", frame, submitMilliseconds,
+						m_gpuProfiler->getLastMilliseconds("Frame"));
+				}
+				++frame;
+				break;
+			}
+			default:
+				// Unknown commands from a newer build are skipped
+				break;
+			}
+		}
+	}
+
+	glFinish();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - replayStart).count();
+
+	if (options.nullBackend) {
+		glDisable(GL_RASTERIZER_DISCARD);
+	}
+	if (stats) {
+		std::fclose(stats);
+	}
+
+	printFrameTimes(submitTimes, "Submit time");
+	std::cout << std::fixed << std::setprecision(1)
+		<< "Replayed " << frame << " frames in " << seconds * 1000.0 << " ms ("
+		<< (seconds > 0.0 ? frame / seconds : 0.0) << " frames/s)" << std::endl;
+	m_gpuProfiler->logSummary();
+	GLStateCache::get().logSummary();
+	MAZE_GL_TRACE_LOG();
+
+	return 0;
+}
+
+int Game::runSoftware(const HeadlessOptions& options) {
+	const float frameStep = 1.0f / 60.0f;
+
+	Maze maze(15, 15, options.seed);
+	CameraPath path(maze.findPath());
+	if (path.isEmpty()) {
+		std::cerr << "ERROR: Maze has no path from start to exit" << std::endl;
+		return 1;
+	}
+
+	// Same layer order as the GL materials
+	std::vector<std::string> materialFiles = { "textures/floor.png", "textures/ceiling.png", "textures/wall.png" };
+	if (!std::ifstream(materialFiles[1]).good()) {
+		materialFiles[1] = materialFiles[0];
+	}
+	MazeMaterials materials;
+	materials.floorLayer = 0;
+	materials.ceilingLayer = 1;
+	materials.wallLayer = 2;
+	if (std::ifstream("textures/wall2.png").good()) {
+		materialFiles.push_back("textures/wall2.png");
+		materials.wallVariantCount = 2;
+	}
+
+	// Workers plus this thread fill the cores
+	ThreadPool pool;
+	SoftwareRenderer renderer(&pool);
+	renderer.loadMaterials(materialFiles, materials);
+	renderer.setSize(options.width, options.height);
+
+	LightGrid lightGrid;
+	if (options.lightGrid) {
+		lightGrid.setMaze(maze);
+		renderer.setLightGrid(&lightGrid);
+	}
+
+	std::FILE* stats = nullptr;
+	if (!options.statsPath.empty()) {
+		stats = std::fopen(options.statsPath.c_str(), "w");
+		if (!stats) {
+			std::cerr << "ERROR: Cannot write " << options.statsPath << std::endl;
+			return 1;
+		}
+		std::fprintf(stats, "frame,cpu_ms\n");
+	}
+
+	std::cout << "Software run: " << options.frames << " frames at " << options.width << "x" << options.height
+		<< ", seed " << options.seed << ", " << pool.getThreadCount() + 1 << " threads"
+		<< (options.lightGrid ? ", light grid" : "") << std::endl;
+
+	Player player(maze.getStartPosition());
+	std::vector<float> frameTimes;
+	frameTimes.reserve(options.frames);
+	int failedCaptures = 0;
+
+	for (int frame = 0; frame < options.frames; ++frame) {
+		float time = frame * frameStep;
+		Vector3 position;
+		float yaw = 0.0f;
+		float pitch = 0.0f;
+		path.sample(time, position, yaw, pitch);
+		player.setPosition(position);
+		player.getCamera().setOrientation(yaw, pitch);
+
+		auto start = std::chrono::steady_clock::now();
+		renderer.render(maze, player.getCamera(), maze.getExitPosition(), time, true, 1.0f);
+		float milliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+		frameTimes.push_back(milliseconds);
+
+		if (stats) {
+			std::fprintf(stats, "%d,%.3f\n", frame, milliseconds);
+		}
+
+		if (isCaptureFrame(options, frame)) {
+			std::string path = capturePath(options, frame);
+			sf::Image image;
+			image.create(renderer.getWidth(), renderer.getHeight(), renderer.getPixels().data());
+			if (image.saveToFile(path)) {
+				std::cout << "  Captured " << path << std::endl;
+			}
+			else {
+				std::cerr << "ERROR: Failed to write " << path << std::endl;
+				++failedCaptures;
+			}
+		}
+	}
+
+	if (stats) {
+		std::fclose(stats);
+	}
+
+	printFrameTimes(frameTimes);
+	return failedCaptures == 0 ? 0 : 1;
 }
 
 void Game::processInput() {
@@ -177,18 +716,22 @@ void Game::processInput() {
 			if (event.key.code == sf::Keyboard::F) {
 				m_flashlight->toggle();
 			}
+			// Dump GPU pass timings and GL state call counts with F3 (both live on the render thread)
+			else if (event.key.code == sf::Keyboard::F3) {
+				m_logGpuTimings = true;
+			}
 		}
 
 		if (m_gameState == WON) {
 			if (event.type == sf::Event::MouseButtonPressed) {
 				if (event.mouseButton.button == sf::Mouse::Left) {
-					int action = m_ui->checkButtonPress(event.mouseButton.x, event.mouseButton.y);
+					int action = m_ui->checkButtonPress(event.mouseButton.x, event.mouseButton.y, m_window->getSize());
 
 					if (action == 1) {
 						resetGame();
 					}
 					else if (action == 2) {
-						m_window->close();
+						m_quitRequested = true;  // run() closes the window once rendering has stopped
 					}
 				}
 			}
@@ -196,12 +739,40 @@ void Game::processInput() {
 	}
 }
 
+void Game::advanceSimulation(float frameTime) {
+	// After a stall (window drag, breakpoint) the game slows down rather
+	// than running hundreds of ticks to catch up
+	m_accumulator += std::min(frameTime, kMaxFrameTime);
+
+	// Looking around follows the display rate; it is input, not simulation
+	if (m_window && m_gameState == PLAYING) {
+		handleMouseLook();
+	}
+
+	m_deltaTime = kSimulationStep;
+	while (m_accumulator >= kSimulationStep) {
+		m_previousEyePosition = m_player->getCamera().getPosition();
+		m_previousPlayerPosition = m_player->getPosition();
+		m_previousTotalTime = m_totalTime;
+
+		update();
+		m_accumulator -= kSimulationStep;
+	}
+
+	// How far the display is between the last two ticks
+	m_interpolation = static_cast<float>(m_accumulator / kSimulationStep);
+
+	m_inputHandler->update();
+}
+
 void Game::update() {
 	m_totalTime += m_deltaTime;
 
 	if (m_gameState == PLAYING) {
-		handleMouseLook();
-		handleMovement();
+		// Headless runs move the player along a scripted path instead
+		if (m_window) {
+			handleMovement();
+		}
 
 		// Update flashlight battery
 		m_flashlight->update(m_deltaTime);
@@ -234,11 +805,8 @@ void Game::update() {
 			m_screenFlash->trigger(sf::Color(255, 220, 50), 0.6f);
 		}
 
-		// Update minimap orb positions
-		m_ui->updateCollectiblePositions(m_collectibleManager->getCollectibles());
-
+		m_levelTime += m_deltaTime;
 		checkWinCondition();
-		m_ui->update(m_deltaTime, *m_player, *m_maze);
 	}
 
 	// === NEW: UPDATE SCREEN FLASH ===
@@ -249,8 +817,6 @@ void Game::update() {
 		m_player->getPosition(),
 		m_player->getCamera().getFront()
 	);
-
-	m_inputHandler->update();
 }
 
 void Game::handleMovement() {
@@ -263,7 +829,6 @@ void Game::handleMovement() {
 	if (m_inputHandler->isLeftPressed())     right -= 1.0f;
 
 	float dt = m_deltaTime;
-	if (dt > 0.1f) dt = 0.1f;
 
 	bool isMoving = (forward != 0.0f || right != 0.0f);
 	if (isMoving) {
@@ -296,152 +861,331 @@ void Game::handleMouseLook() {
 	}
 }
 
-void Game::render() {
-	// === 3D RENDERING ===
-	glEnable(GL_DEPTH_TEST);
-	glDepthMask(GL_TRUE);
-	glDisable(GL_CULL_FACE);
-	glDisable(GL_BLEND);
-
-	m_renderer->clear();
-
-	// Pass flashlight state to renderer
-	m_renderer->beginFrameWithFlashlight(
-		m_player->getCamera(),
-		m_maze->getExitPosition(),
-		m_totalTime,
-		m_flashlight->isOn(),
-		m_flashlight->getIntensity(m_totalTime)
-	);
-
-	auto identityMatrix = createIdentityMatrix();
-
-	m_renderer->renderMesh(*m_floorMesh, *m_floorTexture, identityMatrix.data());
-	m_renderer->renderMesh(*m_wallMesh, *m_wallTexture, identityMatrix.data());
-	m_renderer->renderMesh(*m_ceilingMesh, *m_ceilingTexture, identityMatrix.data());
-
-	// Render collectibles
-	renderCollectibles();
-
-	// Render teleport portal
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-	glDepthMask(GL_FALSE);
-
-	m_teleportShader->use();
+void Game::buildSnapshot(FrameSnapshot& frame) {
+	// The slot holds an older frame; every field is overwritten
+	frame.frameNumber = m_frameNumber++;
+
+	// Position and time are blended between the last two ticks; the view
+	// direction is already current since mouse look runs every frame
+	const float alpha = m_interpolation;
+	frame.time = m_previousTotalTime + (m_totalTime - m_previousTotalTime) * alpha;
+
+	frame.camera = m_player->getCamera();
+	Vector3 eye = frame.camera.getPosition();
+	frame.camera.setPosition(m_previousEyePosition + (eye - m_previousEyePosition) * alpha);
+	frame.flashlightOn = m_flashlight->isOn();
+	frame.flashlightIntensity = m_flashlight->getIntensity(m_totalTime);
+
+	// clear() keeps the capacity, so steady-state frames do not allocate
+	frame.orbs.clear();
+	frame.orbBounds.clear();
+	for (const Collectible& collectible : m_collectibleManager->getCollectibles()) {
+		if (collectible.isCollected()) continue;
+		frame.orbs.push_back(collectible);
+		frame.orbBounds.push_back(collectible.getBounds());
+	}
 
-	Camera& cam = m_player->getCamera();
-	auto view = cam.getViewMatrix();
-	auto proj = cam.getProjectionMatrix(60.0f, m_renderer->getAspectRatio(), 0.1f, 100.0f);
+	frame.levelTime = m_levelTime;
+	Vector3 position = m_player->getPosition();
+	frame.playerPosition = m_previousPlayerPosition + (position - m_previousPlayerPosition) * alpha;
+	frame.collectedCount = m_collectibleManager->getCollectedCount();
+	frame.totalCount = m_collectibleManager->getTotalCount();
+	frame.batteryPercent = m_flashlight->getBatteryPercent();
+	frame.lowBattery = m_flashlight->isLowBattery();
+	frame.flashColor = m_screenFlash->getColor();
+	frame.won = m_gameState == WON;
+}
 
-	m_teleportShader->setUniformMatrix4fv("view", view.data());
-	m_teleportShader->setUniformMatrix4fv("projection", proj.data());
-	m_teleportShader->setUniformMatrix4fv("model", identityMatrix.data());
-	m_teleportShader->setUniform("u_time", m_totalTime);
+void Game::renderCurrentState() {
+	buildSnapshot(m_snapshots.writeSlot());
+	m_snapshots.publish();
+	m_snapshots.acquire();
+	render(m_snapshots.readSlot());
+}
 
-	Vector3 portalCenter = m_maze->getExitPosition();
-	m_teleportShader->setUniform("u_portalCenter", portalCenter);
+void Game::render(const FrameSnapshot& frame) {
+	// Lights are not culled with their orbs: one behind a corner still lights the corner
+	m_orbLights.clear();
+	for (const Collectible& orb : frame.orbs) {
+		PointLight light;
+		light.position = orb.getPosition();
+		light.radius = kOrbLightRadius;
+		light.color = kOrbLightColor * orb.getPulse();
+		m_orbLights.push_back(light);
+	}
+	setLights(m_orbLights);
+
+	SceneCommand scene;
+	scene.eye = frame.camera.getPosition();
+	scene.yaw = frame.camera.getYaw();
+	scene.pitch = frame.camera.getPitch();
+	scene.time = frame.time;
+	scene.flashlightIntensity = frame.flashlightIntensity;
+	scene.flashlightOn = frame.flashlightOn ? 1u : 0u;
+	beginScene(scene);
+
+	// Floor, walls and ceiling of the visible chunks in a single draw
+	Frustum frustum = frame.camera.getFrustum(60.0f, m_renderer->getAspectRatio(), 0.1f, 100.0f);
+	frustum.cullAABBs(m_chunkBounds.data(), m_chunkBounds.size(), m_chunkVisible.data());
+
+	// Front to back, so nearer walls fill the depth buffer before the ones
+	// they hide and those fail the depth test before shading
+	const Vector3 eye = scene.eye;
+	m_visibleChunkIndices.clear();
+	for (size_t i = 0; i < m_mazeChunks.size(); ++i) {
+		if (m_chunkVisible[i]) {
+			const AABB& box = m_chunkBounds[i];
+			float dx = std::max(std::max(box.min.x - eye.x, eye.x - box.max.x), 0.0f);
+			float dy = std::max(std::max(box.min.y - eye.y, eye.y - box.max.y), 0.0f);
+			float dz = std::max(std::max(box.min.z - eye.z, eye.z - box.max.z), 0.0f);
+			m_chunkDistances[i] = dx * dx + dy * dy + dz * dz;
+			m_visibleChunkIndices.push_back(static_cast<unsigned int>(i));
+		}
+	}
+	std::sort(m_visibleChunkIndices.begin(), m_visibleChunkIndices.end(),
+		[this](unsigned int a, unsigned int b) { return m_chunkDistances[a] < m_chunkDistances[b]; });
+	drawChunks(m_visibleChunkIndices);
+
+	// Collectibles, skipping orbs outside the view frustum
+	m_orbVisible.resize(frame.orbBounds.size());
+	frustum.cullAABBs(frame.orbBounds.data(), frame.orbBounds.size(), m_orbVisible.data());
+
+	m_visibleOrbs.clear();
+	for (size_t i = 0; i < frame.orbs.size(); ++i) {
+		if (m_orbVisible[i]) {
+			OrbDraw orb;
+			orb.position = frame.orbs[i].getPosition();
+			orb.rotation = frame.orbs[i].getRotation();
+			orb.pulse = frame.orbs[i].getPulse();
+			m_visibleOrbs.push_back(orb);
+		}
+	}
+	drawOrbs(frame.time, m_visibleOrbs);
 
-	m_teleportShader->setUniform("textureSampler", 0);
+	// The portal only when on screen
+	if (frustum.intersectsAABB(m_maze->getTeleportBounds())) {
+		drawPortal(frame.time);
+	}
+	endScene();
 
-	m_teleportMesh->draw();
+	if (!m_window) {
+		m_gpuProfiler->endFrame();
+		return;  // Headless: no HUD and nothing to present
+	}
 
 	// === RESET OPENGL STATE FOR UI ===
-	glUseProgram(0);
-	glBindVertexArray(0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-	glBindTexture(GL_TEXTURE_2D, 0);
-
-	glDisable(GL_DEPTH_TEST);
-	glDepthMask(GL_TRUE);
-	glDisable(GL_BLEND);
+	// No element buffer unbind: it belongs to the vertex array, now 0
+	GLStateCache& state = GLStateCache::get();
+	state.restoreDefaults();
 
 	// === 2D UI RENDERING ===
+	int hudPass = m_gpuProfiler->beginPass("HUD");
 	m_window->pushGLStates();
 
+	m_ui->update(frame.levelTime, frame.playerPosition);
+	m_ui->updateCollectiblePositions(frame.orbs);
 	m_ui->draw(*m_window);
 	m_ui->drawCollectibleCounter(
 		*m_window,
-		m_collectibleManager->getCollectedCount(),
-		m_collectibleManager->getTotalCount()
+		frame.collectedCount,
+		frame.totalCount
 	);
 
 	// Draw battery indicator
 	m_ui->drawBatteryIndicator(
 		*m_window,
-		m_flashlight->getBatteryPercent(),
-		m_flashlight->isLowBattery()
+		frame.batteryPercent,
+		frame.lowBattery
 	);
 
 	// === NEW: DRAW SCREEN FLASH (must be last, on top of everything) ===
-	m_screenFlash->draw(*m_window);
+	ScreenFlashEffect::draw(*m_window, frame.flashColor);
 
-	if (m_gameState == WON) {
+	if (frame.won) {
 		m_ui->drawWinScreen(*m_window);
 	}
 
 	m_window->popGLStates();
+	state.invalidate();  // SFML changed state the cache does not see
+	m_gpuProfiler->endPass(hudPass);
 
+	// Close the frame before display(), which may block on the swap
+	m_gpuProfiler->endFrame();
 	m_window->display();
+
+	if (frame.frameNumber == 0) {
+		std::cout << "First frame after " << m_startupClock.getElapsedTime().asMilliseconds()
+			<< " ms" << std::endl;
+	}
+}
+
+void Game::setLights(const std::vector<PointLight>& lights) {
+	if (m_recorder) {
+		m_recorder->setLights(lights);
+	}
+	m_renderer->setPointLights(lights);
+}
+
+void Game::beginScene(const SceneCommand& scene) {
+	// Finish any texture uploads whose data is ready (never waits on workers)
+	m_textureLoader->update();
+
+	GLStateCache& state = GLStateCache::get();
+	state.beginFrame();
+	MAZE_GL_TRACE_FRAME();
+	if (m_logGpuTimings.exchange(false)) {
+		m_gpuProfiler->logSummary();
+		state.logSummary();
+		MAZE_GL_TRACE_LOG();
+	}
+	m_gpuProfiler->beginFrame();
+
+	if (m_recorder) {
+		m_recorder->beginFrame(scene);
+	}
+	m_scene = scene;
+
+	// === 3D RENDERING ===
+	state.setEnabled(GL_DEPTH_TEST, true);
+	state.depthMask(true);
+	state.setEnabled(GL_CULL_FACE, true);
+	state.cullFace(GL_BACK);
+	state.setEnabled(GL_BLEND, false);
+
+	// 3D goes to the scaled offscreen target; the HUD stays at native resolution
+	m_renderer->beginScene();
+	m_renderer->clear();
+
+	// Pass flashlight state to renderer
+	m_renderer->beginFrameWithFlashlight(
+		Camera(scene.eye, scene.yaw, scene.pitch),
+		m_maze->getExitPosition(),
+		scene.time,
+		scene.flashlightOn != 0,
+		scene.flashlightIntensity
+	);
+}
+
+void Game::drawChunks(const std::vector<unsigned int>& indices) {
+	if (m_recorder) {
+		m_recorder->drawChunks(indices);
+	}
+
+	m_visibleChunks.clear();
+	for (unsigned int index : indices) {
+		if (index < m_mazeChunks.size()) {
+			m_visibleChunks.push_back(&m_mazeChunks[index].mesh);
+		}
+	}
+
+	GpuProfiler::Scope pass(m_gpuProfiler.get(), "Walls");
+	auto identityMatrix = createIdentityMatrix();
+	m_renderer->renderMeshBatch(m_visibleChunks, *m_materials, identityMatrix.data());
 }
 
-void Game::renderCollectibles() {
+void Game::drawOrbs(float time, const std::vector<OrbDraw>& orbs) {
+	if (m_recorder) {
+		m_recorder->drawOrbs(time, orbs);
+	}
 	if (!m_collectibleShader || !m_collectibleMesh) return;
 
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-	glDepthMask(GL_FALSE);
+	GpuProfiler::Scope pass(m_gpuProfiler.get(), "Collectibles");
+	GLStateCache& state = GLStateCache::get();
+	state.setEnabled(GL_CULL_FACE, false);  // Glow volumes: the far side adds light too
+	state.setEnabled(GL_BLEND, true);
+	state.blendFunc(GL_SRC_ALPHA, GL_ONE);
+	state.depthMask(false);
 
 	m_collectibleShader->use();
+	m_collectibleShader->setUniform("u_time", time);
+
+	// Transforms go straight into the streaming buffer; one instanced draw per block
+	const size_t blockSize = kMaxCollectibleInstances * sizeof(CollectibleInstance);
+	for (size_t first = 0; first < orbs.size(); first += kMaxCollectibleInstances) {
+		size_t count = std::min(orbs.size() - first, static_cast<size_t>(kMaxCollectibleInstances));
+
+		CollectibleInstance* instances = static_cast<CollectibleInstance*>(
+			m_renderer->beginBlockData(UNIFORM_BLOCK_COLLECTIBLE_INSTANCES, blockSize));
+		if (!instances) break;
+
+		for (size_t i = 0; i < count; ++i) {
+			const OrbDraw& orb = orbs[first + i];
+			auto modelMatrix = createCollectibleMatrix(orb.position, orb.rotation, orb.pulse);
+
+			std::memcpy(instances[i].model, modelMatrix.data(), sizeof(instances[i].model));
+			instances[i].params[0] = orb.pulse;
+			instances[i].params[1] = 0.0f;
+			instances[i].params[2] = 0.0f;
+			instances[i].params[3] = 0.0f;
+		}
+		m_renderer->endBlockData();
 
-	Camera& cam = m_player->getCamera();
-	auto view = cam.getViewMatrix();
-	auto proj = cam.getProjectionMatrix(60.0f, m_renderer->getAspectRatio(), 0.1f, 100.0f);
+		m_collectibleMesh->drawInstanced(static_cast<int>(count));
+	}
 
-	m_collectibleShader->setUniformMatrix4fv("view", view.data());
-	m_collectibleShader->setUniformMatrix4fv("projection", proj.data());
-	m_collectibleShader->setUniform("u_time", m_totalTime);
+	state.depthMask(true);
+	state.setEnabled(GL_BLEND, false);
+	state.setEnabled(GL_CULL_FACE, true);
+}
 
-	for (const auto& collectible : m_collectibleManager->getCollectibles()) {
-		if (collectible.isCollected()) continue;
+void Game::drawPortal(float time) {
+	if (m_recorder) {
+		m_recorder->drawPortal(time);
+	}
 
-		Vector3 pos = collectible.getPosition();
-		float rotation = collectible.getRotation();
-		float pulse = collectible.getPulse();
+	GpuProfiler::Scope pass(m_gpuProfiler.get(), "Portal");
 
-		auto modelMatrix = createCollectibleMatrix(pos, rotation, pulse);
+	// Additive and soft, so half resolution hardly shows. Only worth its fixed
+	// cost (depth downsample, fullscreen upsample) when the portal is large
+	Vector3 portalCenter = m_maze->getExitPosition();
+	float dx = m_scene.eye.x - portalCenter.x;
+	float dz = m_scene.eye.z - portalCenter.z;
+	bool halfResolution = dx * dx + dz * dz < kPortalHalfResolutionDistance * kPortalHalfResolutionDistance &&
+		m_renderer->beginHalfResolutionPass();
+
+	GLStateCache& state = GLStateCache::get();
+	state.setEnabled(GL_CULL_FACE, false);  // Both sides of the cylinder glow
+	state.setEnabled(GL_BLEND, true);
+	state.blendFunc(GL_SRC_ALPHA, GL_ONE);
+	state.depthMask(false);
+
+	// View and projection come from the FrameData block
+	auto identityMatrix = createIdentityMatrix();
+	m_teleportShader->use();
+	m_teleportShader->setUniformMatrix4fv("model", identityMatrix.data());
+	m_teleportShader->setUniform("u_time", time);
+
+	m_teleportShader->setUniform("u_portalCenter", portalCenter);
 
-		m_collectibleShader->setUniformMatrix4fv("model", modelMatrix.data());
-		m_collectibleShader->setUniform("u_pulse", pulse);
+	m_portalNoise->bind(0);
+	m_teleportShader->setUniform("u_noise", 0);
+
+	m_teleportMesh->draw();
+
+	if (halfResolution) {
+		m_renderer->endHalfResolutionPass();
+	}
+}
 
-		m_collectibleMesh->draw();
+void Game::endScene() {
+	if (m_recorder) {
+		m_recorder->endFrame();
 	}
 
-	glDepthMask(GL_TRUE);
-	glDisable(GL_BLEND);
+	m_renderer->endFrame();
+	GpuProfiler::Scope pass(m_gpuProfiler.get(), "Upscale");
+	m_renderer->endScene();
 }
 
-std::array<float, 16> Game::createIdentityMatrix() const {
-	return {
-		1.0f, 0.0f, 0.0f, 0.0f,
-		0.0f, 1.0f, 0.0f, 0.0f,
-		0.0f, 0.0f, 1.0f, 0.0f,
-		0.0f, 0.0f, 0.0f, 1.0f
-	};
+Mat4 Game::createIdentityMatrix() const {
+	return Mat4::identity();
 }
 
-std::array<float, 16> Game::createCollectibleMatrix(const Vector3& position, float rotationY, float scale) const {
-	float rad = rotationY * 3.14159 / 180.0f;
-	float cosY = std::cos(rad);
-	float sinY = std::sin(rad);
-
-	return {
-		scale * cosY, 0.0f, scale * sinY, 0.0f,
-		0.0f, scale, 0.0f, 0.0f,
-		scale * -sinY, 0.0f, scale * cosY, 0.0f,
-		position.x, position.y, position.z, 1.0f
-	};
+Mat4 Game::createCollectibleMatrix(const Vector3& position, float rotationY, float scale) const {
+	float rad = rotationY * 3.14159f / 180.0f;
+
+	// Orbs spin clockwise when viewed from above, hence the negated angle
+	return Mat4::translation(position) * Mat4::rotationY(-rad) * Mat4::scale(scale);
 }
 
 void Game::checkWinCondition() {
@@ -457,8 +1201,10 @@ void Game::checkWinCondition() {
 	if (distSq < (1.5f * 1.5f)) {
 		m_gameState = WON;
 
-		m_window->setMouseCursorVisible(true);
-		m_window->setMouseCursorGrabbed(false);
+		if (m_window) {
+			m_window->setMouseCursorVisible(true);
+			m_window->setMouseCursorGrabbed(false);
+		}
 
 		m_audioManager->playSound("win", 100.0f);
 
@@ -474,8 +1220,13 @@ void Game::resetGame() {
 	Vector3 startPos = m_maze->getStartPosition();
 	m_player->setPosition(startPos);
 
-	m_ui->resetTimer();
-	m_collectibleManager->initialize(*m_maze);
+	// A teleport, not movement: nothing to interpolate from
+	m_previousEyePosition = m_player->getCamera().getPosition();
+	m_previousPlayerPosition = m_player->getPosition();
+
+	m_levelTime = 0.0f;
+	// A fresh run places the collectibles differently each time
+	m_collectibleManager->initialize(*m_maze, static_cast<unsigned int>(std::time(nullptr)));
 
 	// Reset flashlight and screen flash
 	m_flashlight = std::make_unique<FlashlightSystem>();
@@ -522,13 +1273,14 @@ void Game::generateSphereMesh(Mesh& mesh, float radius, int segments, int rings)
 			int current = ring * (segments + 1) + seg;
 			int next = current + segments + 1;
 
+			// CCW seen from outside
 			indices.push_back(current);
-			indices.push_back(next);
 			indices.push_back(current + 1);
+			indices.push_back(next);
 
 			indices.push_back(current + 1);
-			indices.push_back(next);
 			indices.push_back(next + 1);
+			indices.push_back(next);
 		}
 	}
 
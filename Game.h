@@ -1,19 +1,62 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <SFML/Window.hpp>
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include "Renderer.h"
 #include "Maze.h"
 #include "Player.h"
 #include "InputHandler.h"
 #include "Mesh.h"
 #include "Texture.h"
+#include "TextureArray.h"
+#include "ThreadPool.h"
+#include "AsyncTextureLoader.h"
+#include "GpuProfiler.h"
+#include "HeadlessContext.h"
 #include "ShaderProgram.h"
 #include "GameUI.h"
 #include "AudioManager.h"
 #include "Collectible.h"
 #include "FlashlightSystem.h"
 #include "ScreenFlashEffect.h"  // NEW
+#include "FrameSnapshot.h"
+#include "RenderRecording.h"
+#include "TripleBuffer.h"
+#include <string>
+#include <vector>
+
+/**
+ * @brief Settings for a windowless run (`3D-Maze --headless`)
+ */
+struct HeadlessOptions {
+    int width = 1280;
+    int height = 720;
+    int frames = 600;                // Simulated at a fixed 60 Hz
+    unsigned int seed = 1;           // Maze and collectible layout
+    bool dynamicResolution = false;  // Off by default so captures are reproducible
+    bool software = false;           // CPU raycaster instead of OpenGL (no context at all)
+    bool lightGrid = false;          // Point lights from a LightGrid instead of per pixel
+    std::vector<int> captureFrames;  // Frame numbers written as PNGs
+    std::string outputDirectory = ".";
+    std::string statsPath;           // Per-frame CSV, if set
+    std::string recordPath;          // Render command recording, if set
+};
+
+/**
+ * @brief Settings for replaying a render recording (`3D-Maze --replay`)
+ */
+struct ReplayOptions {
+    int loops = 1;                   // Times the whole recording is played
+    bool nullBackend = false;        // Submit everything but rasterize nothing
+    bool depthPrepass = true;        // Lay down depth before shading the maze
+    bool lightmap = true;            // Baked static light (off: lit per fragment)
+    bool lightGrid = false;          // Point lights from a LightGrid instead of per pixel
+    std::string statsPath;           // Per-frame CSV, if set
+};
 
 class Game {
 public:
@@ -21,6 +64,60 @@ public:
     bool initialize();
     void run();
 
+    /**
+     * @brief Simulate and render on separate threads (set before run())
+     *
+     * The main thread handles input and simulates frame N+1 while a render
+     * thread, which owns the GL context, draws and presents frame N. They
+     * share nothing but FrameSnapshots passed through a TripleBuffer; the
+     * simulation runs at most one frame ahead.
+     */
+    void setPipelined(bool enabled) { m_pipelined = enabled; }
+
+    /**
+     * @brief Light the portal, orbs and flashlight spill from a LightGrid (set after initialize())
+     */
+    void setLightGridEnabled(bool enabled);
+
+    /**
+     * @brief Render into an offscreen context instead of a window
+     *
+     * The camera follows the maze's solution path; no input, HUD or window
+     * is involved.
+     */
+    bool initializeHeadless(const HeadlessOptions& options);
+
+    /**
+     * @brief Render the configured frames and print frame-time statistics
+     * @return Process exit code
+     */
+    int runHeadless();
+
+    /**
+     * @brief Headless run through SoftwareRenderer; needs no GL context
+     *
+     * Same maze, path and outputs as runHeadless, but only walls, floor and
+     * ceiling are drawn (no collectibles or portal).
+     */
+    static int runSoftware(const HeadlessOptions& options);
+
+    /**
+     * @brief Write every rendered frame's commands to a file (set before initializing)
+     *
+     * See RenderRecording. Works in windowed, pipelined and headless runs.
+     */
+    void setRecordPath(const std::string& path) { m_recordPath = path; }
+
+    /**
+     * @brief Play a recording through the renderer as fast as it goes
+     *
+     * Call after initializeHeadless() with the recording's seed and size, so
+     * the chunk indices refer to the same meshes. Prints submission time
+     * (CPU, without waiting for the GPU), throughput and GPU pass timings.
+     * @return Process exit code
+     */
+    int runReplay(RenderRecording& recording, const ReplayOptions& options);
+
 private:
     // Initialization
     bool createWindow();
@@ -28,8 +125,15 @@ private:
 
     // Game Loop
     void processInput();
-    void update();
-    void render();
+    void advanceSimulation(float frameTime);  // Runs as many fixed ticks as are due
+    void update();                            // One tick of kSimulationStep
+    void buildSnapshot(FrameSnapshot& frame);
+    void render(const FrameSnapshot& frame);
+    void renderCurrentState();  // Snapshot and render on this thread
+
+    // Pipelined mode (setPipelined)
+    void runPipelined();
+    void renderThreadMain();
 
     // Input Handling
     void handleMovement();
@@ -39,33 +143,48 @@ private:
     void checkWinCondition();
     void resetGame();
 
-    // Rendering
-    void renderCollectibles();
+    // Rendering. render() culls and turns the snapshot into these calls;
+    // runReplay() makes the same calls from a recording
+    void setLights(const std::vector<PointLight>& lights);
+    void beginScene(const SceneCommand& scene);
+    void drawChunks(const std::vector<unsigned int>& indices);
+    void drawOrbs(float time, const std::vector<OrbDraw>& orbs);
+    void drawPortal(float time);
+    void endScene();
 
     // Utilities
-    std::array<float, 16> createIdentityMatrix() const;
-    std::array<float, 16> createCollectibleMatrix(const Vector3& position, float rotationY, float scale = 1.0f) const;
+    Mat4 createIdentityMatrix() const;
+    Mat4 createCollectibleMatrix(const Vector3& position, float rotationY, float scale = 1.0f) const;
     void generateSphereMesh(Mesh& mesh, float radius, int segments, int rings);
 
     // Window & Rendering
-    std::unique_ptr<sf::RenderWindow> m_window;
+    std::unique_ptr<sf::RenderWindow> m_window;  // Null when running headless
+    std::unique_ptr<HeadlessContext> m_headlessContext;
+    HeadlessOptions m_headlessOptions;
     std::unique_ptr<Renderer> m_renderer;
+    std::unique_ptr<GpuProfiler> m_gpuProfiler;  // Per-pass GPU timings, F3 logs them
 
     // Game World
     std::unique_ptr<Maze> m_maze;
     std::unique_ptr<Player> m_player;
 
     // Meshes
-    std::unique_ptr<Mesh> m_wallMesh;
-    std::unique_ptr<Mesh> m_floorMesh;
-    std::unique_ptr<Mesh> m_ceilingMesh;
+    std::vector<MazeChunk> m_mazeChunks;  // Walls, floor and ceiling, one material layer per vertex
     std::unique_ptr<Mesh> m_teleportMesh;
     std::unique_ptr<Mesh> m_collectibleMesh;
 
-    // Textures
-    std::unique_ptr<Texture> m_wallTexture;
-    std::unique_ptr<Texture> m_floorTexture;
-    std::unique_ptr<Texture> m_ceilingTexture;
+    // Textures (the pool is declared first so it outlives the loader)
+    std::unique_ptr<ThreadPool> m_threadPool;
+    std::unique_ptr<AsyncTextureLoader> m_textureLoader;
+    std::unique_ptr<Texture> m_portalNoise;  // Tileable fBm sampled by the portal shader
+    std::shared_ptr<TextureArray> m_materials;
+
+    // Chunk culling scratch, reused every frame
+    std::vector<AABB> m_chunkBounds;
+    std::vector<unsigned char> m_chunkVisible;
+    std::vector<float> m_chunkDistances;  // Squared, eye to nearest point; sort keys
+    std::vector<unsigned int> m_visibleChunkIndices;
+    std::vector<const Mesh*> m_visibleChunks;
 
     // Shaders
     std::unique_ptr<ShaderProgram> m_teleportShader;
@@ -79,14 +198,48 @@ private:
     std::unique_ptr<FlashlightSystem> m_flashlight;
     std::unique_ptr<ScreenFlashEffect> m_screenFlash;  // NEW
 
-    // Timing
+    // Per-frame scratch list of orbs that survived frustum culling
+    std::vector<unsigned char> m_orbVisible;
+    std::vector<OrbDraw> m_visibleOrbs;
+    std::vector<PointLight> m_orbLights;  // Every uncollected orb, visible or not
+    SceneCommand m_scene{};  // Inputs of the frame being drawn, set by beginScene()
+
+    // Render command recording (setRecordPath)
+    std::string m_recordPath;
+    std::unique_ptr<RenderRecorder> m_recorder;
+
+    // Simulation -> render hand-over. The mutex and condition variable only
+    // pace the two threads; snapshots are written and read outside the lock.
+    TripleBuffer<FrameSnapshot> m_snapshots;
+    bool m_pipelined = false;
+    std::thread m_renderThread;
+    std::mutex m_frameMutex;
+    std::condition_variable m_frameSignal;
+    unsigned long long m_publishedFrames = 0;  // Guarded by m_frameMutex
+    unsigned long long m_acquiredFrames = 0;   // Guarded by m_frameMutex
+    bool m_stopRendering = false;              // Guarded by m_frameMutex
+    std::atomic<bool> m_logGpuTimings{ false };  // F3, handled by whichever thread renders
+    unsigned long long m_frameNumber = 0;
+
+    // Timing: the simulation ticks at a fixed rate whatever the display does,
+    // and each rendered frame interpolates between the last two ticks
+    static constexpr float kSimulationStep = 1.0f / 120.0f;
+    static constexpr float kMaxFrameTime = 0.25f;  // Longer frames slow the game down instead
     sf::Clock m_clock;
-    float m_deltaTime;
+    sf::Clock m_startupClock;  // Runs from construction, for time-to-first-frame
+    float m_deltaTime;   // Always kSimulationStep inside update()
     float m_totalTime;
     float m_walkTime;
+    float m_levelTime;  // HUD timer, stops once the maze is solved
+    double m_accumulator;       // Frame time not yet simulated
+    float m_interpolation;      // m_accumulator in ticks, [0, 1)
+    Vector3 m_previousEyePosition;     // State before the last tick, for interpolation
+    Vector3 m_previousPlayerPosition;
+    float m_previousTotalTime;
 
     // Game State
     enum GameState { PLAYING, WON };
     GameState m_gameState = PLAYING;
     bool m_batteryWarningShown = false;
+    bool m_quitRequested = false;  // Exit button on the win screen
 };
\ No newline at end of file
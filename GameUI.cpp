@@ -5,7 +5,7 @@
 #include <iostream>
 #include <cmath>
 
-GameUI::GameUI() : m_elapsedTime(0.0f), m_minimapScale(10.0f) {}
+GameUI::GameUI() : m_minimapScale(10.0f) {}
 
 bool GameUI::initialize(const Maze& maze) {
     // 1. Load Font
@@ -105,25 +105,18 @@ bool GameUI::initialize(const Maze& maze) {
     return true;
 }
 
-void GameUI::update(float deltaTime, const Player& player, const Maze& maze) {
-    m_elapsedTime += deltaTime;
-
-    int minutes = static_cast<int>(m_elapsedTime) / 60;
-    int seconds = static_cast<int>(m_elapsedTime) % 60;
-    int milliseconds = static_cast<int>((m_elapsedTime - static_cast<int>(m_elapsedTime)) * 100);
+void GameUI::update(float levelTime, const Vector3& playerPosition) {
+    int minutes = static_cast<int>(levelTime) / 60;
+    int seconds = static_cast<int>(levelTime) % 60;
+    int milliseconds = static_cast<int>((levelTime - static_cast<int>(levelTime)) * 100);
 
     std::stringstream ss;
     ss << "Time: " << std::setfill('0') << std::setw(2) << minutes << ":"
         << std::setw(2) << seconds << "." << std::setw(2) << milliseconds;
     m_timerText.setString(ss.str());
 
-    Vector3 pos = player.getPosition();
-    m_playerGridPos.x = pos.x / 2.0f;
-    m_playerGridPos.y = pos.z / 2.0f;
-}
-
-void GameUI::resetTimer() {
-    m_elapsedTime = 0.0f;
+    m_playerGridPos.x = playerPosition.x / 2.0f;
+    m_playerGridPos.y = playerPosition.z / 2.0f;
 }
 
 void GameUI::updateCollectiblePositions(const std::vector<class Collectible>& collectibles) {
@@ -307,7 +300,7 @@ void GameUI::drawWinScreen(sf::RenderWindow& window) {
     m_winText.setPosition(centerX, centerY - 150);
     window.draw(m_winText);
 
-    m_restartButton.setPosition(centerX - 100, centerY - 25);
+    m_restartButton.setPosition(restartButtonPosition(size));
     window.draw(m_restartButton);
 
     sf::FloatRect rTextRect = m_restartText.getLocalBounds();
@@ -315,7 +308,7 @@ void GameUI::drawWinScreen(sf::RenderWindow& window) {
     m_restartText.setPosition(centerX, centerY);
     window.draw(m_restartText);
 
-    m_exitButton.setPosition(centerX - 100, centerY + 50);
+    m_exitButton.setPosition(exitButtonPosition(size));
     window.draw(m_exitButton);
 
     sf::FloatRect eTextRect = m_exitText.getLocalBounds();
@@ -324,14 +317,29 @@ void GameUI::drawWinScreen(sf::RenderWindow& window) {
     window.draw(m_exitText);
 }
 
-int GameUI::checkButtonPress(int mouseX, int mouseY) {
+sf::Vector2f GameUI::restartButtonPosition(const sf::Vector2u& windowSize) {
+    return sf::Vector2f(windowSize.x / 2.0f - 100, windowSize.y / 2.0f - 25);
+}
+
+sf::Vector2f GameUI::exitButtonPosition(const sf::Vector2u& windowSize) {
+    return sf::Vector2f(windowSize.x / 2.0f - 100, windowSize.y / 2.0f + 50);
+}
+
+int GameUI::checkButtonPress(int mouseX, int mouseY, const sf::Vector2u& windowSize) const {
     sf::Vector2f mousePos(static_cast<float>(mouseX), static_cast<float>(mouseY));
 
-    if (m_restartButton.getGlobalBounds().contains(mousePos)) {
+    // Same area getGlobalBounds() reports: the outline grows the box on every side
+    auto bounds = [](const sf::RectangleShape& button, const sf::Vector2f& position) {
+        float outline = button.getOutlineThickness();
+        sf::Vector2f size = button.getSize();
+        return sf::FloatRect(position.x - outline, position.y - outline, size.x + 2 * outline, size.y + 2 * outline);
+    };
+
+    if (bounds(m_restartButton, restartButtonPosition(windowSize)).contains(mousePos)) {
         return 1;
     }
-    if (m_exitButton.getGlobalBounds().contains(mousePos)) {
+    if (bounds(m_exitButton, exitButtonPosition(windowSize)).contains(mousePos)) {
         return 2;
     }
     return 0;
-}
\ No newline at end of file
+}
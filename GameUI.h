@@ -15,7 +15,8 @@ public:
     GameUI();
 
     bool initialize(const Maze& maze);
-    void update(float deltaTime, const Player& player, const Maze& maze);
+    // Timer text and minimap dot; the level time is kept by the simulation
+    void update(float levelTime, const Vector3& playerPosition);
     void draw(sf::RenderWindow& window);
     void drawWinScreen(sf::RenderWindow& window);
     void drawCollectibleCounter(sf::RenderWindow& window, int collected, int total);
@@ -24,8 +25,10 @@ public:
     // Update collectible positions for minimap glow
     void updateCollectiblePositions(const std::vector<Collectible>& collectibles);
 
-    int checkButtonPress(int mouseX, int mouseY);
-    void resetTimer();
+    // Win screen button under the mouse (1 = restart, 2 = exit, 0 = none).
+    // Uses the same layout as drawWinScreen, not its last draw, so it is
+    // safe to call from the input thread while another thread draws.
+    int checkButtonPress(int mouseX, int mouseY, const sf::Vector2u& windowSize) const;
 
 private:
     // Font
@@ -33,7 +36,6 @@ private:
 
     // Timer
     sf::Text m_timerText;
-    float m_elapsedTime;
 
     // Minimap
     sf::RectangleShape m_minimapBackground;
@@ -59,6 +61,10 @@ private:
     sf::RectangleShape m_exitButton;
     sf::Text m_exitText;
 
+    // Top-left corner of the win screen buttons for a window size
+    static sf::Vector2f restartButtonPosition(const sf::Vector2u& windowSize);
+    static sf::Vector2f exitButtonPosition(const sf::Vector2u& windowSize);
+
     // NEW: Battery indicator
     sf::RectangleShape m_batteryBackground;
     sf::RectangleShape m_batteryFill;
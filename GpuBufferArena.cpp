@@ -0,0 +1,209 @@
+#include "GpuBufferArena.h"
+#include "GLTrace.h"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <iostream>
+
+GpuBufferArena* GpuBufferArena::s_default = nullptr;
+
+// =====================================================
+// RangeList
+// =====================================================
+
+bool GpuBufferArena::RangeList::allocate(unsigned int count, unsigned int& offset) {
+    for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it) {
+        if (it->second < count) {
+            continue;
+        }
+
+        offset = it->first;
+        unsigned int remaining = it->second - count;
+        freeRanges.erase(it);
+        if (remaining > 0) {
+            freeRanges[offset + count] = remaining;
+        }
+        used += count;
+        return true;
+    }
+    return false;
+}
+
+void GpuBufferArena::RangeList::release(unsigned int offset, unsigned int count) {
+    used -= std::min(used, count);
+    auto next = freeRanges.lower_bound(offset);
+
+    // Merge with the following range
+    if (next != freeRanges.end() && offset + count == next->first) {
+        count += next->second;
+        next = freeRanges.erase(next);
+    }
+
+    // Merge with the preceding range
+    if (next != freeRanges.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            prev->second += count;
+            return;
+        }
+    }
+
+    freeRanges[offset] = count;
+}
+
+void GpuBufferArena::RangeList::grow(unsigned int newCapacity) {
+    unsigned int added = newCapacity - capacity;
+    unsigned int oldCapacity = capacity;
+    capacity = newCapacity;
+
+    // The new tail is free; release() merges it with a free range at the end
+    used += added;
+    release(oldCapacity, added);
+}
+
+// =====================================================
+// GpuBufferArena
+// =====================================================
+
+GpuBufferArena::GpuBufferArena(unsigned int vertexCapacity, unsigned int indexCapacity)
+    : m_vao(0), m_vbo(0), m_ebo(0) {
+    m_vertices.grow(std::max(vertexCapacity, 1u));
+    m_indices.grow(std::max(indexCapacity, 1u));
+
+    glGenVertexArrays(1, &m_vao);
+    GLStateCache::get().bindVertexArray(m_vao);
+
+    m_vbo = createBuffer(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_vertices.capacity) * sizeof(Vertex));
+    m_ebo = createBuffer(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_indices.capacity) * sizeof(unsigned int));
+    setupVertexAttributes();
+
+    GLStateCache::get().bindVertexArray(0);
+}
+
+GpuBufferArena::~GpuBufferArena() {
+    if (s_default == this) {
+        s_default = nullptr;
+    }
+    if (m_ebo != 0) GLStateCache::get().deleteBuffer(m_ebo);
+    if (m_vbo != 0) GLStateCache::get().deleteBuffer(m_vbo);
+    if (m_vao != 0) GLStateCache::get().deleteVertexArray(m_vao);
+}
+
+bool GpuBufferArena::allocate(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, Allocation& out) {
+    if (vertices.empty() || indices.empty()) {
+        return false;
+    }
+
+    unsigned int vertexCount = static_cast<unsigned int>(vertices.size());
+    unsigned int indexCount = static_cast<unsigned int>(indices.size());
+
+    if (!m_vertices.allocate(vertexCount, out.baseVertex)) {
+        growVertices(m_vertices.capacity + vertexCount);
+        m_vertices.allocate(vertexCount, out.baseVertex);
+    }
+    if (!m_indices.allocate(indexCount, out.firstIndex)) {
+        growIndices(m_indices.capacity + indexCount);
+        m_indices.allocate(indexCount, out.firstIndex);
+    }
+    out.vertexCount = vertexCount;
+    out.indexCount = indexCount;
+
+    GLStateCache::get().bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    MAZE_GL_TRACE_UPLOAD(vertexCount * sizeof(Vertex));
+    glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(out.baseVertex) * sizeof(Vertex),
+        vertexCount * sizeof(Vertex), vertices.data());
+    GLStateCache::get().bindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // The element buffer binding is VAO state, so upload through a neutral target
+    GLStateCache::get().bindBuffer(GL_COPY_WRITE_BUFFER, m_ebo);
+    MAZE_GL_TRACE_UPLOAD(indexCount * sizeof(unsigned int));
+    glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(out.firstIndex) * sizeof(unsigned int),
+        indexCount * sizeof(unsigned int), indices.data());
+    GLStateCache::get().bindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    return true;
+}
+
+void GpuBufferArena::release(const Allocation& allocation) {
+    if (allocation.vertexCount > 0) {
+        m_vertices.release(allocation.baseVertex, allocation.vertexCount);
+    }
+    if (allocation.indexCount > 0) {
+        m_indices.release(allocation.firstIndex, allocation.indexCount);
+    }
+}
+
+GLuint GpuBufferArena::createBuffer(GLenum target, GLsizeiptr size) const {
+    GLuint buffer = 0;
+    glGenBuffers(1, &buffer);
+    GLStateCache::get().bindBuffer(target, buffer);
+    glBufferData(target, size, nullptr, GL_STATIC_DRAW);
+    return buffer;
+}
+
+void GpuBufferArena::growVertices(unsigned int minCapacity) {
+    unsigned int oldCapacity = m_vertices.capacity;
+    m_vertices.grow(std::max(oldCapacity * 2, minCapacity));
+
+    GLuint oldBuffer = m_vbo;
+    m_vbo = createBuffer(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(m_vertices.capacity) * sizeof(Vertex));
+    GLStateCache::get().bindBuffer(GL_COPY_READ_BUFFER, oldBuffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+        static_cast<GLsizeiptr>(oldCapacity) * sizeof(Vertex));
+    GLStateCache::get().bindBuffer(GL_COPY_READ_BUFFER, 0);
+    GLStateCache::get().bindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    GLStateCache::get().deleteBuffer(oldBuffer);
+
+    // Attribute pointers captured the old buffer
+    GLStateCache::get().bindVertexArray(m_vao);
+    setupVertexAttributes();
+    GLStateCache::get().bindVertexArray(0);
+
+    std::cout << "Mesh arena: vertex buffer grown to " << m_vertices.capacity << " vertices" << std::endl;
+}
+
+void GpuBufferArena::growIndices(unsigned int minCapacity) {
+    unsigned int oldCapacity = m_indices.capacity;
+    m_indices.grow(std::max(oldCapacity * 2, minCapacity));
+
+    GLuint oldBuffer = m_ebo;
+    m_ebo = createBuffer(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(m_indices.capacity) * sizeof(unsigned int));
+    GLStateCache::get().bindBuffer(GL_COPY_READ_BUFFER, oldBuffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+        static_cast<GLsizeiptr>(oldCapacity) * sizeof(unsigned int));
+    GLStateCache::get().bindBuffer(GL_COPY_READ_BUFFER, 0);
+    GLStateCache::get().bindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    GLStateCache::get().deleteBuffer(oldBuffer);
+
+    GLStateCache::get().bindVertexArray(m_vao);
+    GLStateCache::get().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+    GLStateCache::get().bindVertexArray(0);
+
+    std::cout << "Mesh arena: index buffer grown to " << m_indices.capacity << " indices" << std::endl;
+}
+
+void GpuBufferArena::setupVertexAttributes() const {
+    GLStateCache::get().bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+
+    // Position attribute (location = 0)
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+
+    // Normal attribute (location = 1)
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+
+    // Texture coordinate attribute (location = 2)
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoordX));
+
+    // Material layer attribute (location = 3)
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, layer));
+
+    // Lightmap coordinate attribute (location = 4)
+    glEnableVertexAttribArray(4);
+    glVertexAttribPointer(4, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, lightmapX));
+
+    GLStateCache::get().bindBuffer(GL_ARRAY_BUFFER, 0);
+}
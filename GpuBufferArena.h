@@ -0,0 +1,97 @@
+#ifndef GPUBUFFERARENA_H
+#define GPUBUFFERARENA_H
+
+#include <map>
+#include <gl/glew/glew.h>
+#include "GLStateCache.h"
+#include "Mesh.h"
+
+/**
+ * @class GpuBufferArena
+ * @brief One vertex buffer, one index buffer and one VAO shared by every Mesh
+ *
+ * Meshes sub-allocate a vertex range and an index range and draw with
+ * glDrawElementsBaseVertex, so indices stay relative to the mesh and no
+ * VAO switch is needed between draws. Free ranges are kept in offset order
+ * and merged with their neighbours, so freed meshes do not fragment the
+ * buffers. When a range does not fit, the buffer grows and the old contents
+ * are copied on the GPU; existing allocations keep their offsets.
+ *
+ * All meshes use the Vertex layout, so a single VAO covers them.
+ */
+class GpuBufferArena {
+public:
+    struct Allocation {
+        unsigned int baseVertex = 0;
+        unsigned int vertexCount = 0;
+        unsigned int firstIndex = 0;
+        unsigned int indexCount = 0;
+    };
+
+    /**
+     * @param vertexCapacity Initial size of the vertex buffer, in vertices
+     * @param indexCapacity Initial size of the index buffer, in indices
+     */
+    GpuBufferArena(unsigned int vertexCapacity = 64 * 1024, unsigned int indexCapacity = 128 * 1024);
+    ~GpuBufferArena();
+
+    GpuBufferArena(const GpuBufferArena&) = delete;
+    GpuBufferArena& operator=(const GpuBufferArena&) = delete;
+
+    /**
+     * @brief Reserve space and upload a mesh's data
+     * @return false if either list is empty
+     */
+    bool allocate(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, Allocation& out);
+
+    /**
+     * @brief Return a mesh's ranges to the free lists
+     */
+    void release(const Allocation& allocation);
+
+    /**
+     * @brief Bind the shared VAO (vertex and index buffers included)
+     */
+    void bind() const { GLStateCache::get().bindVertexArray(m_vao); }
+
+    GLuint getVertexArray() const { return m_vao; }
+    unsigned int getVertexCapacity() const { return m_vertices.capacity; }
+    unsigned int getIndexCapacity() const { return m_indices.capacity; }
+    unsigned int getVerticesUsed() const { return m_vertices.used; }
+    unsigned int getIndicesUsed() const { return m_indices.used; }
+
+    /**
+     * @brief Arena used by Mesh::initialize; owned by the Renderer
+     */
+    static void setDefault(GpuBufferArena* arena) { s_default = arena; }
+    static GpuBufferArena* getDefault() { return s_default; }
+
+private:
+    /**
+     * @brief First-fit free list over [0, capacity), in elements
+     */
+    struct RangeList {
+        std::map<unsigned int, unsigned int> freeRanges;  // offset -> count
+        unsigned int capacity = 0;
+        unsigned int used = 0;
+
+        bool allocate(unsigned int count, unsigned int& offset);
+        void release(unsigned int offset, unsigned int count);
+        void grow(unsigned int newCapacity);
+    };
+
+    GLuint m_vao;
+    GLuint m_vbo;
+    GLuint m_ebo;
+    RangeList m_vertices;
+    RangeList m_indices;
+
+    static GpuBufferArena* s_default;
+
+    GLuint createBuffer(GLenum target, GLsizeiptr size) const;
+    void growVertices(unsigned int minCapacity);
+    void growIndices(unsigned int minCapacity);
+    void setupVertexAttributes() const;
+};
+
+#endif // GPUBUFFERARENA_H
@@ -0,0 +1,253 @@
+#include "GpuProfiler.h"
+#include "GLTrace.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+GpuProfiler::GpuProfiler(size_t historySize)
+    : m_frameIndex(0),
+      m_recording(false),
+      m_frameHandle(-1),
+      m_supported(false),
+      m_skippedFrames(0),
+      m_historySize(std::max<size_t>(historySize, 1)) {
+    // Some drivers expose the query but count no bits
+    GLint bits = 0;
+    glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+    m_supported = bits > 0;
+    if (!m_supported) {
+        std::cerr << "WARNING: GL_TIMESTAMP queries unsupported, GPU profiling disabled" << std::endl;
+    }
+}
+
+GpuProfiler::~GpuProfiler() {
+    for (FrameSlot& slot : m_frames) {
+        if (!slot.queries.empty()) {
+            glDeleteQueries(static_cast<GLsizei>(slot.queries.size()), slot.queries.data());
+        }
+    }
+}
+
+void GpuProfiler::beginFrame() {
+    if (!m_supported) {
+        return;
+    }
+
+    collectFinishedFrames();
+
+    FrameSlot& slot = m_frames[m_frameIndex];
+    if (slot.pending) {
+        // The GPU is a whole ring behind; drop this frame rather than wait
+        m_recording = false;
+        ++m_skippedFrames;
+        return;
+    }
+
+    slot.records.clear();
+    slot.usedQueries = 0;
+    slot.lastIssued = -1;
+    m_recording = true;
+    m_frameHandle = beginPass("Frame");
+}
+
+void GpuProfiler::endFrame() {
+    if (!m_recording) {
+        return;
+    }
+
+    endPass(m_frameHandle);
+    m_frameHandle = -1;
+    m_recording = false;
+
+    m_frames[m_frameIndex].pending = true;
+    m_frameIndex = (m_frameIndex + 1) % kFrameLatency;
+}
+
+int GpuProfiler::beginPass(const char* name) {
+    MAZE_GL_TRACE_BEGIN_PASS(name);
+    if (!m_recording) {
+        return -1;
+    }
+
+    FrameSlot& slot = m_frames[m_frameIndex];
+    if (slot.usedQueries + 2 > static_cast<int>(slot.queries.size())) {
+        size_t oldSize = slot.queries.size();
+        size_t newSize = std::max<size_t>(oldSize * 2, 16);
+        slot.queries.resize(newSize);
+        glGenQueries(static_cast<GLsizei>(newSize - oldSize), slot.queries.data() + oldSize);
+    }
+
+    Record record;
+    record.pass = findOrAddPass(name);
+    record.beginQuery = slot.usedQueries;
+    record.closed = false;
+    slot.usedQueries += 2;
+
+    glQueryCounter(slot.queries[record.beginQuery], GL_TIMESTAMP);
+    slot.lastIssued = record.beginQuery;
+    slot.records.push_back(record);
+    return static_cast<int>(slot.records.size()) - 1;
+}
+
+void GpuProfiler::endPass(int handle) {
+    MAZE_GL_TRACE_END_PASS();
+    if (!m_recording || handle < 0) {
+        return;
+    }
+
+    FrameSlot& slot = m_frames[m_frameIndex];
+    if (handle >= static_cast<int>(slot.records.size()) || slot.records[handle].closed) {
+        return;
+    }
+
+    Record& record = slot.records[handle];
+    glQueryCounter(slot.queries[record.beginQuery + 1], GL_TIMESTAMP);
+    slot.lastIssued = record.beginQuery + 1;
+    record.closed = true;
+}
+
+int GpuProfiler::findOrAddPass(const char* name) {
+    // A handful of passes, so a linear scan beats hashing a string every call
+    for (size_t i = 0; i < m_passes.size(); ++i) {
+        if (m_passes[i].name == name || std::strcmp(m_passes[i].name, name) == 0) {
+            return static_cast<int>(i);
+        }
+    }
+
+    PassStats pass;
+    pass.name = name;
+    pass.history.resize(m_historySize, 0.0f);
+    m_passes.push_back(pass);
+    m_frameTotals.push_back(0.0);
+    m_frameSeen.push_back(0);
+    return static_cast<int>(m_passes.size()) - 1;
+}
+
+void GpuProfiler::collectFinishedFrames() {
+    // Oldest first: the slot after the current one was issued longest ago
+    for (int i = 1; i <= kFrameLatency; ++i) {
+        FrameSlot& slot = m_frames[(m_frameIndex + i) % kFrameLatency];
+        if (!slot.pending) {
+            continue;
+        }
+
+        // Queries finish in submission order, so the last one issued decides.
+        // That is the Frame end, not the end of the last pass opened.
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(slot.queries[slot.lastIssued], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;
+        }
+
+        readBack(slot);
+        slot.pending = false;
+    }
+}
+
+void GpuProfiler::readBack(FrameSlot& slot) {
+    std::fill(m_frameTotals.begin(), m_frameTotals.end(), 0.0);
+    std::fill(m_frameSeen.begin(), m_frameSeen.end(), 0);
+
+    for (const Record& record : slot.records) {
+        if (!record.closed) {
+            continue;  // Pass never ended; its end query was never issued
+        }
+
+        GLuint64 begin = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(slot.queries[record.beginQuery], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(slot.queries[record.beginQuery + 1], GL_QUERY_RESULT, &end);
+
+        if (end > begin) {
+            m_frameTotals[record.pass] += static_cast<double>(end - begin) / 1.0e6;
+        }
+        m_frameSeen[record.pass] = 1;
+    }
+
+    for (size_t i = 0; i < m_passes.size(); ++i) {
+        if (!m_frameSeen[i]) {
+            continue;
+        }
+
+        PassStats& pass = m_passes[i];
+        pass.last = static_cast<float>(m_frameTotals[i]);
+        pass.history[pass.next] = pass.last;
+        pass.next = (pass.next + 1) % pass.history.size();
+        pass.count = std::min(pass.count + 1, pass.history.size());
+    }
+}
+
+const GpuProfiler::PassStats* GpuProfiler::findPass(const std::string& name) const {
+    for (const PassStats& pass : m_passes) {
+        if (name == pass.name) {
+            return &pass;
+        }
+    }
+    return nullptr;
+}
+
+float GpuProfiler::getLastMilliseconds(const std::string& name) const {
+    const PassStats* pass = findPass(name);
+    return pass ? pass->last : 0.0f;
+}
+
+float GpuProfiler::getAverageMilliseconds(const std::string& name) const {
+    const PassStats* pass = findPass(name);
+    if (!pass || pass->count == 0) {
+        return 0.0f;
+    }
+
+    double sum = 0.0;
+    for (size_t i = 0; i < pass->count; ++i) {
+        sum += pass->history[i];
+    }
+    return static_cast<float>(sum / pass->count);
+}
+
+float GpuProfiler::getPercentileMilliseconds(const std::string& name, float percentile) const {
+    const PassStats* pass = findPass(name);
+    return pass ? percentileOf(*pass, percentile) : 0.0f;
+}
+
+float GpuProfiler::percentileOf(const PassStats& pass, float percentile) const {
+    if (pass.count == 0) {
+        return 0.0f;
+    }
+
+    // Only the filled part of the ring; order does not matter for nth_element
+    m_sortScratch.assign(pass.history.begin(), pass.history.begin() + pass.count);
+
+    float clamped = std::max(0.0f, std::min(percentile, 100.0f));
+    size_t rank = static_cast<size_t>(clamped / 100.0f * (pass.count - 1) + 0.5f);
+    std::nth_element(m_sortScratch.begin(), m_sortScratch.begin() + rank, m_sortScratch.end());
+    return m_sortScratch[rank];
+}
+
+std::vector<std::string> GpuProfiler::getPassNames() const {
+    std::vector<std::string> names;
+    names.reserve(m_passes.size());
+    for (const PassStats& pass : m_passes) {
+        names.push_back(pass.name);
+    }
+    return names;
+}
+
+void GpuProfiler::logSummary() const {
+    if (!m_supported) {
+        return;
+    }
+
+    std::cout << "GPU pass timings (ms)         avg     p50     p95     p99     max  frames" << std::endl;
+    for (const PassStats& pass : m_passes) {
+        float average = getAverageMilliseconds(pass.name);
+        char line[128];
+        std::snprintf(line, sizeof(line), "  %-24s %7.3f %7.3f %7.3f %7.3f %7.3f %7zu",
+            pass.name, average, percentileOf(pass, 50.0f), percentileOf(pass, 95.0f),
+            percentileOf(pass, 99.0f), percentileOf(pass, 100.0f), pass.count);
+        std::cout << line << std::endl;
+    }
+    if (m_skippedFrames > 0) {
+        std::cout << "  (" << m_skippedFrames << " frames not measured, GPU too far behind)" << std::endl;
+    }
+}
@@ -0,0 +1,122 @@
+#ifndef GPUPROFILER_H
+#define GPUPROFILER_H
+
+#include <gl/glew/glew.h>
+#include <string>
+#include <vector>
+
+/**
+ * @class GpuProfiler
+ * @brief Per-pass GPU timings from GL_TIMESTAMP queries
+ *
+ * Each pass records a timestamp before and after its commands. Queries for
+ * a frame live in one slot of a small ring and are read back only once the
+ * GPU has finished them, a few frames later, so profiling never stalls the
+ * pipeline; if every slot is still in flight the frame is simply not
+ * measured. Timestamps (unlike GL_TIME_ELAPSED) can nest and do not clash
+ * with other timer queries. A pass recorded several times in one frame is
+ * summed. Each pass keeps a rolling window of per-frame times for averages
+ * and percentiles.
+ */
+class GpuProfiler {
+public:
+    /**
+     * @param historySize Frames kept per pass for averages and percentiles
+     */
+    explicit GpuProfiler(size_t historySize = 240);
+    ~GpuProfiler();
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    /**
+     * @brief Collect finished frames and start recording a new one
+     */
+    void beginFrame();
+    void endFrame();
+
+    /**
+     * @brief Start timing a pass; name must stay valid (use a literal)
+     * @return Handle for endPass, or -1 if this frame is not recorded
+     */
+    int beginPass(const char* name);
+    void endPass(int handle);
+
+    /**
+     * @class Scope
+     * @brief Times the enclosing block as one pass
+     */
+    class Scope {
+    public:
+        Scope(GpuProfiler* profiler, const char* name)
+            : m_profiler(profiler), m_handle(profiler ? profiler->beginPass(name) : -1) {}
+        ~Scope() { if (m_profiler) m_profiler->endPass(m_handle); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        GpuProfiler* m_profiler;
+        int m_handle;
+    };
+
+    // Statistics over the rolling window, in milliseconds (0 for unknown passes)
+    float getLastMilliseconds(const std::string& name) const;
+    float getAverageMilliseconds(const std::string& name) const;
+    float getPercentileMilliseconds(const std::string& name, float percentile) const;
+    std::vector<std::string> getPassNames() const;
+
+    /**
+     * @brief Print average, p50, p95, p99 and max of every pass to stdout
+     */
+    void logSummary() const;
+
+    bool isSupported() const { return m_supported; }
+    int getSkippedFrames() const { return m_skippedFrames; }
+
+private:
+    static const int kFrameLatency = 4;
+
+    struct Record {
+        int pass;
+        int beginQuery;  // endQuery is beginQuery + 1
+        bool closed;
+    };
+
+    struct FrameSlot {
+        std::vector<GLuint> queries;  // Grows as needed, never shrinks
+        std::vector<Record> records;
+        int usedQueries = 0;
+        int lastIssued = -1;   // Query issued last (the Frame end once the frame is over)
+        bool pending = false;  // Issued and not yet read back
+    };
+
+    struct PassStats {
+        const char* name;
+        std::vector<float> history;  // Ring of per-frame milliseconds
+        size_t next = 0;
+        size_t count = 0;
+        float last = 0.0f;
+    };
+
+    FrameSlot m_frames[kFrameLatency];
+    int m_frameIndex;
+    bool m_recording;
+    int m_frameHandle;
+    bool m_supported;
+    int m_skippedFrames;
+
+    size_t m_historySize;
+    std::vector<PassStats> m_passes;
+    std::vector<double> m_frameTotals;  // Scratch for summing repeated passes
+    std::vector<unsigned char> m_frameSeen;
+    mutable std::vector<float> m_sortScratch;
+
+    int findOrAddPass(const char* name);
+    const PassStats* findPass(const std::string& name) const;
+    void collectFinishedFrames();
+    void readBack(FrameSlot& slot);
+    float percentileOf(const PassStats& pass, float percentile) const;
+};
+
+#endif // GPUPROFILER_H
@@ -0,0 +1,82 @@
+#include "HalfResolutionTarget.h"
+#include "GLStateCache.h"
+#include <algorithm>
+#include <iostream>
+
+HalfResolutionTarget::HalfResolutionTarget()
+    : m_framebuffer(0),
+      m_colorTexture(0),
+      m_depthTexture(0),
+      m_width(0),
+      m_height(0),
+      m_renderWidth(0),
+      m_renderHeight(0) {}
+
+HalfResolutionTarget::~HalfResolutionTarget() {
+    release();
+}
+
+bool HalfResolutionTarget::create(int fullWidth, int fullHeight) {
+    release();
+
+    m_width = std::max(1, (fullWidth + 1) / 2);
+    m_height = std::max(1, (fullHeight + 1) / 2);
+    m_renderWidth = m_width;
+    m_renderHeight = m_height;
+
+    // The upsample fetches exact texels and does its own weighting, so no filtering
+    GLStateCache& state = GLStateCache::get();
+    glGenTextures(1, &m_colorTexture);
+    state.bindTexture(GL_TEXTURE_2D, m_colorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glGenTextures(1, &m_depthTexture);
+    state.bindTexture(GL_TEXTURE_2D, m_depthTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, m_width, m_height, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    state.bindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_colorTexture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, m_depthTexture, 0);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (!complete) {
+        std::cerr << "ERROR: Half-resolution framebuffer incomplete (" << m_width << "x" << m_height << ")" << std::endl;
+        release();
+        return false;
+    }
+    return true;
+}
+
+void HalfResolutionTarget::bind(int sceneRenderWidth, int sceneRenderHeight) {
+    m_renderWidth = std::max(1, std::min((sceneRenderWidth + 1) / 2, m_width));
+    m_renderHeight = std::max(1, std::min((sceneRenderHeight + 1) / 2, m_height));
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glViewport(0, 0, m_renderWidth, m_renderHeight);
+}
+
+void HalfResolutionTarget::release() {
+    if (m_framebuffer != 0) {
+        glDeleteFramebuffers(1, &m_framebuffer);
+        m_framebuffer = 0;
+    }
+    if (m_colorTexture != 0) {
+        GLStateCache::get().deleteTexture(m_colorTexture);
+        m_colorTexture = 0;
+    }
+    if (m_depthTexture != 0) {
+        GLStateCache::get().deleteTexture(m_depthTexture);
+        m_depthTexture = 0;
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef HALFRESOLUTIONTARGET_H
+#define HALFRESOLUTIONTARGET_H
+
+#include <gl/glew/glew.h>
+
+/**
+ * @class HalfResolutionTarget
+ * @brief Colour + depth textures at half the scene size, for cheap effect passes
+ *
+ * Like SceneFramebuffer, storage is allocated once for the full output
+ * and a lower render scale only shrinks the viewport used inside it.
+ * Both attachments are textures: Renderer writes the downsampled scene
+ * depth into the depth one, draws effects against it, then composites
+ * the colour one over the scene with a depth-aware (bilateral) upsample.
+ */
+class HalfResolutionTarget {
+public:
+    HalfResolutionTarget();
+    ~HalfResolutionTarget();
+
+    HalfResolutionTarget(const HalfResolutionTarget&) = delete;
+    HalfResolutionTarget& operator=(const HalfResolutionTarget&) = delete;
+
+    /**
+     * @brief (Re)allocate for a full-resolution size; each axis is halved, rounding up
+     * @return false if the framebuffer is incomplete
+     */
+    bool create(int fullWidth, int fullHeight);
+
+    /**
+     * @brief Bind for rendering with the viewport covering half of the scene's rendered area
+     */
+    void bind(int sceneRenderWidth, int sceneRenderHeight);
+
+    GLuint getColorTexture() const { return m_colorTexture; }
+    GLuint getDepthTexture() const { return m_depthTexture; }
+    int getRenderWidth() const { return m_renderWidth; }
+    int getRenderHeight() const { return m_renderHeight; }
+    bool isValid() const { return m_framebuffer != 0; }
+
+private:
+    GLuint m_framebuffer;
+    GLuint m_colorTexture;
+    GLuint m_depthTexture;
+    int m_width;
+    int m_height;
+    int m_renderWidth;
+    int m_renderHeight;
+
+    void release();
+};
+
+#endif // HALFRESOLUTIONTARGET_H
@@ -0,0 +1,235 @@
+#include "HeadlessContext.h"
+#include <SFML/Graphics/Image.hpp>
+#include <cstring>
+#include <iostream>
+
+#if defined(MAZE_HEADLESS_EGL)
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#elif defined(MAZE_HEADLESS_OSMESA)
+#include <GL/osmesa.h>
+#else
+#include <SFML/Window/Context.hpp>
+#endif
+
+#if defined(MAZE_HEADLESS_EGL)
+
+struct HeadlessContext::Backend {
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLContext context = EGL_NO_CONTEXT;
+
+    ~Backend() {
+        if (display != EGL_NO_DISPLAY) {
+            eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            if (context != EGL_NO_CONTEXT) {
+                eglDestroyContext(display, context);
+            }
+            eglTerminate(display);
+        }
+    }
+
+    bool create(int, int) {
+        // Surfaceless Mesa needs no display server or GPU device node
+        PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+            reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (getPlatformDisplay) {
+            display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        }
+        if (display == EGL_NO_DISPLAY) {
+            display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        }
+
+        EGLint major = 0;
+        EGLint minor = 0;
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+            std::cerr << "ERROR: No EGL display available" << std::endl;
+            display = EGL_NO_DISPLAY;
+            return false;
+        }
+        eglBindAPI(EGL_OPENGL_API);
+
+        // Any config will do since nothing is drawn to an EGL surface
+        const EGLint configAttributes[] = {
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_NONE
+        };
+        EGLConfig config = nullptr;
+        EGLint configCount = 0;
+        if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0) {
+            config = nullptr;  // EGL_KHR_no_config_context
+        }
+
+        const EGLint contextAttributes[] = {
+            EGL_CONTEXT_MAJOR_VERSION, 3,
+            EGL_CONTEXT_MINOR_VERSION, 3,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+        context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+        if (context == EGL_NO_CONTEXT) {
+            std::cerr << "ERROR: Failed to create EGL OpenGL 3.3 context (0x"
+                << std::hex << eglGetError() << std::dec << ")" << std::endl;
+            return false;
+        }
+
+        if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+            std::cerr << "ERROR: Surfaceless eglMakeCurrent failed" << std::endl;
+            return false;
+        }
+        std::cout << "Headless context: EGL " << major << "." << minor << std::endl;
+        return true;
+    }
+};
+
+#elif defined(MAZE_HEADLESS_OSMESA)
+
+struct HeadlessContext::Backend {
+    OSMesaContext context = nullptr;
+    unsigned char dummyBuffer[4];  // OSMesa wants a colour buffer; the FBO is used instead
+
+    ~Backend() {
+        if (context) {
+            OSMesaDestroyContext(context);
+        }
+    }
+
+    bool create(int, int) {
+        const int attributes[] = {
+            OSMESA_FORMAT, OSMESA_RGBA,
+            OSMESA_DEPTH_BITS, 0,
+            OSMESA_PROFILE, OSMESA_CORE_PROFILE,
+            OSMESA_CONTEXT_MAJOR_VERSION, 3,
+            OSMESA_CONTEXT_MINOR_VERSION, 3,
+            0
+        };
+        context = OSMesaCreateContextAttribs(attributes, nullptr);
+        if (!context) {
+            std::cerr << "ERROR: Failed to create OSMesa OpenGL 3.3 context" << std::endl;
+            return false;
+        }
+
+        if (!OSMesaMakeCurrent(context, dummyBuffer, GL_UNSIGNED_BYTE, 1, 1)) {
+            std::cerr << "ERROR: OSMesaMakeCurrent failed" << std::endl;
+            return false;
+        }
+        std::cout << "Headless context: OSMesa" << std::endl;
+        return true;
+    }
+};
+
+#else
+
+struct HeadlessContext::Backend {
+    std::unique_ptr<sf::Context> context;
+
+    bool create(int width, int height) {
+        sf::ContextSettings settings(24, 8, 0, 3, 3);
+        context = std::make_unique<sf::Context>(settings, width, height);
+        if (!context->setActive(true)) {
+            std::cerr << "ERROR: Failed to activate offscreen SFML context" << std::endl;
+            return false;
+        }
+        std::cout << "Headless context: SFML offscreen context" << std::endl;
+        return true;
+    }
+};
+
+#endif
+
+HeadlessContext::HeadlessContext()
+    : m_framebuffer(0),
+      m_colorRenderbuffer(0),
+      m_depthRenderbuffer(0),
+      m_width(0),
+      m_height(0) {}
+
+HeadlessContext::~HeadlessContext() {
+    if (m_backend) {
+        if (m_framebuffer != 0) glDeleteFramebuffers(1, &m_framebuffer);
+        if (m_colorRenderbuffer != 0) glDeleteRenderbuffers(1, &m_colorRenderbuffer);
+        if (m_depthRenderbuffer != 0) glDeleteRenderbuffers(1, &m_depthRenderbuffer);
+    }
+}
+
+bool HeadlessContext::create(int width, int height) {
+    m_width = width;
+    m_height = height;
+
+    std::unique_ptr<Backend> backend(new Backend());
+    if (!backend->create(width, height)) {
+        return false;
+    }
+
+    glewExperimental = GL_TRUE;
+    GLenum err = glewInit();
+    if (err != GLEW_OK) {
+        std::cerr << "ERROR: GLEW init failed on the headless context: " << glewGetErrorString(err) << std::endl;
+        return false;
+    }
+    glGetError();  // glewInit can leave GL_INVALID_ENUM behind on core contexts
+
+    m_backend = std::move(backend);
+    return createFramebuffer();
+}
+
+bool HeadlessContext::createFramebuffer() {
+    glGenRenderbuffers(1, &m_colorRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_colorRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_width, m_height);
+
+    glGenRenderbuffers(1, &m_depthRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depthRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_width, m_height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorRenderbuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depthRenderbuffer);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "ERROR: Headless framebuffer incomplete (" << m_width << "x" << m_height << ")" << std::endl;
+        return false;
+    }
+
+    // Stays bound: everything without its own target draws here
+    glViewport(0, 0, m_width, m_height);
+    return true;
+}
+
+void HeadlessContext::readPixels(std::vector<unsigned char>& rgba) const {
+    const size_t rowBytes = static_cast<size_t>(m_width) * 4;
+    rgba.resize(rowBytes * m_height);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+
+    // GL rows start at the bottom
+    std::vector<unsigned char> row(rowBytes);
+    for (int y = 0; y < m_height / 2; ++y) {
+        unsigned char* top = rgba.data() + y * rowBytes;
+        unsigned char* bottom = rgba.data() + (m_height - 1 - y) * rowBytes;
+        std::memcpy(row.data(), top, rowBytes);
+        std::memcpy(top, bottom, rowBytes);
+        std::memcpy(bottom, row.data(), rowBytes);
+    }
+}
+
+bool HeadlessContext::saveImage(const std::string& path) const {
+    std::vector<unsigned char> rgba;
+    readPixels(rgba);
+
+    // Blended passes leave arbitrary alpha behind; a window ignores it, an image would not
+    for (size_t i = 3; i < rgba.size(); i += 4) {
+        rgba[i] = 255;
+    }
+
+    sf::Image image;
+    image.create(m_width, m_height, rgba.data());
+    if (!image.saveToFile(path)) {
+        std::cerr << "ERROR: Failed to write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
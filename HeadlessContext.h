@@ -0,0 +1,64 @@
+#ifndef HEADLESSCONTEXT_H
+#define HEADLESSCONTEXT_H
+
+#include <gl/glew/glew.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @class HeadlessContext
+ * @brief Offscreen OpenGL 3.3 context that renders into its own framebuffer
+ *
+ * Lets the game render without a window, for benchmarks and golden-image
+ * tests on build servers. The backend is chosen at build time:
+ *   - MAZE_HEADLESS_EGL: EGL on the surfaceless Mesa platform (no display
+ *     server at all). GLEW must be built with GLEW_EGL.
+ *   - MAZE_HEADLESS_OSMESA: Mesa's off-screen software rasterizer. GLEW
+ *     must be built with GLEW_OSMESA.
+ *   - otherwise: an sf::Context, which uses a hidden window where the
+ *     platform needs one.
+ * Either way the frames go into a colour + depth FBO of the requested size,
+ * which the renderer should use as its output framebuffer.
+ */
+class HeadlessContext {
+public:
+    HeadlessContext();
+    ~HeadlessContext();
+
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+    /**
+     * @brief Create the context, make it current, initialize GLEW and the FBO
+     */
+    bool create(int width, int height);
+
+    GLuint getFramebuffer() const { return m_framebuffer; }
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+
+    /**
+     * @brief Read the framebuffer back as top-down RGBA8 rows
+     */
+    void readPixels(std::vector<unsigned char>& rgba) const;
+
+    /**
+     * @brief Write the framebuffer to an image file (format from the extension)
+     */
+    bool saveImage(const std::string& path) const;
+
+private:
+    struct Backend;
+    std::unique_ptr<Backend> m_backend;
+
+    GLuint m_framebuffer;
+    GLuint m_colorRenderbuffer;
+    GLuint m_depthRenderbuffer;
+    int m_width;
+    int m_height;
+
+    bool createFramebuffer();
+};
+
+#endif // HEADLESSCONTEXT_H
@@ -0,0 +1,287 @@
+#include "LightGrid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Radii are compared in steps of 1/16 unit
+    const float kRadiusSteps = 16.0f;
+    const float kDiagonalStep = 1.41421356f;
+    // Stands in for N.L: its average over the directions a surface faces
+    const float kAverageFacing = 0.5f;
+
+    int roundToInt(float value) {
+        return static_cast<int>(std::floor(value + 0.5f));
+    }
+}
+
+bool LightGrid::Key::operator<(const Key& other) const {
+    if (texel != other.texel) return texel < other.texel;
+    if (radius != other.radius) return radius < other.radius;
+    for (int c = 0; c < 3; ++c) {
+        if (color[c] != other.color[c]) return color[c] < other.color[c];
+    }
+    return false;
+}
+
+LightGrid::LightGrid()
+    : m_width(0),
+      m_height(0),
+      m_currentStamp(0),
+      m_dirtyMinX(0),
+      m_dirtyMinZ(0),
+      m_dirtyMaxX(-1),
+      m_dirtyMaxZ(-1),
+      m_lastFloods(0),
+      m_lastRemovals(0),
+      m_lastTexels(0) {}
+
+void LightGrid::setMaze(const Maze& maze) {
+    m_width = maze.getWidth() * kResolution;
+    m_height = maze.getHeight() * kResolution;
+    const size_t count = static_cast<size_t>(m_width) * m_height;
+
+    m_open.resize(count);
+    m_texels.assign(count * 4, 0.0f);
+    for (int z = 0; z < m_height; ++z) {
+        for (int x = 0; x < m_width; ++x) {
+            size_t index = static_cast<size_t>(z) * m_width + x;
+            m_open[index] = maze.getCellType(x / kResolution, z / kResolution) == 0 ? 1 : 0;
+            m_texels[index * 4 + 3] = m_open[index] ? 1.0f : 0.0f;
+        }
+    }
+
+    m_sources.clear();
+    m_distance.assign(count, 0.0f);
+    m_stamp.assign(count, 0);
+    m_currentStamp = 0;
+
+    // The whole grid is new
+    m_dirtyMinX = 0;
+    m_dirtyMinZ = 0;
+    m_dirtyMaxX = m_width - 1;
+    m_dirtyMaxZ = m_height - 1;
+}
+
+bool LightGrid::makeKey(const PointLight& light, Key& key) const {
+    const float texelSize = getTexelSize();
+    int x = static_cast<int>(std::floor(light.position.x / texelSize));
+    int z = static_cast<int>(std::floor(light.position.z / texelSize));
+    if (x < 0 || x >= m_width || z < 0 || z >= m_height || !m_open[z * m_width + x]) {
+        return false;
+    }
+
+    key.texel = z * m_width + x;
+    key.radius = roundToInt(light.radius * kRadiusSteps);
+    key.color[0] = roundToInt(light.color.x * kColorSteps);
+    key.color[1] = roundToInt(light.color.y * kColorSteps);
+    key.color[2] = roundToInt(light.color.z * kColorSteps);
+    return key.radius > 0 && (key.color[0] > 0 || key.color[1] > 0 || key.color[2] > 0);
+}
+
+void LightGrid::update(const std::vector<PointLight>& lights) {
+    m_lastFloods = 0;
+    m_lastRemovals = 0;
+    m_lastTexels = 0;
+    if (m_width == 0) return;
+
+    m_keys.clear();
+    for (const PointLight& light : lights) {
+        Key key;
+        if (makeKey(light, key)) {
+            m_keys.push_back(key);
+        }
+    }
+    std::sort(m_keys.begin(), m_keys.end());
+
+    // Both lists are sorted, so one merge finds the lights that stayed,
+    // went away and arrived; equal keys pair off one to one
+    m_nextSources.clear();
+    size_t s = 0;
+    size_t k = 0;
+    while (s < m_sources.size() || k < m_keys.size()) {
+        if (k == m_keys.size() || (s < m_sources.size() && m_sources[s].key < m_keys[k])) {
+            remove(m_sources[s]);
+            ++s;
+        }
+        else if (s == m_sources.size() || m_keys[k] < m_sources[s].key) {
+            m_nextSources.emplace_back();
+            flood(m_keys[k], m_nextSources.back());
+            ++k;
+        }
+        else {
+            m_nextSources.push_back(std::move(m_sources[s]));
+            ++s;
+            ++k;
+        }
+    }
+    m_sources.swap(m_nextSources);
+}
+
+void LightGrid::flood(const Key& key, Source& source) {
+    source.key = key;
+    if (!m_spareFootprints.empty()) {
+        source.footprint.swap(m_spareFootprints.back());
+        m_spareFootprints.pop_back();
+    }
+    source.footprint.clear();
+
+    const float radius = key.radius / kRadiusSteps / getTexelSize();  // In texels
+    const float red = key.color[0] / static_cast<float>(kColorSteps);
+    const float green = key.color[1] / static_cast<float>(kColorSteps);
+    const float blue = key.color[2] / static_cast<float>(kColorSteps);
+
+    if (++m_currentStamp == 0) {
+        // Wrapped: forget every old stamp once
+        std::fill(m_stamp.begin(), m_stamp.end(), 0u);
+        m_currentStamp = 1;
+    }
+
+    source.minX = source.maxX = key.texel % m_width;
+    source.minZ = source.maxZ = key.texel / m_width;
+
+    // Dijkstra over open texels; an entry whose texel has since been
+    // reached more cheaply is skipped when it comes off the heap
+    m_frontier.clear();
+    m_frontier.push_back(FrontierEntry{ 0.0f, static_cast<uint32_t>(key.texel) });
+    m_distance[key.texel] = 0.0f;
+    m_stamp[key.texel] = m_currentStamp;
+
+    while (!m_frontier.empty()) {
+        std::pop_heap(m_frontier.begin(), m_frontier.end());
+        FrontierEntry entry = m_frontier.back();
+        m_frontier.pop_back();
+        if (entry.distance > m_distance[entry.texel]) {
+            continue;
+        }
+
+        int x = static_cast<int>(entry.texel) % m_width;
+        int z = static_cast<int>(entry.texel) / m_width;
+        float falloff = 1.0f - entry.distance / radius;
+        float weight = kAverageFacing * falloff * falloff;
+        float* texel = &m_texels[entry.texel * 4];
+        texel[0] += red * weight;
+        texel[1] += green * weight;
+        texel[2] += blue * weight;
+        source.footprint.push_back(Reached{ entry.texel, weight });
+        source.minX = std::min(source.minX, x);
+        source.maxX = std::max(source.maxX, x);
+        source.minZ = std::min(source.minZ, z);
+        source.maxZ = std::max(source.maxZ, z);
+
+        for (int dz = -1; dz <= 1; ++dz) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                if (dx == 0 && dz == 0) continue;
+                int nx = x + dx;
+                int nz = z + dz;
+                if (nx < 0 || nx >= m_width || nz < 0 || nz >= m_height || !m_open[nz * m_width + nx]) {
+                    continue;
+                }
+                // A diagonal step needs both sides open, or light would slip past a wall's corner
+                if (dx != 0 && dz != 0 && (!m_open[z * m_width + nx] || !m_open[nz * m_width + x])) {
+                    continue;
+                }
+
+                float distance = entry.distance + (dx != 0 && dz != 0 ? kDiagonalStep : 1.0f);
+                uint32_t next = static_cast<uint32_t>(nz * m_width + nx);
+                if (distance >= radius) continue;
+                if (m_stamp[next] == m_currentStamp && distance >= m_distance[next]) continue;
+
+                m_stamp[next] = m_currentStamp;
+                m_distance[next] = distance;
+                m_frontier.push_back(FrontierEntry{ distance, next });
+                std::push_heap(m_frontier.begin(), m_frontier.end());
+            }
+        }
+    }
+
+    markDirty(source);
+    ++m_lastFloods;
+    m_lastTexels += static_cast<int>(source.footprint.size());
+}
+
+void LightGrid::remove(Source& source) {
+    const float red = source.key.color[0] / static_cast<float>(kColorSteps);
+    const float green = source.key.color[1] / static_cast<float>(kColorSteps);
+    const float blue = source.key.color[2] / static_cast<float>(kColorSteps);
+
+    // Rounding leaves crumbs when lights come and go; never let them go negative
+    for (const Reached& reached : source.footprint) {
+        float* texel = &m_texels[reached.texel * 4];
+        texel[0] = std::max(texel[0] - red * reached.weight, 0.0f);
+        texel[1] = std::max(texel[1] - green * reached.weight, 0.0f);
+        texel[2] = std::max(texel[2] - blue * reached.weight, 0.0f);
+    }
+
+    markDirty(source);
+    ++m_lastRemovals;
+    m_lastTexels += static_cast<int>(source.footprint.size());
+    m_spareFootprints.push_back(std::move(source.footprint));
+}
+
+void LightGrid::markDirty(const Source& source) {
+    if (m_dirtyMaxX < m_dirtyMinX) {
+        m_dirtyMinX = source.minX;
+        m_dirtyMinZ = source.minZ;
+        m_dirtyMaxX = source.maxX;
+        m_dirtyMaxZ = source.maxZ;
+        return;
+    }
+    m_dirtyMinX = std::min(m_dirtyMinX, source.minX);
+    m_dirtyMinZ = std::min(m_dirtyMinZ, source.minZ);
+    m_dirtyMaxX = std::max(m_dirtyMaxX, source.maxX);
+    m_dirtyMaxZ = std::max(m_dirtyMaxZ, source.maxZ);
+}
+
+bool LightGrid::getDirtyRect(int& x, int& z, int& width, int& height) const {
+    if (m_dirtyMaxX < m_dirtyMinX) {
+        return false;
+    }
+    x = m_dirtyMinX;
+    z = m_dirtyMinZ;
+    width = m_dirtyMaxX - m_dirtyMinX + 1;
+    height = m_dirtyMaxZ - m_dirtyMinZ + 1;
+    return true;
+}
+
+void LightGrid::clearDirty() {
+    m_dirtyMinX = 0;
+    m_dirtyMinZ = 0;
+    m_dirtyMaxX = -1;
+    m_dirtyMaxZ = -1;
+}
+
+Vector3 LightGrid::sample(float x, float z, float normalX, float normalZ) const {
+    if (m_width == 0) return Vector3();
+
+    // Half a texel along the normal, then texel centres at integers
+    const float texelSize = getTexelSize();
+    float gridX = x / texelSize + normalX * 0.5f - 0.5f;
+    float gridZ = z / texelSize + normalZ * 0.5f - 0.5f;
+    int x0 = static_cast<int>(std::floor(gridX));
+    int z0 = static_cast<int>(std::floor(gridZ));
+    float fx = gridX - x0;
+    float fz = gridZ - z0;
+
+    float red = 0.0f;
+    float green = 0.0f;
+    float blue = 0.0f;
+    float open = 0.0f;
+    for (int j = 0; j < 2; ++j) {
+        // Clamped at the edges, like GL_CLAMP_TO_EDGE
+        int tz = std::max(0, std::min(z0 + j, m_height - 1));
+        float wz = j == 0 ? 1.0f - fz : fz;
+        for (int i = 0; i < 2; ++i) {
+            int tx = std::max(0, std::min(x0 + i, m_width - 1));
+            float w = wz * (i == 0 ? 1.0f - fx : fx);
+            const float* texel = &m_texels[(static_cast<size_t>(tz) * m_width + tx) * 4];
+            red += texel[0] * w;
+            green += texel[1] * w;
+            blue += texel[2] * w;
+            open += texel[3] * w;
+        }
+    }
+
+    if (open <= 1e-3f) return Vector3();
+    float scale = 1.0f / open;
+    return Vector3(red * scale, green * scale, blue * scale);
+}
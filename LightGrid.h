@@ -0,0 +1,139 @@
+#ifndef LIGHTGRID_H
+#define LIGHTGRID_H
+
+#include "ClusteredLighting.h"
+#include "Maze.h"
+#include "Vector3.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class LightGrid
+ * @brief Point lights spread over the maze's floor plan by flood fill
+ *
+ * A cheap stand-in for per-pixel point lights, for weak GPUs and the
+ * SoftwareRenderer. The grid has kResolution x kResolution texels per
+ * maze cell. Each light floods out from its texel through open texels,
+ * shortest path first (8-connected, never cutting a wall's corner), so
+ * walls block it and it reaches round a corner only as far as the longer
+ * path allows. A texel at path length d receives
+ * color * (1 - d / radius)^2 / 2, the PointLight falloff with N.L
+ * replaced by its average.
+ *
+ * Every light keeps its footprint, the texels it reached and their
+ * weights. update() matches the frame's lights against the last ones by
+ * texel, radius and colour (rounded to kColorSteps per unit, so a slow
+ * pulse does not refill every frame), subtracts the footprints of lights
+ * that went away or changed and floods only the new ones. The cost
+ * follows the number of changed lights and their reach, not the maze size.
+ *
+ * Texels are RGBA floats, row z = 0 first as GL expects: rgb is the light
+ * and a is 1 in open texels, 0 in walls. A bilinear sample divided by its
+ * alpha blends open texels only, so walls neither darken nor leak.
+ */
+class LightGrid {
+public:
+    // Grid texels per maze cell side
+    static const int kResolution = 2;
+    // Light colours are compared after rounding to this many steps per unit
+    static const int kColorSteps = 32;
+
+    LightGrid();
+
+    /**
+     * @brief Size the grid for a maze and drop every light
+     */
+    void setMaze(const Maze& maze);
+
+    /**
+     * @brief Bring the grid up to date with this frame's lights
+     *
+     * Lights whose texel is in a wall or outside the maze, or whose rounded
+     * colour is black, are left out.
+     */
+    void update(const std::vector<PointLight>& lights);
+
+    /**
+     * @brief The light at a surface point, filtered as fragment.glsl filters the texture
+     * @param normalX, normalZ Horizontal part of the surface normal; a wall reads the texel in front of it
+     */
+    Vector3 sample(float x, float z, float normalX, float normalZ) const;
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    const std::vector<float>& getTexels() const { return m_texels; }  // width * height * 4
+
+    // World units per grid texel
+    static float getTexelSize() { return Maze::kCellSize / kResolution; }
+
+    /**
+     * @brief The rectangle of texels changed since the last clearDirty()
+     * @return false if nothing changed
+     */
+    bool getDirtyRect(int& x, int& z, int& width, int& height) const;
+    void clearDirty();
+
+    // What the last update() did, for statistics
+    int getLastFloodCount() const { return m_lastFloods; }
+    int getLastRemovedCount() const { return m_lastRemovals; }
+    int getLastTexelCount() const { return m_lastTexels; }
+    size_t getLightCount() const { return m_sources.size(); }
+
+private:
+    // A light as update() compares it: everything the flood depends on
+    struct Key {
+        int texel;
+        int radius;    // 1/16 units
+        int color[3];  // 1/kColorSteps units
+
+        bool operator<(const Key& other) const;
+    };
+
+    struct Reached {
+        uint32_t texel;
+        float weight;
+    };
+
+    struct Source {
+        Key key;
+        std::vector<Reached> footprint;
+        int minX, minZ, maxX, maxZ;
+    };
+
+    struct FrontierEntry {
+        float distance;
+        uint32_t texel;
+
+        // Min-heap order for std::push_heap
+        bool operator<(const FrontierEntry& other) const { return distance > other.distance; }
+    };
+
+    int m_width;
+    int m_height;
+    std::vector<unsigned char> m_open;  // 1 where the flood may go
+    std::vector<float> m_texels;
+
+    std::vector<Source> m_sources;      // Sorted by key
+    std::vector<Source> m_nextSources;
+    std::vector<Key> m_keys;            // This frame's lights, sorted
+    std::vector<std::vector<Reached>> m_spareFootprints;
+
+    // Flood scratch; a texel's distance is valid where its stamp is current,
+    // so nothing is cleared per flood
+    std::vector<float> m_distance;
+    std::vector<uint32_t> m_stamp;
+    uint32_t m_currentStamp;
+    std::vector<FrontierEntry> m_frontier;
+
+    int m_dirtyMinX, m_dirtyMinZ, m_dirtyMaxX, m_dirtyMaxZ;
+    int m_lastFloods;
+    int m_lastRemovals;
+    int m_lastTexels;
+
+    bool makeKey(const PointLight& light, Key& key) const;
+    void flood(const Key& key, Source& source);
+    void remove(Source& source);
+    void markDirty(const Source& source);
+};
+
+#endif // LIGHTGRID_H
@@ -0,0 +1,430 @@
+#include "LightmapBaker.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+    const char kMagic[4] = { 'M', 'Z', 'L', 'M' };
+    const uint32_t kFormatVersion = 1;  // Bump when the bake itself changes
+
+    // On-disk header, followed by width * height * 4 floats
+    struct CacheHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t seed;
+        int32_t mazeWidth;
+        int32_t mazeHeight;
+        int32_t width;
+        int32_t height;
+        uint32_t reserved;
+        uint64_t lightingHash;
+    };
+
+    // Rays per texel are stratified on a kStrata x kStrata grid
+    const int kStrata = 8;
+    static_assert(kStrata * kStrata == LightmapBaker::kSamplesPerTexel, "Samples must fill the strata");
+
+    // Surfaces per ThreadPool task
+    const int kSurfaceGrain = 8;
+
+    // Rays start this far off their surface so they do not hit it again
+    const float kSurfaceOffset = 1e-3f;
+    // Edge texels sample this fraction of their quad in from the edge
+    const float kEdgeInset = 1e-3f;
+    // Geometry this close only partly occludes the ambient light
+    const float kOcclusionDistance = 1.5f;
+    // Fraction of the light a surface passes on; the textures are mid-grey stone
+    const float kBounceAlbedo = 0.4f;
+    // Longer than any ray inside the enclosed maze needs
+    const float kMaxRayDistance = 1000.0f;
+    const float kNoHit = 1e30f;
+
+    // FNV-1a, 64-bit
+    uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    uint64_t hashLighting(const LightmapLighting& lighting) {
+        const float values[] = {
+            lighting.ambient.x, lighting.ambient.y, lighting.ambient.z,
+            lighting.overheadColor.x, lighting.overheadColor.y, lighting.overheadColor.z,
+            lighting.overheadDirection.x, lighting.overheadDirection.y, lighting.overheadDirection.z,
+            lighting.portalPosition.x, lighting.portalPosition.y, lighting.portalPosition.z,
+            lighting.portalRadius, lighting.portalStrength, Maze::kLightmapTexelsPerUnit
+        };
+        return hashBytes(14695981039346656037ull, values, sizeof(values));
+    }
+
+    // The maze cells, one byte each (1 = wall), so tracing does not chase a vector of vectors
+    struct Grid {
+        std::vector<unsigned char> cells;
+        int width;
+        int height;
+
+        explicit Grid(const Maze& maze) : width(maze.getWidth()), height(maze.getHeight()) {
+            cells.resize(static_cast<size_t>(width) * height);
+            for (int z = 0; z < height; ++z) {
+                for (int x = 0; x < width; ++x) {
+                    cells[z * width + x] = maze.getCellType(x, z) != 0 ? 1 : 0;
+                }
+            }
+        }
+
+        bool isWall(int x, int z) const {
+            if (x < 0 || x >= width || z < 0 || z >= height) return true;
+            return cells[z * width + x] != 0;
+        }
+    };
+
+    struct Hit {
+        float distance;
+        Vector3 position;
+        Vector3 normal;
+    };
+
+    /**
+     * @brief Nearest surface along origin + direction * t, for t < maxDistance
+     *
+     * The ray walks the cells it crosses in the ground plane until it enters
+     * a wall or reaches the floor or ceiling plane. Must start in an open
+     * cell between the two planes; direction must be unit length.
+     */
+    bool trace(const Grid& grid, const Vector3& origin, const Vector3& direction, float maxDistance, Hit& hit) {
+        const float cellSize = Maze::kCellSize;
+
+        float planeT = kNoHit;
+        Vector3 planeNormal;
+        if (direction.y > 1e-6f) {
+            planeT = (Maze::kWallHeight - origin.y) / direction.y;
+            planeNormal = Vector3(0.0f, -1.0f, 0.0f);
+        }
+        else if (direction.y < -1e-6f) {
+            planeT = -origin.y / direction.y;
+            planeNormal = Vector3(0.0f, 1.0f, 0.0f);
+        }
+        float limit = std::min(planeT, maxDistance);
+
+        float gridX = origin.x / cellSize;
+        float gridZ = origin.z / cellSize;
+        int cellX = static_cast<int>(std::floor(gridX));
+        int cellZ = static_cast<int>(std::floor(gridZ));
+        int stepX = direction.x < 0.0f ? -1 : 1;
+        int stepZ = direction.z < 0.0f ? -1 : 1;
+        float deltaX = cellSize / std::max(std::fabs(direction.x), 1e-6f);
+        float deltaZ = cellSize / std::max(std::fabs(direction.z), 1e-6f);
+        float sideX = (stepX < 0 ? gridX - cellX : cellX + 1 - gridX) * deltaX;
+        float sideZ = (stepZ < 0 ? gridZ - cellZ : cellZ + 1 - gridZ) * deltaZ;
+
+        // The grid's outside counts as wall, so the walk always ends
+        for (;;) {
+            bool crossX = sideX < sideZ;
+            float t = crossX ? sideX : sideZ;
+            if (t >= limit) {
+                break;
+            }
+
+            if (crossX) {
+                cellX += stepX;
+                sideX += deltaX;
+            }
+            else {
+                cellZ += stepZ;
+                sideZ += deltaZ;
+            }
+
+            if (grid.isWall(cellX, cellZ)) {
+                hit.distance = t;
+                hit.position = origin + direction * t;
+                hit.normal = crossX ? Vector3(static_cast<float>(-stepX), 0.0f, 0.0f)
+                                    : Vector3(0.0f, 0.0f, static_cast<float>(-stepZ));
+                return true;
+            }
+        }
+
+        if (planeT < maxDistance) {
+            hit.distance = planeT;
+            hit.position = origin + direction * planeT;
+            hit.normal = planeNormal;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Light reaching a surface point straight from the sources
+     * @param overhead Overhead light (unshadowed, as the shader applies it)
+     * @param portal Portal intensity, zero where a wall is in the way
+     */
+    void directLight(const Grid& grid, const LightmapLighting& lighting, const Vector3& position,
+                     const Vector3& normal, Vector3& overhead, float& portal) {
+        overhead = lighting.overheadColor * std::max(normal.dot(lighting.overheadDirection), 0.0f);
+        portal = 0.0f;
+
+        Vector3 toPortal = lighting.portalPosition - position;
+        float distance = toPortal.length();
+        if (distance <= 0.0f || distance >= lighting.portalRadius) {
+            return;
+        }
+        Vector3 direction = toPortal * (1.0f / distance);
+        float cosine = normal.dot(direction);
+        if (cosine <= 0.0f) {
+            return;
+        }
+
+        // The portal stands on the floor, so stop the shadow ray just short of it
+        Hit hit;
+        if (trace(grid, position + normal * kSurfaceOffset, direction, distance - 0.05f, hit)) {
+            return;
+        }
+
+        // Same falloff as fragment.glsl: quadratic, zero at the radius
+        float falloff = 1.0f - distance / lighting.portalRadius;
+        portal = lighting.portalStrength * cosine * falloff * falloff;
+    }
+
+    // xorshift32; each texel seeds its own so results do not depend on thread scheduling
+    struct Random {
+        uint32_t state;
+
+        Random(uint32_t surface, uint32_t texel) {
+            uint32_t h = surface * 73856093u ^ texel * 19349663u;
+            h ^= h >> 13;
+            h *= 0x5bd1e995u;
+            h ^= h >> 15;
+            state = h | 1u;
+        }
+
+        float next() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return (state >> 8) * (1.0f / 16777216.0f);
+        }
+    };
+
+    /**
+     * @brief Where texel i of count samples along its axis, 0..1
+     *
+     * The ends are the quad's edges, pulled in a hair so that a ray from
+     * a corner starts in the open cell rather than on the wall beside it.
+     */
+    float latticePosition(int i, int count) {
+        if (count < 2) return 0.5f;
+        float position = static_cast<float>(i) / (count - 1);
+        return std::max(kEdgeInset, std::min(position, 1.0f - kEdgeInset));
+    }
+
+    float* texelAt(Lightmap& lightmap, int x, int y) {
+        return &lightmap.texels[(static_cast<size_t>(y) * lightmap.width + x) * 4];
+    }
+
+    void bakeSurface(const Grid& grid, const LightmapLighting& lighting, const LightmapSurface& surface,
+                     uint32_t surfaceIndex, Lightmap& lightmap) {
+        const Vector3 tangent = surface.uAxis.normalize();
+        const Vector3 bitangent = surface.vAxis.normalize();
+        const Vector3& normal = surface.normal;
+
+        // Wall tops face the space above the ceiling, which nothing sees from inside
+        const bool traced = !(normal.y > 0.5f && surface.origin.y >= Maze::kWallHeight);
+        const float sampleScale = 1.0f / LightmapBaker::kSamplesPerTexel;
+
+        for (int j = 0; j < surface.texelsY; ++j) {
+            for (int i = 0; i < surface.texelsX; ++i) {
+                Vector3 position = surface.origin +
+                    surface.uAxis * latticePosition(i, surface.texelsX) +
+                    surface.vAxis * latticePosition(j, surface.texelsY);
+
+                Vector3 overhead;
+                float portal;
+                directLight(grid, lighting, position, normal, overhead, portal);
+
+                float openness = static_cast<float>(LightmapBaker::kSamplesPerTexel);
+                Vector3 bounce;
+                float portalBounce = 0.0f;
+                if (traced) {
+                    openness = 0.0f;
+                    Random random(surfaceIndex, static_cast<uint32_t>(j * surface.texelsX + i));
+                    Vector3 origin = position + normal * kSurfaceOffset;
+
+                    // Cosine-weighted, so each ray's share of the irradiance is equal
+                    for (int stratumY = 0; stratumY < kStrata; ++stratumY) {
+                        for (int stratumX = 0; stratumX < kStrata; ++stratumX) {
+                            float u = (stratumX + random.next()) / kStrata;
+                            float v = (stratumY + random.next()) / kStrata;
+                            float phi = static_cast<float>(2.0 * M_PI) * u;
+                            float radius = std::sqrt(v);
+                            Vector3 direction = tangent * (radius * std::cos(phi)) +
+                                bitangent * (radius * std::sin(phi)) +
+                                normal * std::sqrt(std::max(1.0f - v, 0.0f));
+
+                            Hit hit;
+                            if (!trace(grid, origin, direction, kMaxRayDistance, hit)) {
+                                openness += 1.0f;
+                                continue;
+                            }
+                            openness += std::min(hit.distance / kOcclusionDistance, 1.0f);
+
+                            Vector3 hitOverhead;
+                            float hitPortal;
+                            directLight(grid, lighting, hit.position, hit.normal, hitOverhead, hitPortal);
+                            bounce += hitOverhead;
+                            portalBounce += hitPortal;
+                        }
+                    }
+                }
+
+                Vector3 light = lighting.ambient * (openness * sampleScale) + overhead +
+                    bounce * (kBounceAlbedo * sampleScale);
+                float* texel = texelAt(lightmap, surface.atlasX + 1 + i, surface.atlasY + 1 + j);
+                texel[0] = light.x;
+                texel[1] = light.y;
+                texel[2] = light.z;
+                texel[3] = portal + portalBounce * kBounceAlbedo * sampleScale;
+            }
+        }
+
+        // Border texels repeat the nearest inside texel
+        for (int j = -1; j <= surface.texelsY; ++j) {
+            for (int i = -1; i <= surface.texelsX; ++i) {
+                if (i >= 0 && i < surface.texelsX && j >= 0 && j < surface.texelsY) continue;
+                int insideX = std::max(0, std::min(i, surface.texelsX - 1));
+                int insideY = std::max(0, std::min(j, surface.texelsY - 1));
+                std::memcpy(texelAt(lightmap, surface.atlasX + 1 + i, surface.atlasY + 1 + j),
+                    texelAt(lightmap, surface.atlasX + 1 + insideX, surface.atlasY + 1 + insideY), 4 * sizeof(float));
+            }
+        }
+    }
+}
+
+LightmapBaker::LightmapBaker(ThreadPool* pool, const std::string& cacheDirectory)
+    : m_pool(pool),
+      m_directory(cacheDirectory) {}
+
+void LightmapBaker::loadOrBake(const Maze& maze, unsigned int seed, const LightmapLighting& lighting, Lightmap& lightmap) {
+    uint64_t lightingHash = hashLighting(lighting);
+    std::string path = pathForSeed(seed);
+    if (load(path, maze, seed, lightingHash, lightmap)) {
+        std::cout << "Lightmap: loaded " << lightmap.width << "x" << lightmap.height << " from " << path << std::endl;
+        return;
+    }
+
+    bake(maze, lighting, lightmap);
+    store(path, maze, seed, lightingHash, lightmap);
+}
+
+void LightmapBaker::bake(const Maze& maze, const LightmapLighting& lighting, Lightmap& lightmap) const {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    lightmap.width = maze.getLightmapWidth();
+    lightmap.height = maze.getLightmapHeight();
+    lightmap.texels.assign(static_cast<size_t>(lightmap.width) * lightmap.height * 4, 0.0f);
+
+    Grid grid(maze);
+    const std::vector<LightmapSurface>& surfaces = maze.getLightmapSurfaces();
+    auto bakeRange = [&](int begin, int end) {
+        for (int s = begin; s < end; ++s) {
+            bakeSurface(grid, lighting, surfaces[s], static_cast<uint32_t>(s), lightmap);
+        }
+    };
+
+    // Tiles never overlap, so surfaces can be baked in any order
+    if (m_pool) {
+        m_pool->parallelFor(static_cast<int>(surfaces.size()), kSurfaceGrain, bakeRange);
+    }
+    else {
+        bakeRange(0, static_cast<int>(surfaces.size()));
+    }
+
+    float milliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Lightmap: baked " << lightmap.width << "x" << lightmap.height << " (" << surfaces.size()
+        << " surfaces) in " << milliseconds << " ms on " << (m_pool ? m_pool->getThreadCount() + 1 : 1)
+        << " thread(s)" << std::endl;
+}
+
+std::string LightmapBaker::pathForSeed(unsigned int seed) const {
+    std::ostringstream name;
+    name << m_directory << "/maze_" << seed << ".bin";
+    return name.str();
+}
+
+bool LightmapBaker::load(const std::string& path, const Maze& maze, unsigned int seed, uint64_t lightingHash,
+                         Lightmap& lightmap) const {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // A different maze size or lighting under the same seed is simply rebaked
+    CacheHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    bool valid = file &&
+        std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+        header.version == kFormatVersion &&
+        header.seed == seed &&
+        header.mazeWidth == maze.getWidth() &&
+        header.mazeHeight == maze.getHeight() &&
+        header.width == maze.getLightmapWidth() &&
+        header.height == maze.getLightmapHeight() &&
+        header.lightingHash == lightingHash;
+    if (!valid) {
+        return false;
+    }
+
+    lightmap.width = header.width;
+    lightmap.height = header.height;
+    lightmap.texels.resize(static_cast<size_t>(lightmap.width) * lightmap.height * 4);
+    file.read(reinterpret_cast<char*>(lightmap.texels.data()), lightmap.texels.size() * sizeof(float));
+    return static_cast<bool>(file);
+}
+
+void LightmapBaker::store(const std::string& path, const Maze& maze, unsigned int seed, uint64_t lightingHash,
+                          const Lightmap& lightmap) const {
+#ifdef _WIN32
+    int result = _mkdir(m_directory.c_str());
+#else
+    int result = mkdir(m_directory.c_str(), 0755);
+#endif
+    if (result != 0 && errno != EEXIST) {
+        std::cerr << "Failed to create lightmap cache directory: " << m_directory << std::endl;
+        return;
+    }
+
+    CacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kFormatVersion;
+    header.seed = seed;
+    header.mazeWidth = maze.getWidth();
+    header.mazeHeight = maze.getHeight();
+    header.width = lightmap.width;
+    header.height = lightmap.height;
+    header.lightingHash = lightingHash;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to write lightmap cache entry: " << path << std::endl;
+        return;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(lightmap.texels.data()), lightmap.texels.size() * sizeof(float));
+}
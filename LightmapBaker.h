@@ -0,0 +1,89 @@
+#ifndef LIGHTMAPBAKER_H
+#define LIGHTMAPBAKER_H
+
+#include "Maze.h"
+#include "ThreadPool.h"
+#include "Vector3.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The static lights a lightmap holds, in the surface shader's terms
+ *
+ * Colours are irradiance: the shader multiplies the baked rgb by the
+ * surface texture, and the baked portal intensity by the portal colour.
+ */
+struct LightmapLighting {
+    Vector3 ambient;            // material.ambient * lightColor
+    Vector3 overheadColor;      // material.diffuse * lightColor
+    Vector3 overheadDirection;  // Towards the overhead light, normalized
+    Vector3 portalPosition;
+    float portalRadius;
+    float portalStrength;       // Scale of the portal light before its colour
+};
+
+/**
+ * @brief A baked lightmap in Maze's atlas layout: RGBA floats, bottom row first
+ *
+ * rgb is ambient light (darkened where surfaces are enclosed) plus the
+ * overhead light and its bounce; a is the portal light's intensity with
+ * walls casting shadows, plus its bounce.
+ */
+struct Lightmap {
+    int width = 0;
+    int height = 0;
+    std::vector<float> texels;  // width * height * 4
+};
+
+/**
+ * @class LightmapBaker
+ * @brief Ray traces the static light of a maze into its lightmap atlas, and caches it
+ *
+ * Every texel of every quad in Maze::getLightmapSurfaces() casts
+ * kSamplesPerTexel cosine-weighted rays through the grid (a DDA over the
+ * cells between the floor and ceiling planes, as ObservationRenderer
+ * walks it). Their hit distances give ambient occlusion; the direct light
+ * where they land, times a grey albedo, gives one bounce. Direct portal
+ * light is shadowed by a ray to the portal; the overhead light stays
+ * unshadowed, as the shader has always applied it. Surfaces are spread
+ * over the ThreadPool, and each texel draws its own random sequence, so
+ * a bake comes out the same with any number of threads.
+ *
+ * Results are stored per maze seed in the cache directory, with the maze
+ * size and a hash of the lighting so a change to either rebakes.
+ */
+class LightmapBaker {
+public:
+    static const int kSamplesPerTexel = 64;
+
+    /**
+     * @param pool Workers for the bake; nullptr bakes on the caller only
+     * @param cacheDirectory Folder for cached lightmaps (created on first store)
+     */
+    explicit LightmapBaker(ThreadPool* pool = nullptr, const std::string& cacheDirectory = "lightmapcache");
+
+    /**
+     * @brief The maze's lightmap: from the cache if it matches, baked (and stored) otherwise
+     *
+     * Every new seed adds a file of about 1 MB, so use bake() for seeds
+     * that will not come round again.
+     * @param seed The seed the maze was built from
+     */
+    void loadOrBake(const Maze& maze, unsigned int seed, const LightmapLighting& lighting, Lightmap& lightmap);
+
+    /**
+     * @brief Bake without the cache
+     */
+    void bake(const Maze& maze, const LightmapLighting& lighting, Lightmap& lightmap) const;
+
+private:
+    ThreadPool* m_pool;
+    std::string m_directory;
+
+    std::string pathForSeed(unsigned int seed) const;
+    bool load(const std::string& path, const Maze& maze, unsigned int seed, uint64_t lightingHash, Lightmap& lightmap) const;
+    void store(const std::string& path, const Maze& maze, unsigned int seed, uint64_t lightingHash, const Lightmap& lightmap) const;
+};
+
+#endif // LIGHTMAPBAKER_H
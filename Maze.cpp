@@ -2,9 +2,18 @@
 #include <cmath>
 #include <algorithm>
 #include<stack>
+#include <queue>
 #include <iostream>
+#include <ctime>
 
-Maze::Maze(int width, int height) : m_width(width), m_height(height) {
+constexpr float Maze::kCellSize;
+constexpr float Maze::kWallHeight;
+constexpr float Maze::kTeleportHeight;
+constexpr float Maze::kTeleportRadius;
+constexpr float Maze::kLightmapTexelsPerUnit;
+
+Maze::Maze(int width, int height, unsigned int seed)
+	: m_width(width), m_height(height), m_lightmapWidth(0), m_lightmapHeight(0) {
 	// Ensure dimensions are odd for this algorithm to work best
 	if (m_width % 2 == 0) m_width++;
 	if (m_height % 2 == 0) m_height++;
@@ -12,7 +21,7 @@ Maze::Maze(int width, int height) : m_width(width), m_height(height) {
 	m_grid.resize(m_height, std::vector<int>(m_width, 1)); // Fill with walls (1)
 
 	// Seed random
-	std::srand(static_cast<unsigned int>(std::time(nullptr)));
+	std::srand(seed != 0 ? seed : static_cast<unsigned int>(std::time(nullptr)));
 
 	generateMaze();
 }
@@ -70,21 +79,77 @@ void Maze::generateMaze() {
 
 	// Ensure Exit is open
 	m_grid[m_endCell.second][m_endCell.first] = 0;
+
+	layoutLightmap();
 }
 
 void Maze::generateMeshes(Mesh& wallMesh, Mesh& floorMesh, Mesh& ceilingMesh) {
-	std::vector<Vertex> wallVertices;
-	std::vector<unsigned int> wallIndices;
-	std::vector<Vertex> floorVertices;
-	std::vector<unsigned int> floorIndices;
-	std::vector<Vertex> ceilingVertices;
-	std::vector<unsigned int> ceilingIndices;
+	SurfaceBuffers walls;
+	SurfaceBuffers floors;
+	SurfaceBuffers ceilings;
 
-	const float cellSize = 2.0f;
-	const float wallHeight = 3.0f;
+	buildSurfaces(walls, floors, ceilings, MazeMaterials());
 
-	for (int i = 0; i < m_height; ++i) {
-		for (int j = 0; j < m_width; ++j) {
+	wallMesh.initialize(walls.vertices, walls.indices);
+	floorMesh.initialize(floors.vertices, floors.indices);
+	ceilingMesh.initialize(ceilings.vertices, ceilings.indices);
+}
+
+void Maze::generateCombinedMesh(Mesh& mesh, const MazeMaterials& materials) {
+	SurfaceBuffers surfaces;
+	buildSurfaces(surfaces, surfaces, surfaces, materials);
+	mesh.initialize(surfaces.vertices, surfaces.indices);
+}
+
+void Maze::generateChunkMeshes(std::vector<MazeChunk>& chunks, const MazeMaterials& materials, int chunkCells) {
+	const float cellSize = kCellSize;
+	const float wallHeight = kWallHeight;
+
+	chunks.clear();
+	chunkCells = std::max(chunkCells, 1);
+
+	for (int z = 0; z < m_height; z += chunkCells) {
+		for (int x = 0; x < m_width; x += chunkCells) {
+			int endX = std::min(x + chunkCells, m_width);
+			int endZ = std::min(z + chunkCells, m_height);
+
+			SurfaceBuffers surfaces;
+			buildSurfaces(surfaces, surfaces, surfaces, materials, x, z, endX, endZ);
+			if (surfaces.indices.empty()) continue;
+
+			MazeChunk chunk;
+			chunk.mesh.initialize(surfaces.vertices, surfaces.indices);
+			chunk.bounds = AABB(Vector3(x * cellSize, 0.0f, z * cellSize),
+				Vector3(endX * cellSize, wallHeight, endZ * cellSize));
+			chunks.push_back(std::move(chunk));
+		}
+	}
+}
+
+int Maze::getWallVariant(int x, int z, int variantCount) const {
+	if (variantCount <= 1) return 0;
+
+	// Stable per-cell hash so a cell keeps its look when meshes are rebuilt
+	unsigned int h = static_cast<unsigned int>(x) * 73856093u ^ static_cast<unsigned int>(z) * 19349663u;
+	h ^= h >> 13;
+	h *= 0x5bd1e995u;
+	h ^= h >> 15;
+	return static_cast<int>(h % static_cast<unsigned int>(variantCount));
+}
+
+void Maze::buildSurfaces(SurfaceBuffers& walls, SurfaceBuffers& floors, SurfaceBuffers& ceilings,
+	const MazeMaterials& materials, int firstX, int firstZ, int endX, int endZ) const {
+	const float cellSize = kCellSize;
+	const float wallHeight = kWallHeight;
+
+	const float floorLayer = static_cast<float>(materials.floorLayer);
+	const float ceilingLayer = static_cast<float>(materials.ceilingLayer);
+
+	if (endX < 0) endX = m_width;
+	if (endZ < 0) endZ = m_height;
+
+	for (int i = firstZ; i < endZ; ++i) {
+		for (int j = firstX; j < endX; ++j) {
 			float x = j * cellSize;
 			float z = i * cellSize;
 
@@ -96,53 +161,175 @@ void Maze::generateMeshes(Mesh& wallMesh, Mesh& floorMesh, Mesh& ceilingMesh) {
 
 			if (m_grid[i][j] == 1) {
 				// Wall Cell
+				float wallLayer = static_cast<float>(materials.wallLayer +
+					getWallVariant(j, i, materials.wallVariantCount));
 
 				// NORTH WALL (Face -Z)
 				// Generated Left-to-Right (c00 to c10)
-				if (i == 0 || m_grid[i - 1][j] == 0)
-					addWallQuad(wallVertices, wallIndices, c10, c00, wallHeight, Vector3(0, 0, -1));
+				if (isOpen(j, i - 1)) {
+					addWallQuad(walls.vertices, walls.indices, c10, c00, wallHeight, Vector3(0, 0, -1), wallLayer);
+					mapToLightmap(walls.vertices, j, i, FACE_NORTH);
+				}
 
 				// SOUTH WALL (Face +Z)
 				// Generated Left-to-Right (c01 to c11)
-				if (i == m_height - 1 || m_grid[i + 1][j] == 0)
-					addWallQuad(wallVertices, wallIndices, c01, c11, wallHeight, Vector3(0, 0, 1));
+				if (isOpen(j, i + 1)) {
+					addWallQuad(walls.vertices, walls.indices, c01, c11, wallHeight, Vector3(0, 0, 1), wallLayer);
+					mapToLightmap(walls.vertices, j, i, FACE_SOUTH);
+				}
 
 				// WEST WALL (Face -X)
 				// Generated Left-to-Right (c01 to c00)
-				if (j == 0 || m_grid[i][j - 1] == 0)
-					addWallQuad(wallVertices, wallIndices, c00, c01, wallHeight, Vector3(-1, 0, 0));
+				if (isOpen(j - 1, i)) {
+					addWallQuad(walls.vertices, walls.indices, c00, c01, wallHeight, Vector3(-1, 0, 0), wallLayer);
+					mapToLightmap(walls.vertices, j, i, FACE_WEST);
+				}
 
 				// EAST WALL (Face +X)
 				// Generated Left-to-Right (c11 to c10)
-				if (j == m_width - 1 || m_grid[i][j + 1] == 0)
-					addWallQuad(wallVertices, wallIndices, c11, c10, wallHeight, Vector3(1, 0, 0));
+				if (isOpen(j + 1, i)) {
+					addWallQuad(walls.vertices, walls.indices, c11, c10, wallHeight, Vector3(1, 0, 0), wallLayer);
+					mapToLightmap(walls.vertices, j, i, FACE_EAST);
+				}
 
-				addTopFace(wallVertices, wallIndices, x, z, cellSize, wallHeight);
+				addTopFace(walls.vertices, walls.indices, x, z, cellSize, wallHeight, wallLayer);
+				mapToLightmap(walls.vertices, j, i, FACE_TOP);
 			}
 			else {
 				// Empty Cell
-				addFloor(floorVertices, floorIndices, x, z, cellSize);
-				addCeiling(ceilingVertices, ceilingIndices, x, z, cellSize, wallHeight);
+				addFloor(floors.vertices, floors.indices, x, z, cellSize, floorLayer);
+				mapToLightmap(floors.vertices, j, i, FACE_FLOOR);
+				addCeiling(ceilings.vertices, ceilings.indices, x, z, cellSize, wallHeight, ceilingLayer);
+				mapToLightmap(ceilings.vertices, j, i, FACE_CEILING);
+			}
+		}
+	}
+}
+
+void Maze::layoutLightmap() {
+	const float cellSize = kCellSize;
+	const float wallHeight = kWallHeight;
+	// Texels sit on a lattice that includes the quad's edges, hence the extra one
+	const int cellTexels = static_cast<int>(cellSize * kLightmapTexelsPerUnit + 0.5f) + 1;
+	const int wallTexels = static_cast<int>(wallHeight * kLightmapTexelsPerUnit + 0.5f) + 1;
+
+	m_lightmapSurfaces.clear();
+	m_lightmapIndex.assign(static_cast<size_t>(m_width) * m_height * FACE_COUNT, -1);
+
+	// Same quads, corners and texture directions as buildSurfaces
+	auto addSurface = [&](int x, int z, CellFace face, const Vector3& origin, const Vector3& uAxis,
+		const Vector3& vAxis, const Vector3& normal, int texelsX, int texelsY) {
+		LightmapSurface surface;
+		surface.origin = origin;
+		surface.uAxis = uAxis;
+		surface.vAxis = vAxis;
+		surface.normal = normal;
+		surface.atlasX = 0;
+		surface.atlasY = 0;
+		surface.texelsX = texelsX;
+		surface.texelsY = texelsY;
+		m_lightmapIndex[(z * m_width + x) * FACE_COUNT + face] = static_cast<int>(m_lightmapSurfaces.size());
+		m_lightmapSurfaces.push_back(surface);
+	};
+
+	const Vector3 up(0.0f, wallHeight, 0.0f);
+	for (int i = 0; i < m_height; ++i) {
+		for (int j = 0; j < m_width; ++j) {
+			float x = j * cellSize;
+			float z = i * cellSize;
+
+			if (m_grid[i][j] == 1) {
+				if (isOpen(j, i - 1))
+					addSurface(j, i, FACE_NORTH, Vector3(x + cellSize, 0, z), Vector3(-cellSize, 0, 0), up,
+						Vector3(0, 0, -1), cellTexels, wallTexels);
+				if (isOpen(j, i + 1))
+					addSurface(j, i, FACE_SOUTH, Vector3(x, 0, z + cellSize), Vector3(cellSize, 0, 0), up,
+						Vector3(0, 0, 1), cellTexels, wallTexels);
+				if (isOpen(j - 1, i))
+					addSurface(j, i, FACE_WEST, Vector3(x, 0, z), Vector3(0, 0, cellSize), up,
+						Vector3(-1, 0, 0), cellTexels, wallTexels);
+				if (isOpen(j + 1, i))
+					addSurface(j, i, FACE_EAST, Vector3(x + cellSize, 0, z + cellSize), Vector3(0, 0, -cellSize), up,
+						Vector3(1, 0, 0), cellTexels, wallTexels);
+				addSurface(j, i, FACE_TOP, Vector3(x, wallHeight, z), Vector3(cellSize, 0, 0), Vector3(0, 0, cellSize),
+					Vector3(0, 1, 0), 1, 1);
+			}
+			else {
+				addSurface(j, i, FACE_FLOOR, Vector3(x, 0, z), Vector3(cellSize, 0, 0), Vector3(0, 0, cellSize),
+					Vector3(0, 1, 0), cellTexels, cellTexels);
+				addSurface(j, i, FACE_CEILING, Vector3(x, wallHeight, z), Vector3(cellSize, 0, 0), Vector3(0, 0, cellSize),
+					Vector3(0, -1, 0), cellTexels, cellTexels);
 			}
 		}
 	}
 
-	wallMesh.initialize(wallVertices, wallIndices);
-	floorMesh.initialize(floorVertices, floorIndices);
-	ceilingMesh.initialize(ceilingVertices, ceilingIndices);
+	// Shelf packing, tallest tiles first so each shelf wastes little height.
+	// The width is the power of two nearest a square atlas
+	std::vector<int> order(m_lightmapSurfaces.size());
+	size_t area = 0;
+	for (size_t s = 0; s < order.size(); ++s) {
+		order[s] = static_cast<int>(s);
+		area += static_cast<size_t>(m_lightmapSurfaces[s].texelsX + 2) * (m_lightmapSurfaces[s].texelsY + 2);
+	}
+	std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+		return m_lightmapSurfaces[a].texelsY > m_lightmapSurfaces[b].texelsY;
+	});
+
+	m_lightmapWidth = 64;
+	while (static_cast<size_t>(m_lightmapWidth) * m_lightmapWidth < area) {
+		m_lightmapWidth *= 2;
+	}
+
+	int shelfX = 0;
+	int shelfY = 0;
+	int shelfHeight = 0;
+	for (int s : order) {
+		LightmapSurface& surface = m_lightmapSurfaces[s];
+		int tileWidth = surface.texelsX + 2;
+		int tileHeight = surface.texelsY + 2;
+		if (shelfX + tileWidth > m_lightmapWidth) {
+			shelfX = 0;
+			shelfY += shelfHeight;
+			shelfHeight = 0;
+		}
+		surface.atlasX = shelfX;
+		surface.atlasY = shelfY;
+		shelfX += tileWidth;
+		shelfHeight = std::max(shelfHeight, tileHeight);
+	}
+	m_lightmapHeight = shelfY + shelfHeight;
+}
+
+void Maze::mapToLightmap(std::vector<Vertex>& vertices, int x, int z, CellFace face) const {
+	int index = m_lightmapIndex[(z * m_width + x) * FACE_COUNT + face];
+	if (index < 0 || vertices.size() < 4) return;
+
+	// The quad's texture coordinates run 0..1 from its first texel's centre to its last
+	const LightmapSurface& surface = m_lightmapSurfaces[index];
+	for (size_t v = vertices.size() - 4; v < vertices.size(); ++v) {
+		Vertex& vertex = vertices[v];
+		vertex.lightmapX = (surface.atlasX + 1.5f + vertex.texCoordX * (surface.texelsX - 1)) / m_lightmapWidth;
+		vertex.lightmapY = (surface.atlasY + 1.5f + vertex.texCoordY * (surface.texelsY - 1)) / m_lightmapHeight;
+	}
+}
+
+AABB Maze::getTeleportBounds() const {
+	Vector3 center = getExitPosition();
+	return AABB(Vector3(center.x - kTeleportRadius, 0.0f, center.z - kTeleportRadius),
+		Vector3(center.x + kTeleportRadius, kTeleportHeight, center.z + kTeleportRadius));
 }
 
 void Maze::generateTeleportMesh(Mesh& mesh) {
 	std::vector<Vertex> vertices;
 	std::vector<unsigned int> indices;
 
-	const float height = 2.5f;
+	const float height = kTeleportHeight;
 	const float cylinderRadius = 0.8f;
-	const float platformRadius = 1.2f;  // Ground platform
+	const float platformRadius = kTeleportRadius;  // Ground platform
 	const int segments = 32; // Higher for smoother appearance
 
 	// Get Exit Center
-	float cellSize = 2.0f;
+	const float cellSize = kCellSize;
 	float cx = (m_endCell.first + 0.5f) * cellSize;
 	float cz = (m_endCell.second + 0.5f) * cellSize;
 
@@ -263,7 +450,7 @@ void Maze::generateTeleportMesh(Mesh& mesh) {
 }
 
 void Maze::addWallQuad(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
-	const Vector3& bottomLeft, const Vector3& bottomRight, float height, const Vector3& normal) {
+	const Vector3& bottomLeft, const Vector3& bottomRight, float height, const Vector3& normal, float layer) const {
 
 	unsigned int baseIndex = static_cast<unsigned int>(vertices.size());
 	Vector3 up(0, 1, 0);
@@ -277,10 +464,10 @@ void Maze::addWallQuad(std::vector<Vertex>& vertices, std::vector<unsigned int>&
 	float texRepeat = 1.0f;
 
 	// Add Vertices (Standard UV mapping)
-	vertices.emplace_back(v0, normal, 0.0f, 0.0f);
-	vertices.emplace_back(v1, normal, texRepeat, 0.0f);
-	vertices.emplace_back(v2, normal, texRepeat, texRepeat);
-	vertices.emplace_back(v3, normal, 0.0f, texRepeat);
+	vertices.emplace_back(v0, normal, 0.0f, 0.0f, layer);
+	vertices.emplace_back(v1, normal, texRepeat, 0.0f, layer);
+	vertices.emplace_back(v2, normal, texRepeat, texRepeat, layer);
+	vertices.emplace_back(v3, normal, 0.0f, texRepeat, layer);
 
 	// Add Indices (Counter-Clockwise 0-1-2, 0-2-3)
 	indices.push_back(baseIndex + 0);
@@ -292,87 +479,87 @@ void Maze::addWallQuad(std::vector<Vertex>& vertices, std::vector<unsigned int>&
 }
 
 void Maze::addFloor(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
-	float x, float z, float cellSize) {
+	float x, float z, float cellSize, float layer) const {
 	unsigned int baseIndex = static_cast<unsigned int>(vertices.size());
 	Vector3 normal(0, 1, 0);  // Normal points UP
 
 	// Create floor quad at Y = 0
-	vertices.emplace_back(Vector3(x, 0, z), normal, 0.0f, 0.0f);
-	vertices.emplace_back(Vector3(x + cellSize, 0, z), normal, 1.0f, 0.0f);
-	vertices.emplace_back(Vector3(x + cellSize, 0, z + cellSize), normal, 1.0f, 1.0f);
-	vertices.emplace_back(Vector3(x, 0, z + cellSize), normal, 0.0f, 1.0f);
+	vertices.emplace_back(Vector3(x, 0, z), normal, 0.0f, 0.0f, layer);
+	vertices.emplace_back(Vector3(x + cellSize, 0, z), normal, 1.0f, 0.0f, layer);
+	vertices.emplace_back(Vector3(x + cellSize, 0, z + cellSize), normal, 1.0f, 1.0f, layer);
+	vertices.emplace_back(Vector3(x, 0, z + cellSize), normal, 0.0f, 1.0f, layer);
 
-	// Add indices (CCW when viewed from above)
+	// Add indices (CCW when viewed from above: 0-2-1, as the corners run clockwise)
 	indices.push_back(baseIndex + 0);
-	indices.push_back(baseIndex + 1);
 	indices.push_back(baseIndex + 2);
+	indices.push_back(baseIndex + 1);
 	indices.push_back(baseIndex + 0);
-	indices.push_back(baseIndex + 2);
 	indices.push_back(baseIndex + 3);
+	indices.push_back(baseIndex + 2);
 }
 
 void Maze::addCeiling(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
-	float x, float z, float cellSize, float ceilingHeight) {
+	float x, float z, float cellSize, float ceilingHeight, float layer) const {
 	unsigned int baseIndex = static_cast<unsigned int>(vertices.size());
 	Vector3 normal(0, -1, 0);  // Normal points DOWN
 
 	// Create ceiling quad at Y = ceilingHeight
-	vertices.emplace_back(Vector3(x, ceilingHeight, z), normal, 0.0f, 0.0f);
-	vertices.emplace_back(Vector3(x, ceilingHeight, z + cellSize), normal, 0.0f, 1.0f);
-	vertices.emplace_back(Vector3(x + cellSize, ceilingHeight, z + cellSize), normal, 1.0f, 1.0f);
-	vertices.emplace_back(Vector3(x + cellSize, ceilingHeight, z), normal, 1.0f, 0.0f);
+	vertices.emplace_back(Vector3(x, ceilingHeight, z), normal, 0.0f, 0.0f, layer);
+	vertices.emplace_back(Vector3(x, ceilingHeight, z + cellSize), normal, 0.0f, 1.0f, layer);
+	vertices.emplace_back(Vector3(x + cellSize, ceilingHeight, z + cellSize), normal, 1.0f, 1.0f, layer);
+	vertices.emplace_back(Vector3(x + cellSize, ceilingHeight, z), normal, 1.0f, 0.0f, layer);
 
-	// Add indices (CCW when viewed from below)
+	// Add indices (CCW when viewed from below: 0-2-1, as the corners run clockwise)
 	indices.push_back(baseIndex + 0);
-	indices.push_back(baseIndex + 1);
 	indices.push_back(baseIndex + 2);
+	indices.push_back(baseIndex + 1);
 	indices.push_back(baseIndex + 0);
-	indices.push_back(baseIndex + 2);
 	indices.push_back(baseIndex + 3);
+	indices.push_back(baseIndex + 2);
 }
 
 void Maze::addTopFace(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
-	float x, float z, float width, float height) {
+	float x, float z, float width, float height, float layer) const {
 	unsigned int baseIndex = static_cast<unsigned int>(vertices.size());
 	Vector3 normal(0.0f, 1.0f, 0.0f);
 
 	// Top Face (viewed from above)
-	vertices.emplace_back(Vector3(x, height, z), normal, 0.0f, 0.0f);
-	vertices.emplace_back(Vector3(x + width, height, z), normal, 1.0f, 0.0f);
-	vertices.emplace_back(Vector3(x + width, height, z + width), normal, 1.0f, 1.0f);
-	vertices.emplace_back(Vector3(x, height, z + width), normal, 0.0f, 1.0f);
+	vertices.emplace_back(Vector3(x, height, z), normal, 0.0f, 0.0f, layer);
+	vertices.emplace_back(Vector3(x + width, height, z), normal, 1.0f, 0.0f, layer);
+	vertices.emplace_back(Vector3(x + width, height, z + width), normal, 1.0f, 1.0f, layer);
+	vertices.emplace_back(Vector3(x, height, z + width), normal, 0.0f, 1.0f, layer);
 
-	// Standard CCW Winding
+	// CCW when viewed from above (the corners run clockwise)
 	indices.push_back(baseIndex + 0);
-	indices.push_back(baseIndex + 1);
 	indices.push_back(baseIndex + 2);
+	indices.push_back(baseIndex + 1);
 	indices.push_back(baseIndex + 0);
-	indices.push_back(baseIndex + 2);
 	indices.push_back(baseIndex + 3);
+	indices.push_back(baseIndex + 2);
 }
 
 void Maze::addBottomFace(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
-	float x, float z, float width, float height) {
+	float x, float z, float width, float height, float layer) const {
 	unsigned int baseIndex = static_cast<unsigned int>(vertices.size());
 	Vector3 normal(0.0f, -1.0f, 0.0f);
 
 	// Bottom Face
-	vertices.emplace_back(Vector3(x, 0.0f, z), normal, 0.0f, 0.0f);
-	vertices.emplace_back(Vector3(x, 0.0f, z + width), normal, 0.0f, 1.0f);
-	vertices.emplace_back(Vector3(x + width, 0.0f, z + width), normal, 1.0f, 1.0f);
-	vertices.emplace_back(Vector3(x + width, 0.0f, z), normal, 1.0f, 0.0f);
+	vertices.emplace_back(Vector3(x, 0.0f, z), normal, 0.0f, 0.0f, layer);
+	vertices.emplace_back(Vector3(x, 0.0f, z + width), normal, 0.0f, 1.0f, layer);
+	vertices.emplace_back(Vector3(x + width, 0.0f, z + width), normal, 1.0f, 1.0f, layer);
+	vertices.emplace_back(Vector3(x + width, 0.0f, z), normal, 1.0f, 0.0f, layer);
 
-	// Standard CCW Winding
+	// CCW when viewed from below (the corners run clockwise)
 	indices.push_back(baseIndex + 0);
-	indices.push_back(baseIndex + 1);
 	indices.push_back(baseIndex + 2);
+	indices.push_back(baseIndex + 1);
 	indices.push_back(baseIndex + 0);
-	indices.push_back(baseIndex + 2);
 	indices.push_back(baseIndex + 3);
+	indices.push_back(baseIndex + 2);
 }
 
 bool Maze::checkCollision(const Vector3& position, float radius) const {
-	const float cellSize = 2.0f;
+	const float cellSize = kCellSize;
 
 	// Simple bounds check with margin
 	if (position.x < radius || position.z < radius) {
@@ -439,7 +626,7 @@ bool Maze::checkCollision(const Vector3& position, float radius) const {
 }
 
 Vector3 Maze::getStartPosition() const {
-	const float cellSize = 2.0f;
+	const float cellSize = kCellSize;
 	// Center of the start cell
 	float centerX = (m_startCell.first + 0.5f) * cellSize;
 	float centerZ = (m_startCell.second + 0.5f) * cellSize;
@@ -447,9 +634,54 @@ Vector3 Maze::getStartPosition() const {
 }
 
 Vector3 Maze::getExitPosition() const {
-	const float cellSize = 2.0f;
+	const float cellSize = kCellSize;
 	// Center of the end cell
 	float centerX = (m_endCell.first + 0.5f) * cellSize;
 	float centerZ = (m_endCell.second + 0.5f) * cellSize;
 	return Vector3(centerX, 0.0f, centerZ);
-}
\ No newline at end of file
+}
+
+std::vector<Vector3> Maze::findPath() const {
+	const float cellSize = kCellSize;
+
+	// Breadth-first over path cells; prev holds the cell each one was reached from
+	std::vector<int> prev(m_width * m_height, -1);
+	int startIndex = m_startCell.second * m_width + m_startCell.first;
+	int endIndex = m_endCell.second * m_width + m_endCell.first;
+	prev[startIndex] = startIndex;
+
+	std::queue<int> open;
+	open.push(startIndex);
+
+	const int dirs[4][2] = { {0, -1}, {0, 1}, {-1, 0}, {1, 0} };
+	while (!open.empty() && prev[endIndex] == -1) {
+		int current = open.front();
+		open.pop();
+		int x = current % m_width;
+		int z = current / m_width;
+
+		for (const auto& dir : dirs) {
+			int nx = x + dir[0];
+			int nz = z + dir[1];
+			if (getCellType(nx, nz) != 0) continue;
+
+			int next = nz * m_width + nx;
+			if (prev[next] != -1) continue;
+
+			prev[next] = current;
+			open.push(next);
+		}
+	}
+
+	std::vector<Vector3> path;
+	if (prev[endIndex] == -1) {
+		return path;
+	}
+
+	for (int cell = endIndex; ; cell = prev[cell]) {
+		path.push_back(Vector3((cell % m_width + 0.5f) * cellSize, 0.0f, (cell / m_width + 0.5f) * cellSize));
+		if (cell == startIndex) break;
+	}
+	std::reverse(path.begin(), path.end());
+	return path;
+}
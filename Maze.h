@@ -4,23 +4,96 @@
 #include "Mesh.h"
 #include <vector>
 #include "Vector3.h"
+#include "SimdMath.h"
+
+/**
+ * @brief Texture array layers used by Maze::generateCombinedMesh
+ *
+ * Wall cells pick one of wallVariantCount consecutive layers starting at
+ * wallLayer, chosen per cell.
+ */
+struct MazeMaterials {
+	int floorLayer = 0;
+	int ceilingLayer = 0;
+	int wallLayer = 0;
+	int wallVariantCount = 1;
+};
+
+/**
+ * @brief One maze quad's place in the lightmap atlas
+ *
+ * The point at texture coordinates (s, t) of the quad is
+ * origin + uAxis * s + vAxis * t. Its tile starts at texel (atlasX, atlasY)
+ * and holds texelsX x texelsY texels inside a one-texel border. The
+ * texels sample evenly spaced points from edge to edge (a single texel
+ * samples the centre), so quads that meet share the light along the
+ * seam; the border repeats the edge so filtering never reaches a
+ * neighbouring tile.
+ */
+struct LightmapSurface {
+	Vector3 origin;
+	Vector3 uAxis;
+	Vector3 vAxis;
+	Vector3 normal;
+	int atlasX;
+	int atlasY;
+	int texelsX;
+	int texelsY;
+};
+
+/**
+ * @brief A square block of maze cells with its own mesh and bounds, for culling
+ */
+struct MazeChunk {
+	Mesh mesh;
+	AABB bounds;
+};
 
 class Maze {
 public:
-	Maze(int width, int height);
+	// seed 0 seeds from the clock; anything else gives a reproducible layout
+	Maze(int width, int height, unsigned int seed = 0);
 
 	// Generates a proper DFS maze with a guaranteed path
 	void generateMaze();
 
 	void generateMeshes(Mesh& wallMesh, Mesh& floorMesh, Mesh& ceilingMesh);
+
+	// Walls, floor and ceiling in one mesh; each vertex carries its material layer
+	void generateCombinedMesh(Mesh& mesh, const MazeMaterials& materials);
+
+	// Same geometry as generateCombinedMesh, split into chunkCells x chunkCells blocks
+	void generateChunkMeshes(std::vector<MazeChunk>& chunks, const MazeMaterials& materials, int chunkCells = 4);
 	bool checkCollision(const Vector3& position, float radius) const;
 
 	Vector3 getStartPosition() const;
 	Vector3 getExitPosition() const; // New method
 
+	// Shortest walk from start to exit as world-space cell centres (y = 0)
+	std::vector<Vector3> findPath() const;
+
 	int getWidth() const { return m_width; }
 	int getHeight() const { return m_height; }
 	void generateTeleportMesh(Mesh& mesh);
+	// Box around the teleport mesh, for culling
+	AABB getTeleportBounds() const;
+
+	// Which of variantCount wall materials the wall cell (x, z) uses; stable per cell
+	int getWallVariant(int x, int z, int variantCount) const;
+
+	// Every quad of the maze meshes in the lightmap atlas; their vertices carry matching coordinates
+	const std::vector<LightmapSurface>& getLightmapSurfaces() const { return m_lightmapSurfaces; }
+	int getLightmapWidth() const { return m_lightmapWidth; }
+	int getLightmapHeight() const { return m_lightmapHeight; }
+
+	// World-space size of a grid cell and height of walls and ceiling
+	static constexpr float kCellSize = 2.0f;
+	static constexpr float kWallHeight = 3.0f;
+	// Height and widest radius (the ground platform) of the exit teleport
+	static constexpr float kTeleportHeight = 2.5f;
+	static constexpr float kTeleportRadius = 1.2f;
+	// Lightmap resolution on walls, floors and ceilings (wall tops, never seen, get one texel)
+	static constexpr float kLightmapTexelsPerUnit = 4.0f;
 
 	int getCellType(int x, int z) const {
 		if (x < 0 || x >= m_width || z < 0 || z >= m_height) return 1;
@@ -36,17 +109,56 @@ private:
 	std::pair<int, int> m_startCell;
 	std::pair<int, int> m_endCell;
 
+	// The quads a cell can contribute, in lightmap lookups
+	enum CellFace {
+		FACE_NORTH,
+		FACE_SOUTH,
+		FACE_WEST,
+		FACE_EAST,
+		FACE_TOP,
+		FACE_FLOOR,
+		FACE_CEILING,
+		FACE_COUNT
+	};
+
+	std::vector<LightmapSurface> m_lightmapSurfaces;
+	std::vector<int> m_lightmapIndex;  // Per cell and CellFace: index into m_lightmapSurfaces, -1 if none
+	int m_lightmapWidth;
+	int m_lightmapHeight;
+
+	// Outside the grid or a path cell: walls facing it get a quad
+	bool isOpen(int x, int z) const {
+		return x < 0 || x >= m_width || z < 0 || z >= m_height || m_grid[z][x] == 0;
+	}
+
+	// Gives every quad a tile in the atlas; generateMaze() calls it once the grid is final
+	void layoutLightmap();
+
+	// Fills the lightmap coordinates of the last four vertices, the quad of (x, z) facing face
+	void mapToLightmap(std::vector<Vertex>& vertices, int x, int z, CellFace face) const;
+
 	// Helper for mesh generation
+	struct SurfaceBuffers {
+		std::vector<Vertex> vertices;
+		std::vector<unsigned int> indices;
+	};
+
+	// Fills the three buffers (which may be the same object) with the geometry
+	// of cells [firstX, endX) x [firstZ, endZ); the defaults cover the whole maze
+	void buildSurfaces(SurfaceBuffers& walls, SurfaceBuffers& floors, SurfaceBuffers& ceilings,
+		const MazeMaterials& materials, int firstX = 0, int firstZ = 0, int endX = -1, int endZ = -1) const;
+
 	void addWallQuad(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
-		const Vector3& bottomLeft, const Vector3& bottomRight, float height, const Vector3& normal);
+		const Vector3& bottomLeft, const Vector3& bottomRight, float height, const Vector3& normal,
+		float layer = 0.0f) const;
 	void addFloor(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
-		float x, float z, float cellSize);
+		float x, float z, float cellSize, float layer = 0.0f) const;
 	void addCeiling(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
-		float x, float z, float cellSize, float ceilingHeight);
+		float x, float z, float cellSize, float ceilingHeight, float layer = 0.0f) const;
 	void addTopFace(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
-		float x, float z, float width, float height);
+		float x, float z, float width, float height, float layer = 0.0f) const;
 	void addBottomFace(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
-		float x, float z, float width, float height);
+		float x, float z, float width, float height, float layer = 0.0f) const;
 };
 
 #endif // MAZE_H
\ No newline at end of file
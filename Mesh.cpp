@@ -1,94 +1,93 @@
 #include "Mesh.h"
+#include "GpuBufferArena.h"
+#include "GLTrace.h"
+#include <iostream>
 
-Mesh::Mesh() : m_vao(0), m_vbo(0), m_ebo(0), m_indexCount(0) {}
+Mesh::Mesh() : m_arena(nullptr), m_baseVertex(0), m_vertexCount(0), m_firstIndex(0), m_indexCount(0) {}
 
 Mesh::~Mesh() {
     cleanup();
 }
 
 Mesh::Mesh(Mesh&& other) noexcept
-    : m_vao(other.m_vao),
-      m_vbo(other.m_vbo),
-      m_ebo(other.m_ebo),
+    : m_arena(other.m_arena),
+      m_baseVertex(other.m_baseVertex),
+      m_vertexCount(other.m_vertexCount),
+      m_firstIndex(other.m_firstIndex),
       m_indexCount(other.m_indexCount) {
-    other.m_vao = 0;
-    other.m_vbo = 0;
-    other.m_ebo = 0;
+    other.m_arena = nullptr;
+    other.m_vertexCount = 0;
     other.m_indexCount = 0;
 }
 
 Mesh& Mesh::operator=(Mesh&& other) noexcept {
     if (this != &other) {
         cleanup();
-        m_vao = other.m_vao;
-        m_vbo = other.m_vbo;
-        m_ebo = other.m_ebo;
+        m_arena = other.m_arena;
+        m_baseVertex = other.m_baseVertex;
+        m_vertexCount = other.m_vertexCount;
+        m_firstIndex = other.m_firstIndex;
         m_indexCount = other.m_indexCount;
-        other.m_vao = 0;
-        other.m_vbo = 0;
-        other.m_ebo = 0;
+        other.m_arena = nullptr;
+        other.m_vertexCount = 0;
         other.m_indexCount = 0;
     }
     return *this;
 }
 
-void Mesh::initialize(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices) {
+void Mesh::initialize(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
+                      GpuBufferArena* arena) {
     cleanup();  // Clean up any existing resources
 
-    m_indexCount = static_cast<unsigned int>(indices.size());
-
-    // Generate buffers
-    glGenVertexArrays(1, &m_vao);
-    glGenBuffers(1, &m_vbo);
-    glGenBuffers(1, &m_ebo);
-
-    // Bind VAO
-    glBindVertexArray(m_vao);
-
-    // Upload vertex data
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
-
-    // Upload index data
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-
-    // Set vertex attributes
-    // Position attribute (location = 0)
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
-
-    // Normal attribute (location = 1)
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+    if (!arena) {
+        arena = GpuBufferArena::getDefault();
+    }
+    if (!arena) {
+        std::cerr << "ERROR: Mesh created before the renderer set up its buffer arena" << std::endl;
+        return;
+    }
 
-    // Texture coordinate attribute (location = 2)
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoordX));
+    GpuBufferArena::Allocation allocation;
+    if (!arena->allocate(vertices, indices, allocation)) {
+        return;
+    }
 
-    // Unbind VAO
-    glBindVertexArray(0);
+    m_arena = arena;
+    m_baseVertex = allocation.baseVertex;
+    m_vertexCount = allocation.vertexCount;
+    m_firstIndex = allocation.firstIndex;
+    m_indexCount = allocation.indexCount;
 }
 
 void Mesh::draw() const {
-    if (m_vao != 0) {
-        glBindVertexArray(m_vao);
-        glDrawElements(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
+    if (m_arena) {
+        // Every mesh shares the arena's VAO, so GLStateCache skips all but the first bind
+        m_arena->bind();
+        MAZE_GL_TRACE_DRAW(GL_TRIANGLES, m_indexCount, 1);
+        glDrawElementsBaseVertex(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT,
+            (void*)(static_cast<size_t>(m_firstIndex) * sizeof(unsigned int)), m_baseVertex);
     }
 }
 
-void Mesh::cleanup() {
-    if (m_ebo != 0) {
-        glDeleteBuffers(1, &m_ebo);
-        m_ebo = 0;
+void Mesh::drawInstanced(int instanceCount) const {
+    if (m_arena && instanceCount > 0) {
+        m_arena->bind();
+        MAZE_GL_TRACE_DRAW(GL_TRIANGLES, m_indexCount, instanceCount);
+        glDrawElementsInstancedBaseVertex(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT,
+            (void*)(static_cast<size_t>(m_firstIndex) * sizeof(unsigned int)), instanceCount, m_baseVertex);
     }
-    if (m_vbo != 0) {
-        glDeleteBuffers(1, &m_vbo);
-        m_vbo = 0;
-    }
-    if (m_vao != 0) {
-        glDeleteVertexArrays(1, &m_vao);
-        m_vao = 0;
+}
+
+void Mesh::cleanup() {
+    if (m_arena) {
+        GpuBufferArena::Allocation allocation;
+        allocation.baseVertex = m_baseVertex;
+        allocation.vertexCount = m_vertexCount;
+        allocation.firstIndex = m_firstIndex;
+        allocation.indexCount = m_indexCount;
+        m_arena->release(allocation);
+        m_arena = nullptr;
     }
-}
\ No newline at end of file
+    m_vertexCount = 0;
+    m_indexCount = 0;
+}
@@ -5,6 +5,8 @@
 #include <gl/glew/glew.h>
 #include "Vector3.h"
 
+class GpuBufferArena;
+
 /**
  * @struct Vertex
  * @brief Contains all vertex attributes
@@ -14,9 +16,13 @@ struct Vertex {
     Vector3 normal;
     float texCoordX;
     float texCoordY;
+    float layer;  // Texture array layer (material), 0 for single-texture meshes
+    float lightmapX;  // Lightmap atlas coordinates, 0 for meshes without one
+    float lightmapY;
 
-    Vertex(const Vector3& pos, const Vector3& norm, float u, float v)
-        : position(pos), normal(norm), texCoordX(u), texCoordY(v) {}
+    Vertex(const Vector3& pos, const Vector3& norm, float u, float v, float materialLayer = 0.0f)
+        : position(pos), normal(norm), texCoordX(u), texCoordY(v), layer(materialLayer),
+          lightmapX(0.0f), lightmapY(0.0f) {}
 };
 
 /**
@@ -24,6 +30,9 @@ struct Vertex {
  * @brief Manages 3D mesh data with vertices, normals, and texture coordinates
  * 
  * Single Responsibility: Handles mesh data and OpenGL buffer management
+ *
+ * The data lives in a GpuBufferArena; the mesh is just its vertex and
+ * index ranges there, released again when the mesh is destroyed.
  */
 class Mesh {
 public:
@@ -41,24 +50,39 @@ public:
     /**
      * @brief Initialize mesh with vertex and index data
      * @param vertices Vertex data
-     * @param indices Index data for element drawing
+     * @param indices Index data for element drawing, relative to this mesh's vertices
+     * @param arena Arena to allocate from; the default arena if null
      */
-    void initialize(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
+    void initialize(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
+                    GpuBufferArena* arena = nullptr);
 
     /**
      * @brief Draw the mesh
      */
     void draw() const;
 
+    /**
+     * @brief Draw instanceCount copies; shaders tell them apart with gl_InstanceID
+     */
+    void drawInstanced(int instanceCount) const;
+
     /**
      * @brief Check if mesh is valid
      */
-    bool isValid() const { return m_vao != 0; }
+    bool isValid() const { return m_arena != nullptr; }
+
+    // Ranges in the arena, for batched draws (glMultiDrawElementsBaseVertex)
+    GpuBufferArena* getArena() const { return m_arena; }
+    unsigned int getBaseVertex() const { return m_baseVertex; }
+    unsigned int getVertexCount() const { return m_vertexCount; }
+    unsigned int getFirstIndex() const { return m_firstIndex; }
+    unsigned int getIndexCount() const { return m_indexCount; }
 
 private:
-    GLuint m_vao;  // Vertex Array Object
-    GLuint m_vbo;  // Vertex Buffer Object
-    GLuint m_ebo;  // Element Buffer Object
+    GpuBufferArena* m_arena;
+    unsigned int m_baseVertex;
+    unsigned int m_vertexCount;
+    unsigned int m_firstIndex;
     unsigned int m_indexCount;
 
     /**
@@ -0,0 +1,63 @@
+#include "NoiseTexture.h"
+#include <cmath>
+#include <cstdint>
+
+namespace {
+    // Integer hash of a lattice point, mapped to [0, 1)
+    float latticeValue(int x, int y, unsigned int seed) {
+        uint32_t h = static_cast<uint32_t>(x) * 374761393u + static_cast<uint32_t>(y) * 668265263u + seed * 2246822519u;
+        h = (h ^ (h >> 13)) * 1274126177u;
+        h ^= h >> 16;
+        return (h & 0xFFFFFFu) / 16777216.0f;
+    }
+
+    // Value noise whose lattice repeats every period cells
+    float periodicNoise(float x, float y, int period, unsigned int seed) {
+        float fx = std::floor(x);
+        float fy = std::floor(y);
+        int ix = static_cast<int>(fx);
+        int iy = static_cast<int>(fy);
+        float tx = x - fx;
+        float ty = y - fy;
+        tx = tx * tx * (3.0f - 2.0f * tx);
+        ty = ty * ty * (3.0f - 2.0f * ty);
+
+        int x0 = ((ix % period) + period) % period;
+        int y0 = ((iy % period) + period) % period;
+        int x1 = (x0 + 1) % period;
+        int y1 = (y0 + 1) % period;
+
+        float a = latticeValue(x0, y0, seed);
+        float b = latticeValue(x1, y0, seed);
+        float c = latticeValue(x0, y1, seed);
+        float d = latticeValue(x1, y1, seed);
+
+        float bottom = a + (b - a) * tx;
+        float top = c + (d - c) * tx;
+        return bottom + (top - bottom) * ty;
+    }
+}
+
+std::vector<unsigned char> NoiseTexture::generateFbm(int size, int period, int octaves, unsigned int seed) {
+    std::vector<unsigned char> pixels(static_cast<size_t>(size) * size);
+
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            // Texel centres, in first-octave lattice units
+            float px = (x + 0.5f) * period / size;
+            float py = (y + 0.5f) * period / size;
+
+            float value = 0.0f;
+            float amplitude = 0.5f;
+            int frequency = 1;
+            for (int octave = 0; octave < octaves; ++octave) {
+                value += amplitude * periodicNoise(px * frequency, py * frequency, period * frequency, seed);
+                frequency *= 2;
+                amplitude *= 0.5f;
+            }
+
+            pixels[static_cast<size_t>(y) * size + x] = static_cast<unsigned char>(value * 255.0f + 0.5f);
+        }
+    }
+    return pixels;
+}
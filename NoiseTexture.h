@@ -0,0 +1,29 @@
+#ifndef NOISETEXTURE_H
+#define NOISETEXTURE_H
+
+#include <vector>
+
+/**
+ * @class NoiseTexture
+ * @brief Value-noise fBm baked into a tileable single-channel image
+ *
+ * Matches the fbm() the portal shader used to evaluate per fragment:
+ * smoothstep-interpolated value noise, each octave at twice the frequency
+ * and half the amplitude of the last. Every octave's lattice wraps at the
+ * image edge, so the image tiles with GL_REPEAT and one texture fetch
+ * replaces all the octaves.
+ */
+class NoiseTexture {
+public:
+    /**
+     * @brief Generate a size x size image of fBm
+     * @param period Lattice cells of the first octave across the image
+     * @param octaves Number of octaves summed
+     * @param seed Selects the lattice values
+     * @return One byte per texel, row by row; value = fbm * 255 (at most
+     *         1 - 0.5^octaves, like the shader version)
+     */
+    static std::vector<unsigned char> generateFbm(int size, int period, int octaves, unsigned int seed);
+};
+
+#endif // NOISETEXTURE_H
@@ -0,0 +1,340 @@
+#include "ObservationRenderer.h"
+#include "SimdMath.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+    // Agents per ThreadPool task; one small observation is too little work on its own
+    const int kAgentGrain = 4;
+
+    // Closer than this an orb or the portal is inside the agent and ignored
+    const float kNearDistance = 0.05f;
+
+    // Same cylinder Maze::generateTeleportMesh builds
+    const float kPortalRadius = 0.8f;
+    const float kPortalHeight = 2.5f;
+
+    // Stand-in for "no hit" that still compares and multiplies safely
+    const float kNoHit = 1e30f;
+
+    // SSE/NEON compares yield all-ones lanes; build the same from plain flags
+    inline simd::float4 laneMask(int bits) {
+        return simd::lessThan(simd::splat(0.0f), simd::set(
+            static_cast<float>(bits & 1), static_cast<float>((bits >> 1) & 1),
+            static_cast<float>((bits >> 2) & 1), static_cast<float>((bits >> 3) & 1)));
+    }
+
+    inline simd::float4 both(simd::float4 maskA, simd::float4 maskB) {
+        return simd::select(maskA, maskB, simd::splat(0.0f));
+    }
+}
+
+ObservationRenderer::ObservationRenderer(ThreadPool* pool)
+    : m_pool(pool),
+      m_width(64),
+      m_height(64),
+      m_verticalFov(60.0f),
+      m_maxDistance(30.0f),
+      m_gridWidth(0),
+      m_gridHeight(0),
+      m_portalX(0.0f),
+      m_portalZ(0.0f),
+      m_hasMaze(false) {}
+
+void ObservationRenderer::setResolution(int width, int height) {
+    m_width = std::max(width, 1);
+    m_height = std::max(height, 1);
+}
+
+void ObservationRenderer::setFieldOfView(float verticalDegrees) {
+    m_verticalFov = std::max(1.0f, std::min(verticalDegrees, 170.0f));
+}
+
+void ObservationRenderer::setMaxDistance(float distance) {
+    m_maxDistance = std::max(distance, kNearDistance);
+}
+
+void ObservationRenderer::setMaze(const Maze& maze) {
+    m_gridWidth = maze.getWidth();
+    m_gridHeight = maze.getHeight();
+    m_cells.resize(static_cast<size_t>(m_gridWidth) * m_gridHeight);
+    for (int z = 0; z < m_gridHeight; ++z) {
+        for (int x = 0; x < m_gridWidth; ++x) {
+            m_cells[z * m_gridWidth + x] = maze.getCellType(x, z) != 0 ? 1 : 0;
+        }
+    }
+
+    Vector3 exit = maze.getExitPosition();
+    m_portalX = exit.x;
+    m_portalZ = exit.z;
+    m_hasMaze = true;
+}
+
+void ObservationRenderer::setOrbs(const std::vector<Collectible>& collectibles) {
+    m_orbs.clear();
+    for (const Collectible& collectible : collectibles) {
+        if (collectible.isCollected()) {
+            continue;
+        }
+        Vector3 position = collectible.getPosition();
+        Orb orb;
+        orb.x = position.x;
+        orb.y = position.y;
+        orb.z = position.z;
+        orb.radius = collectible.getRadius();
+        m_orbs.push_back(orb);
+    }
+}
+
+size_t ObservationRenderer::getTensorSize(int count) const {
+    return static_cast<size_t>(std::max(count, 0)) * 2 * m_width * m_height;
+}
+
+bool ObservationRenderer::isWall(int x, int z) const {
+    if (x < 0 || x >= m_gridWidth || z < 0 || z >= m_gridHeight) return true;
+    return m_cells[z * m_gridWidth + x] != 0;
+}
+
+void ObservationRenderer::render(const AgentPose* poses, int count, float* tensor) const {
+    if (!m_hasMaze) {
+        std::cerr << "ERROR: ObservationRenderer::render called before setMaze" << std::endl;
+        return;
+    }
+    if (count <= 0) {
+        return;
+    }
+
+    const size_t pixels = static_cast<size_t>(m_width) * m_height;
+    auto renderRange = [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            float* depth = tensor + i * 2 * pixels;
+            renderAgent(poses[i], depth, depth + pixels);
+        }
+    };
+
+    if (m_pool) {
+        m_pool->parallelFor(count, kAgentGrain, renderRange);
+    }
+    else {
+        renderRange(0, count);
+    }
+}
+
+void ObservationRenderer::renderAgent(const AgentPose& pose, float* depth, float* labels) const {
+    using namespace simd;
+
+    const float cellSize = Maze::kCellSize;
+    const float wallHeight = Maze::kWallHeight;
+    const float degToRad = static_cast<float>(M_PI) / 180.0f;
+
+    const float yaw = pose.yaw * degToRad;
+    const float pitch = std::max(-89.0f, std::min(pose.pitch, 89.0f)) * degToRad;
+    const float eyeX = pose.position.x;
+    const float eyeY = pose.position.y;
+    const float eyeZ = pose.position.z;
+    const float forwardX = std::cos(yaw);
+    const float forwardZ = std::sin(yaw);
+    const float rightX = -forwardZ;  // front x worldUp, as in Camera
+    const float rightZ = forwardX;
+    const float focal = (m_height * 0.5f) / std::tan(m_verticalFov * 0.5f * degToRad);
+    const float horizon = m_height * 0.5f + std::tan(pitch) * focal;
+
+    // === Floor / ceiling depth per row ===
+    // Both are planes, so a row sees them at the same depth in every column;
+    // a wall wins the pixel wherever it is closer than that
+    std::vector<float> rowDepth(m_height);
+    std::vector<float> rowLabel(m_height);
+    std::vector<float> rowSlope(m_height);  // Height gained per unit of depth
+    for (int row = 0; row < m_height; ++row) {
+        float above = horizon - (row + 0.5f);
+        float distance = m_maxDistance;
+        float label = static_cast<float>(OBSERVATION_EMPTY);
+        if (above > 0.0f) {
+            distance = (wallHeight - eyeY) * focal / above;
+            label = static_cast<float>(OBSERVATION_CEILING);
+        }
+        else if (above < 0.0f) {
+            distance = eyeY * focal / -above;
+            label = static_cast<float>(OBSERVATION_FLOOR);
+        }
+        if (distance > m_maxDistance) {
+            distance = m_maxDistance;
+            label = static_cast<float>(OBSERVATION_EMPTY);
+        }
+        rowDepth[row] = distance;
+        rowLabel[row] = label;
+        rowSlope[row] = above / focal;
+    }
+
+    // Grid walk setup shared by every lane
+    const float gridX = eyeX / cellSize;
+    const float gridZ = eyeZ / cellSize;
+    const float startCellX = std::floor(gridX);
+    const float startCellZ = std::floor(gridZ);
+    const float fracX = gridX - startCellX;
+    const float fracZ = gridZ - startCellZ;
+
+    const float portalOffsetX = eyeX - m_portalX;
+    const float portalOffsetZ = eyeZ - m_portalZ;
+    const float portalC = portalOffsetX * portalOffsetX + portalOffsetZ * portalOffsetZ - kPortalRadius * kPortalRadius;
+    const float portalRootSign = portalC < 0.0f ? 1.0f : -1.0f;  // Inside the cylinder: its far side
+
+    const float4 zero = splat(0.0f);
+    const float4 one = splat(1.0f);
+    const float4 minusOne = splat(-1.0f);
+    const float4 noHit = splat(kNoHit);
+    const float4 maxDistance = splat(m_maxDistance);
+    const float4 eyeHeight = splat(eyeY);
+    const float4 wallLabel = splat(static_cast<float>(OBSERVATION_WALL));
+    const float4 portalLabel = splat(static_cast<float>(OBSERVATION_PORTAL));
+    const float halfWidth = m_width * 0.5f;
+    const float invFocal = 1.0f / focal;
+
+    float laneT[4];
+    float laneCellX[4];
+    float laneCellZ[4];
+    float laneWallT[4];
+    float tailDepth[4];
+    float tailLabel[4];
+
+    for (int column = 0; column < m_width; column += 4) {
+        // Rays with unit length along the forward axis, so t is the planar depth
+        float4 offset = mul(sub(set(column + 0.5f, column + 1.5f, column + 2.5f, column + 3.5f), splat(halfWidth)),
+            splat(invFocal));
+        float4 dirX = madd(splat(rightX), offset, splat(forwardX));
+        float4 dirZ = madd(splat(rightZ), offset, splat(forwardZ));
+
+        // === Four DDA walks in lockstep ===
+        float4 negativeX = lessThan(dirX, zero);
+        float4 negativeZ = lessThan(dirZ, zero);
+        float4 absX = max(max(dirX, sub(zero, dirX)), splat(1e-6f));
+        float4 absZ = max(max(dirZ, sub(zero, dirZ)), splat(1e-6f));
+        float4 deltaX = div(splat(cellSize), absX);
+        float4 deltaZ = div(splat(cellSize), absZ);
+        float4 stepX = select(negativeX, minusOne, one);
+        float4 stepZ = select(negativeZ, minusOne, one);
+        float4 sideX = mul(select(negativeX, splat(fracX), splat(1.0f - fracX)), deltaX);
+        float4 sideZ = mul(select(negativeZ, splat(fracZ), splat(1.0f - fracZ)), deltaZ);
+        float4 cellX = splat(startCellX);
+        float4 cellZ = splat(startCellZ);
+
+        int activeBits = 0xF;
+        float4 active = laneMask(activeBits);
+        while (activeBits != 0) {
+            float4 crossX = lessThan(sideX, sideZ);
+            float4 t = select(crossX, sideX, sideZ);
+            float4 moveX = both(active, crossX);
+            float4 moveZ = both(active, select(crossX, zero, active));
+
+            sideX = add(sideX, select(moveX, deltaX, zero));
+            sideZ = add(sideZ, select(moveZ, deltaZ, zero));
+            cellX = add(cellX, select(moveX, stepX, zero));
+            cellZ = add(cellZ, select(moveZ, stepZ, zero));
+
+            // Cell lookups are a gather, which SSE2/NEON lack; do them per lane
+            store(laneT, t);
+            store(laneCellX, cellX);
+            store(laneCellZ, cellZ);
+            for (int lane = 0; lane < 4; ++lane) {
+                int bit = 1 << lane;
+                if (!(activeBits & bit)) continue;
+                if (isWall(static_cast<int>(laneCellX[lane]), static_cast<int>(laneCellZ[lane]))) {
+                    laneWallT[lane] = laneT[lane];
+                    activeBits &= ~bit;
+                }
+                else if (laneT[lane] > m_maxDistance) {
+                    laneWallT[lane] = kNoHit;
+                    activeBits &= ~bit;
+                }
+            }
+            active = laneMask(activeBits);
+        }
+        float4 wallT = load(laneWallT);
+
+        // === Portal cylinder, intersected in the ground plane ===
+        float4 a = madd(dirX, dirX, mul(dirZ, dirZ));
+        float4 b = madd(dirX, splat(portalOffsetX), mul(dirZ, splat(portalOffsetZ)));
+        float4 discriminant = sub(mul(b, b), mul(a, splat(portalC)));
+        float4 root = sqrt(max(discriminant, zero));
+        float4 portalT = div(madd(splat(portalRootSign), root, sub(zero, b)), a);
+        float4 portalValid = both(greaterThan(discriminant, zero), greaterThan(portalT, splat(kNearDistance)));
+        portalT = select(both(portalValid, lessThan(portalT, maxDistance)), portalT, noHit);
+
+        // === Resolve every row for the four columns ===
+        const bool fullGroup = column + 4 <= m_width;
+        for (int row = 0; row < m_height; ++row) {
+            float4 planeDepth = splat(rowDepth[row]);
+            float4 slope = splat(rowSlope[row]);
+
+            float4 wallWins = lessThan(wallT, planeDepth);
+            float4 pixelDepth = select(wallWins, wallT, planeDepth);
+            float4 pixelLabel = select(wallWins, wallLabel, splat(rowLabel[row]));
+
+            float4 portalY = madd(slope, portalT, eyeHeight);
+            float4 portalWins = both(lessThan(portalT, pixelDepth),
+                both(greaterThan(portalY, zero), lessThan(portalY, splat(kPortalHeight))));
+            pixelDepth = select(portalWins, portalT, pixelDepth);
+            pixelLabel = select(portalWins, portalLabel, pixelLabel);
+
+            float* depthRow = depth + row * m_width + column;
+            float* labelRow = labels + row * m_width + column;
+            if (fullGroup) {
+                store(depthRow, pixelDepth);
+                store(labelRow, pixelLabel);
+            }
+            else {
+                store(tailDepth, pixelDepth);
+                store(tailLabel, pixelLabel);
+                for (int lane = 0; column + lane < m_width; ++lane) {
+                    depthRow[lane] = tailDepth[lane];
+                    labelRow[lane] = tailLabel[lane];
+                }
+            }
+        }
+    }
+
+    // === Orbs as depth-tested discs ===
+    for (const Orb& orb : m_orbs) {
+        float relX = orb.x - eyeX;
+        float relY = orb.y - eyeY;
+        float relZ = orb.z - eyeZ;
+        float forward = relX * forwardX + relZ * forwardZ;
+        if (forward < kNearDistance || forward - orb.radius > m_maxDistance) {
+            continue;
+        }
+
+        float scale = focal / forward;
+        float centerX = halfWidth + (relX * rightX + relZ * rightZ) * scale;
+        float centerY = horizon - relY * scale;
+        float radius = orb.radius * scale;
+        if (radius <= 0.0f) continue;
+
+        int firstColumn = std::max(0, static_cast<int>(std::ceil(centerX - radius - 0.5f)));
+        int lastColumn = std::min(m_width - 1, static_cast<int>(std::floor(centerX + radius - 0.5f)));
+        int firstRow = std::max(0, static_cast<int>(std::ceil(centerY - radius - 0.5f)));
+        int lastRow = std::min(m_height - 1, static_cast<int>(std::floor(centerY + radius - 0.5f)));
+
+        float invRadius = 1.0f / radius;
+        for (int row = firstRow; row <= lastRow; ++row) {
+            float dy = (row + 0.5f - centerY) * invRadius;
+            for (int column = firstColumn; column <= lastColumn; ++column) {
+                float dx = (column + 0.5f - centerX) * invRadius;
+                float q = dx * dx + dy * dy;
+                if (q > 1.0f) continue;
+
+                // Front of the sphere, not its centre, so orbs touching walls stay visible
+                float surface = std::max(forward - orb.radius * std::sqrt(1.0f - q), kNearDistance);
+                int index = row * m_width + column;
+                if (surface < depth[index]) {
+                    depth[index] = surface;
+                    labels[index] = static_cast<float>(OBSERVATION_ORB);
+                }
+            }
+        }
+    }
+}
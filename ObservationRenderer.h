@@ -0,0 +1,109 @@
+#ifndef OBSERVATIONRENDERER_H
+#define OBSERVATIONRENDERER_H
+
+#include "Collectible.h"
+#include "Maze.h"
+#include "ThreadPool.h"
+#include "Vector3.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Per-pixel labels in the semantic channel of an observation
+ */
+enum ObservationClass {
+    OBSERVATION_EMPTY = 0,   // Nothing within the maximum distance
+    OBSERVATION_WALL = 1,
+    OBSERVATION_FLOOR = 2,
+    OBSERVATION_CEILING = 3,
+    OBSERVATION_ORB = 4,
+    OBSERVATION_PORTAL = 5
+};
+
+/**
+ * @brief Eye position and view angles of one agent, in Camera's conventions
+ */
+struct AgentPose {
+    Vector3 position;
+    float yaw = -90.0f;  // Degrees
+    float pitch = 0.0f;  // Degrees
+};
+
+/**
+ * @class ObservationRenderer
+ * @brief Renders small depth + semantic images for many agents at once
+ *
+ * Grid raycasting like SoftwareRenderer, but without textures or lighting
+ * and laid out for throughput: four neighbouring columns walk the grid
+ * together in simd::float4 lanes, each row of the group is then resolved
+ * for all four columns with a handful of compares, and agents are spread
+ * over the ThreadPool. The portal is its cylinder and orbs are depth-tested
+ * screen-space discs. Pitch is a y-shear of the horizon.
+ *
+ * The output is one float tensor of shape [agents][2][height][width], rows
+ * top-down: channel 0 is the planar depth along the agent's horizontal view
+ * direction in world units (the maximum distance where nothing is hit),
+ * channel 1 the ObservationClass as a float.
+ */
+class ObservationRenderer {
+public:
+    /**
+     * @param pool Workers for agent batches; nullptr renders on the caller only
+     */
+    explicit ObservationRenderer(ThreadPool* pool = nullptr);
+
+    void setResolution(int width, int height);
+    void setFieldOfView(float verticalDegrees);
+    void setMaxDistance(float distance);
+
+    /**
+     * @brief Copy the maze grid and portal position; call again if the maze changes
+     */
+    void setMaze(const Maze& maze);
+
+    /**
+     * @brief Take the uncollected orbs at their current (hovering) positions
+     */
+    void setOrbs(const std::vector<Collectible>& collectibles);
+
+    /**
+     * @brief Floats needed for count observations at the current resolution
+     */
+    size_t getTensorSize(int count) const;
+
+    /**
+     * @brief Render count observations into tensor (getTensorSize(count) floats)
+     */
+    void render(const AgentPose* poses, int count, float* tensor) const;
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+
+private:
+    struct Orb {
+        float x, y, z;
+        float radius;
+    };
+
+    ThreadPool* m_pool;
+    int m_width;
+    int m_height;
+    float m_verticalFov;
+    float m_maxDistance;
+
+    // Row-major copy of the maze cells, one byte each (1 = wall), so the
+    // DDA does not chase a vector of vectors
+    std::vector<unsigned char> m_cells;
+    int m_gridWidth;
+    int m_gridHeight;
+    float m_portalX;
+    float m_portalZ;
+    bool m_hasMaze;
+
+    std::vector<Orb> m_orbs;
+
+    void renderAgent(const AgentPose& pose, float* depth, float* labels) const;
+    bool isWall(int x, int z) const;
+};
+
+#endif // OBSERVATIONRENDERER_H
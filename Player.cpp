@@ -19,37 +19,21 @@ Player::Player(const Vector3& startPosition)
 }
 
 void Player::update(float deltaTime, float forward, float right, const Maze& maze) {
-    // Clamp delta time to prevent huge jumps
-    if (deltaTime > 0.05f) deltaTime = 0.05f;
-
     // Get camera direction vectors (flattened to ground plane)
-    Vector3 cameraForward = m_camera.getFront();
-    cameraForward.y = 0.0f;
-    float forwardLen = cameraForward.length();
-    if (forwardLen > 0.001f) {
-        cameraForward = cameraForward * (1.0f / forwardLen);
-    }
-
-    Vector3 cameraRight = m_camera.getRight();
-    cameraRight.y = 0.0f;
-    float rightLen = cameraRight.length();
-    if (rightLen > 0.001f) {
-        cameraRight = cameraRight * (1.0f / rightLen);
-    }
+    Vec4 cameraForward = Vec4(m_camera.getFront()).flattened().normalized3();
+    Vec4 cameraRight = Vec4(m_camera.getRight()).flattened().normalized3();
 
     // Calculate movement direction
-    Vector3 moveDirection(0.0f, 0.0f, 0.0f);
-    moveDirection = cameraForward * forward + cameraRight * right;
+    Vec4 moveDirection = cameraForward * forward + cameraRight * right;
 
     // Normalize diagonal movement
-    float moveLen = moveDirection.length();
-    if (moveLen > 1.0f) {
-        moveDirection = moveDirection * (1.0f / moveLen);
+    if (moveDirection.lengthSquared3() > 1.0f) {
+        moveDirection = moveDirection.normalized3();
     }
 
     // Apply speed
     float moveSpeed = m_moveSpeed * deltaTime;
-    moveDirection = moveDirection * moveSpeed;
+    Vector3 moveStep = (moveDirection * moveSpeed).toVector3();
 
     Vector3 pos = m_position;
     int gridX = static_cast<int>(pos.x / 2.0f); // Assuming cell size 2.0
@@ -73,7 +57,7 @@ void Player::update(float deltaTime, float forward, float right, const Maze& maz
 
     // Try X movement first
     Vector3 newPosition = currentPosition;
-    newPosition.x += moveDirection.x;
+    newPosition.x += moveStep.x;
 
     // Check X collision
     if (maze.checkCollision(newPosition, m_collisionRadius)) {
@@ -82,7 +66,7 @@ void Player::update(float deltaTime, float forward, float right, const Maze& maz
 
     // Try Z movement (using the result of X movement - allows wall sliding)
     Vector3 zTestPosition = newPosition;
-    zTestPosition.z += moveDirection.z;
+    zTestPosition.z += moveStep.z;
 
     // Check Z collision
     if (!maze.checkCollision(zTestPosition, m_collisionRadius)) {
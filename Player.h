@@ -18,7 +18,8 @@ public:
 
     /**
      * @brief Update player movement and physics
-     * @param deltaTime Time since last frame
+     * @param deltaTime One simulation tick (Game runs a fixed step, so it is never large
+     *        enough to step through a wall)
      * @param forward Move forward input (-1.0 to 1.0)
      * @param right Move right input (-1.0 to 1.0)
      * @param maze Reference to maze for collision detection
@@ -0,0 +1,230 @@
+#include "ProgramBinaryCache.h"
+#include <chrono>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace {
+    typedef std::chrono::steady_clock CacheClock;
+
+    const char kMagic[4] = { 'M', 'Z', 'P', 'B' };
+    const uint32_t kFormatVersion = 1;
+
+    // On-disk header, followed by `length` bytes of driver binary
+    struct CacheHeader {
+        char magic[4];
+        uint32_t version;
+        uint64_t key;
+        uint32_t binaryFormat;
+        uint32_t length;
+        float compileMilliseconds;
+        uint32_t reserved;
+    };
+
+    // FNV-1a, 64-bit
+    uint64_t hashBytes(uint64_t hash, const char* data, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    uint64_t hashString(uint64_t hash, const std::string& s) {
+        // Hash the terminator too so ("ab","c") and ("a","bc") differ
+        return hashBytes(hash, s.c_str(), s.size() + 1);
+    }
+
+    std::string glString(GLenum name) {
+        const GLubyte* value = glGetString(name);
+        return value ? reinterpret_cast<const char*>(value) : "";
+    }
+
+    float millisecondsSince(CacheClock::time_point start) {
+        return std::chrono::duration<float, std::milli>(CacheClock::now() - start).count();
+    }
+}
+
+ProgramBinaryCache::ProgramBinaryCache(const std::string& directory)
+    : m_directory(directory),
+      m_supported(false),
+      m_directoryReady(false),
+      m_hits(0),
+      m_misses(0),
+      m_stale(0),
+      m_loadMilliseconds(0.0f),
+      m_compileMilliseconds(0.0f),
+      m_savedMilliseconds(0.0f) {
+    if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary) {
+        // Some drivers expose the entry points but no formats
+        GLint formatCount = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+        m_supported = formatCount > 0;
+    }
+
+    // Binaries are only valid for the exact driver that produced them
+    m_driverId = glString(GL_VENDOR) + "|" + glString(GL_RENDERER) + "|" + glString(GL_VERSION);
+
+    if (!m_supported) {
+        std::cout << "Program binaries not supported by driver, shader cache disabled" << std::endl;
+    }
+}
+
+uint64_t ProgramBinaryCache::computeKey(const std::string& vertexSource, const std::string& fragmentSource) const {
+    uint64_t hash = 14695981039346656037ull;
+    hash = hashBytes(hash, reinterpret_cast<const char*>(&kFormatVersion), sizeof(kFormatVersion));
+    hash = hashString(hash, m_driverId);
+    hash = hashString(hash, vertexSource);
+    hash = hashString(hash, fragmentSource);
+    return hash;
+}
+
+bool ProgramBinaryCache::load(uint64_t key, GLuint program) {
+    if (!m_supported) {
+        return false;
+    }
+
+    CacheClock::time_point start = CacheClock::now();
+    std::string path = pathForKey(key);
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        ++m_misses;
+        return false;
+    }
+
+    CacheHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    bool valid = file &&
+        std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+        header.version == kFormatVersion &&
+        header.key == key &&
+        header.length > 0;
+
+    std::vector<char> binary;
+    if (valid) {
+        binary.resize(header.length);
+        file.read(binary.data(), header.length);
+        valid = static_cast<bool>(file);
+    }
+    file.close();
+
+    if (valid) {
+        // The driver may still reject the blob (e.g. after an update that kept
+        // the version string); that shows up as a failed link
+        glProgramBinary(program, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        valid = linked == GL_TRUE;
+    }
+
+    if (!valid) {
+        std::remove(path.c_str());
+        ++m_stale;
+        ++m_misses;
+        return false;
+    }
+
+    ++m_hits;
+    m_loadMilliseconds += millisecondsSince(start);
+    m_savedMilliseconds += header.compileMilliseconds;
+    return true;
+}
+
+void ProgramBinaryCache::store(uint64_t key, GLuint program, float compileMilliseconds) {
+    m_compileMilliseconds += compileMilliseconds;
+
+    if (!m_supported || !ensureDirectory()) {
+        return;
+    }
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    std::vector<char> binary(length);
+    GLenum binaryFormat = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &binaryFormat, binary.data());
+    if (written <= 0) {
+        return;
+    }
+
+    CacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kFormatVersion;
+    header.key = key;
+    header.binaryFormat = binaryFormat;
+    header.length = static_cast<uint32_t>(written);
+    header.compileMilliseconds = compileMilliseconds;
+
+    std::string path = pathForKey(key);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to write shader cache entry: " << path << std::endl;
+        return;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(binary.data(), written);
+}
+
+void ProgramBinaryCache::printStats() const {
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Shader cache: " << m_hits << " hit(s), " << m_misses << " miss(es)";
+    if (m_stale > 0) {
+        std::cout << " (" << m_stale << " stale)";
+    }
+    std::cout << std::endl;
+
+    if (m_misses > 0) {
+        std::cout << "  Compiled from source in " << m_compileMilliseconds << " ms" << std::endl;
+    }
+    if (m_hits > 0) {
+        std::cout << "  Loaded binaries in " << m_loadMilliseconds << " ms, saving ~"
+            << (m_savedMilliseconds - m_loadMilliseconds) << " ms of compilation" << std::endl;
+    }
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+}
+
+std::string ProgramBinaryCache::pathForKey(uint64_t key) const {
+    std::ostringstream name;
+    name << m_directory << "/" << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    return name.str();
+}
+
+bool ProgramBinaryCache::ensureDirectory() {
+    if (m_directoryReady) {
+        return true;
+    }
+
+#ifdef _WIN32
+    int result = _mkdir(m_directory.c_str());
+#else
+    int result = mkdir(m_directory.c_str(), 0755);
+#endif
+    if (result != 0 && errno != EEXIST) {
+        std::cerr << "Failed to create shader cache directory: " << m_directory << std::endl;
+        m_supported = false;  // Don't retry for every program
+        return false;
+    }
+
+    m_directoryReady = true;
+    return true;
+}
@@ -0,0 +1,73 @@
+#ifndef PROGRAMBINARYCACHE_H
+#define PROGRAMBINARYCACHE_H
+
+#include <string>
+#include <cstdint>
+#include <gl/glew/glew.h>
+
+/**
+ * @class ProgramBinaryCache
+ * @brief Persists linked shader programs to disk via glGetProgramBinary
+ *
+ * Entries are keyed by a hash of both shader sources (after define
+ * injection) and the GL vendor/renderer/version strings, so a driver
+ * update or a shader edit simply misses. A binary the driver rejects is
+ * treated as stale: the file is deleted and the caller recompiles.
+ */
+class ProgramBinaryCache {
+public:
+    /**
+     * @param directory Folder for cache files (created on first store)
+     */
+    explicit ProgramBinaryCache(const std::string& directory = "shadercache");
+
+    /**
+     * @brief True when the driver can return at least one binary format
+     */
+    bool isSupported() const { return m_supported; }
+
+    /**
+     * @brief Cache key for a pair of (already define-injected) sources
+     */
+    uint64_t computeKey(const std::string& vertexSource, const std::string& fragmentSource) const;
+
+    /**
+     * @brief Try to restore a cached binary into an existing program object
+     * @return true if the program is linked and ready to use
+     */
+    bool load(uint64_t key, GLuint program);
+
+    /**
+     * @brief Save a freshly linked program
+     * @param compileMilliseconds Time the source compile took (reported on later hits)
+     */
+    void store(uint64_t key, GLuint program, float compileMilliseconds);
+
+    // Startup statistics
+    int getHitCount() const { return m_hits; }
+    int getMissCount() const { return m_misses; }
+    int getStaleCount() const { return m_stale; }
+
+    /**
+     * @brief Print hits/misses and the compile time the hits avoided
+     */
+    void printStats() const;
+
+private:
+    std::string m_directory;
+    std::string m_driverId;
+    bool m_supported;
+    bool m_directoryReady;
+
+    int m_hits;
+    int m_misses;
+    int m_stale;
+    float m_loadMilliseconds;     // Time spent in glProgramBinary on hits
+    float m_compileMilliseconds;  // Time spent compiling sources on misses
+    float m_savedMilliseconds;    // Recorded compile time of the entries we hit
+
+    std::string pathForKey(uint64_t key) const;
+    bool ensureDirectory();
+};
+
+#endif // PROGRAMBINARYCACHE_H
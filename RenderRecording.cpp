@@ -0,0 +1,153 @@
+#include "RenderRecording.h"
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+namespace {
+    const char kMagic[4] = { 'M', 'Z', 'R', 'C' };
+    const uint32_t kVersion = 3;  // 2: SET_LIGHTS, 3: 32-bit chunk indices
+
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t seed;
+        int32_t width;
+        int32_t height;
+    };
+}
+
+// =====================================================
+// RenderRecorder
+// =====================================================
+
+RenderRecorder::RenderRecorder() : m_frames(0) {}
+
+bool RenderRecorder::open(const std::string& path, unsigned int seed, int width, int height) {
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file) {
+        std::cerr << "ERROR: Cannot write render recording " << path << std::endl;
+        return false;
+    }
+
+    FileHeader header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.seed = seed;
+    header.width = width;
+    header.height = height;
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::cout << "Recording render commands to " << path << std::endl;
+    return true;
+}
+
+void RenderRecorder::writeCommand(RenderCommandType type, const void* payload, size_t size) {
+    writeCommand(type, payload, size, nullptr, 0);
+}
+
+void RenderRecorder::writeCommand(RenderCommandType type, const void* first, size_t firstSize,
+                                  const void* second, size_t secondSize) {
+    if (!m_file) return;
+
+    RenderCommandHeader header;
+    header.type = type;
+    header.size = static_cast<uint32_t>(firstSize + secondSize);
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (firstSize > 0) m_file.write(static_cast<const char*>(first), firstSize);
+    if (secondSize > 0) m_file.write(static_cast<const char*>(second), secondSize);
+}
+
+void RenderRecorder::setLights(const std::vector<PointLight>& lights) {
+    writeCommand(RENDER_COMMAND_SET_LIGHTS, lights.data(), lights.size() * sizeof(PointLight));
+}
+
+void RenderRecorder::beginFrame(const SceneCommand& scene) {
+    writeCommand(RENDER_COMMAND_BEGIN_FRAME, &scene, sizeof(scene));
+}
+
+void RenderRecorder::drawChunks(const std::vector<unsigned int>& indices) {
+    // Fixed width in the file, whatever unsigned int is; big mazes pass 65536 chunks
+    m_indexScratch.assign(indices.begin(), indices.end());
+    writeCommand(RENDER_COMMAND_DRAW_CHUNKS, m_indexScratch.data(), m_indexScratch.size() * sizeof(uint32_t));
+}
+
+void RenderRecorder::drawOrbs(float time, const std::vector<OrbDraw>& orbs) {
+    writeCommand(RENDER_COMMAND_DRAW_ORBS, &time, sizeof(time), orbs.data(), orbs.size() * sizeof(OrbDraw));
+}
+
+void RenderRecorder::drawPortal(float time) {
+    writeCommand(RENDER_COMMAND_DRAW_PORTAL, &time, sizeof(time));
+}
+
+void RenderRecorder::endFrame() {
+    writeCommand(RENDER_COMMAND_END_FRAME, nullptr, 0);
+    ++m_frames;
+}
+
+// =====================================================
+// RenderRecording
+// =====================================================
+
+bool RenderRecording::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "ERROR: Cannot open render recording " << path << std::endl;
+        return false;
+    }
+    m_data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    FileHeader header;
+    if (m_data.size() < sizeof(header)) {
+        std::cerr << "ERROR: " << path << " is not a render recording" << std::endl;
+        return false;
+    }
+    std::memcpy(&header, m_data.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+        std::cerr << "ERROR: " << path << " is not a version " << kVersion << " render recording" << std::endl;
+        return false;
+    }
+
+    m_seed = header.seed;
+    m_width = header.width;
+    m_height = header.height;
+    m_firstCommand = sizeof(header);
+
+    // Validate once so next() can trust the sizes
+    m_frames = 0;
+    size_t offset = m_firstCommand;
+    size_t framesEnd = m_firstCommand;
+    while (m_data.size() - offset >= sizeof(RenderCommandHeader)) {
+        RenderCommandHeader command;
+        std::memcpy(&command, m_data.data() + offset, sizeof(command));
+        if (m_data.size() - offset - sizeof(command) < command.size) {
+            break;
+        }
+        offset += sizeof(command) + command.size;
+        if (command.type == RENDER_COMMAND_END_FRAME) {
+            ++m_frames;
+            framesEnd = offset;
+        }
+    }
+    if (framesEnd != m_data.size()) {
+        // Cut short, e.g. the game was killed mid-frame
+        std::cerr << "WARNING: " << path << " is truncated, replaying its " << m_frames << " complete frames" << std::endl;
+    }
+    m_data.resize(framesEnd);
+
+    m_cursor = m_firstCommand;
+    return true;
+}
+
+bool RenderRecording::next(Command& command) {
+    if (m_cursor >= m_data.size()) {
+        return false;
+    }
+
+    RenderCommandHeader header;
+    std::memcpy(&header, m_data.data() + m_cursor, sizeof(header));
+    command.type = static_cast<RenderCommandType>(header.type);
+    command.data = m_data.data() + m_cursor + sizeof(header);
+    command.size = header.size;
+    m_cursor += sizeof(header) + header.size;
+    return true;
+}
@@ -0,0 +1,139 @@
+#ifndef RENDERRECORDING_H
+#define RENDERRECORDING_H
+
+#include "ClusteredLighting.h"
+#include "Vector3.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Command types in a render recording
+ *
+ * Each command is a RenderCommandHeader followed by its payload. Resources
+ * (maze chunks, the orb and portal meshes, their shaders and the material
+ * array) are not stored: the replaying Game rebuilds them from the seed in
+ * the file header, so commands refer to them by index or by type.
+ */
+enum RenderCommandType {
+    RENDER_COMMAND_BEGIN_FRAME = 1,  // SceneCommand
+    RENDER_COMMAND_DRAW_CHUNKS = 2,  // uint32_t chunk indices, drawn with the material array
+    RENDER_COMMAND_DRAW_ORBS = 3,    // float time, then OrbDraw[]
+    RENDER_COMMAND_DRAW_PORTAL = 4,  // float time
+    RENDER_COMMAND_END_FRAME = 5,    // No payload
+    RENDER_COMMAND_SET_LIGHTS = 6    // PointLight[], for the next BEGIN_FRAME onwards
+};
+
+struct RenderCommandHeader {
+    uint32_t type;
+    uint32_t size;  // Payload bytes
+};
+
+/**
+ * @brief Camera and scene shader inputs of one frame
+ */
+struct SceneCommand {
+    Vector3 eye;
+    float yaw;
+    float pitch;
+    float time;
+    float flashlightIntensity;
+    uint32_t flashlightOn;
+};
+
+/**
+ * @brief One collectible instance: its transform and pulse are rebuilt from these on replay
+ */
+struct OrbDraw {
+    Vector3 position;
+    float rotation;  // Degrees about Y
+    float pulse;     // Also the uniform scale
+};
+
+/**
+ * @class RenderRecorder
+ * @brief Appends the render commands of each frame to a binary file
+ *
+ * The stream is written through an ordinary buffered file, so recording
+ * costs a few small copies per frame. Command payloads are plain structs
+ * in host byte order; recordings are meant to be replayed on the machine
+ * (or at least the architecture) that made them.
+ */
+class RenderRecorder {
+public:
+    RenderRecorder();
+
+    RenderRecorder(const RenderRecorder&) = delete;
+    RenderRecorder& operator=(const RenderRecorder&) = delete;
+
+    /**
+     * @param seed Maze seed the resources are built from (not 0)
+     * @return false if the file cannot be written
+     */
+    bool open(const std::string& path, unsigned int seed, int width, int height);
+
+    void setLights(const std::vector<PointLight>& lights);
+    void beginFrame(const SceneCommand& scene);
+    void drawChunks(const std::vector<unsigned int>& indices);
+    void drawOrbs(float time, const std::vector<OrbDraw>& orbs);
+    void drawPortal(float time);
+    void endFrame();
+
+    unsigned long long getFrameCount() const { return m_frames; }
+
+private:
+    std::ofstream m_file;
+    std::vector<uint32_t> m_indexScratch;
+    unsigned long long m_frames;
+
+    void writeCommand(RenderCommandType type, const void* payload, size_t size);
+    void writeCommand(RenderCommandType type, const void* first, size_t firstSize, const void* second, size_t secondSize);
+};
+
+/**
+ * @class RenderRecording
+ * @brief A recording loaded into memory, read back one command at a time
+ *
+ * Loading checks the header and that every command fits in the file, so
+ * replay never reads past the end. Payload pointers stay valid while the
+ * recording lives; they are not aligned, so copy values out with memcpy.
+ */
+class RenderRecording {
+public:
+    struct Command {
+        RenderCommandType type;
+        const unsigned char* data;
+        size_t size;
+    };
+
+    /**
+     * @return false (with a message on stderr) for a missing, foreign or truncated file
+     */
+    bool load(const std::string& path);
+
+    unsigned int getSeed() const { return m_seed; }
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    unsigned long long getFrameCount() const { return m_frames; }
+    size_t getByteSize() const { return m_data.size(); }
+
+    /**
+     * @brief Read the next command
+     * @return false at the end; call rewind() to start over
+     */
+    bool next(Command& command);
+    void rewind() { m_cursor = m_firstCommand; }
+
+private:
+    std::vector<unsigned char> m_data;
+    size_t m_firstCommand = 0;
+    size_t m_cursor = 0;
+    unsigned int m_seed = 0;
+    int m_width = 0;
+    int m_height = 0;
+    unsigned long long m_frames = 0;
+};
+
+#endif // RENDERRECORDING_H
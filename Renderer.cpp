@@ -1,8 +1,72 @@
 #include "Renderer.h"
+#include "GLStateCache.h"
+#include "GLTrace.h"
 #include <gl/glew/glew.h>
+#include <cstring>
 #include <iostream>
 
-Renderer::Renderer() : m_viewportWidth(800), m_viewportHeight(600) {}
+namespace {
+	// Clip planes of every scene projection; the bilateral upsample linearizes depth with them
+	const float kNearPlane = 0.1f;
+	const float kFarPlane = 100.0f;
+
+	// Texture units of the light cluster buffers, the lightmap and the light grid; unit 0 holds the materials
+	const unsigned int kClusterTableUnit = 1;
+	const unsigned int kClusterLightUnit = 2;
+	const unsigned int kLightmapUnit = 3;
+	const unsigned int kLightGridUnit = 4;
+
+	// Overhead light (very dim blue-grey), following the camera at an offset
+	const Vector3 kOverheadLightOffset(0.0f, 5.0f, 5.0f);
+	const Vector3 kOverheadLightColor(0.3f, 0.3f, 0.4f);
+	const float kMaterialAmbient = 0.15f;
+	const float kMaterialDiffuse = 0.3f;
+
+	// The portal light: cyan, pulsing, reaching 8 units
+	const float kPortalLightRadius = 8.0f;
+	const float kPortalLightStrength = 0.8f;  // Applied in fragment.glsl
+	Vector3 portalLightColor(float time) {
+		float pulse = 0.8f + 0.2f * std::sin(time * 1.5f);
+		return Vector3(0.0f, 0.8f * pulse, 1.0f * pulse);
+	}
+
+	// In the light grid, the flashlight also lights the cells around the player a little
+	const float kFlashlightSpillRadius = 4.0f;
+	const Vector3 kFlashlightSpillColor(0.08f, 0.08f, 0.07f);  // Times the flashlight intensity
+}
+
+Renderer::Renderer()
+	: m_halfResolutionEnabled(true),
+	m_clusteredLightingEnabled(true),
+	m_lightmapEnabled(true),
+	m_lightGridEnabled(false),
+	m_shader(nullptr),
+	m_activeFeatures(0),
+	m_viewportWidth(800),
+	m_viewportHeight(600),
+	m_fogEnabled(true),
+	m_portalLightEnabled(true),
+	m_specularEnabled(true),
+	m_textureArrayEnabled(true),
+	m_indirectBuffer(0),
+	m_indirectDrawSupported(false),
+	m_indirectDrawEnabled(true),
+	m_depthPrepassEnabled(true),
+	m_blockOffset(0),
+	m_blockSize(0),
+	m_blockBinding(0),
+	m_fullscreenVao(0),
+	m_sceneActive(false),
+	m_outputFramebuffer(0) {
+}
+
+Renderer::~Renderer() {
+	GLStateCache::get().deleteVertexArray(m_fullscreenVao);
+	GLStateCache::get().deleteBuffer(m_indirectBuffer);
+	if (ShaderProgram::getBinaryCache() == m_programCache.get()) {
+		ShaderProgram::setBinaryCache(nullptr);
+	}
+}
 
 bool Renderer::initialize() {
 	// Initialize GLEW
@@ -18,27 +82,173 @@ bool Renderer::initialize() {
 
 	initializeOpenGLState();
 
-	// Load shader
-	m_shader = std::make_unique<ShaderProgram>();
-	if (!m_shader->loadFromFile("shaders/vertex.glsl", "shaders/fragment.glsl")) {
+	// Needs a live context: the cache key includes the driver strings
+	m_programCache = std::make_unique<ProgramBinaryCache>("shadercache");
+	ShaderProgram::setBinaryCache(m_programCache.get());
+
+	// All meshes share one vertex/index buffer pair and one VAO
+	m_meshArena = std::make_unique<GpuBufferArena>();
+	GpuBufferArena::setDefault(m_meshArena.get());
+	m_indirectDrawSupported = GLEW_VERSION_4_3 || GLEW_ARB_multi_draw_indirect;
+
+	// Per-frame constants and instance data are streamed, not set uniform by uniform.
+	// Blocks must be registered before any program is built.
+	m_frameRing = std::make_unique<StreamingRingBuffer>(GL_UNIFORM_BUFFER, 256 * 1024);
+	ShaderProgram::registerUniformBlock("FrameData", UNIFORM_BLOCK_FRAME_DATA);
+	ShaderProgram::registerUniformBlock("CollectibleInstances", UNIFORM_BLOCK_COLLECTIBLE_INSTANCES);
+	ShaderProgram::registerUniformBlock("PointLights", UNIFORM_BLOCK_POINT_LIGHTS);
+	std::cout << "Streaming buffer: " << (m_frameRing->isPersistent() ? "persistent mapping" : "unsynchronized mapping") << std::endl;
+
+	// Load shader permutations (bit order must match ShaderFeature)
+	m_shaders = std::make_unique<ShaderPermutationSet>(
+		"shaders/vertex.glsl", "shaders/fragment.glsl",
+		std::vector<std::string>{ "FLASHLIGHT", "FOG", "PORTAL_LIGHT", "SPECULAR", "TEXTURE_ARRAY", "CLUSTERED_LIGHTS", "LIGHTMAP", "LIGHT_GRID" });
+
+	// Point lights are binned every frame into buffers the surface shader reads
+	m_lightClusters = std::make_unique<ClusteredLighting>();
+	if (!m_lightClusters->create()) {
+		m_lightClusters.reset();
+	}
+
+	// Queue the gameplay variants (flashlight on and off) now; finishShaders()
+	// collects them once the rest of startup has had a chance to overlap
+	if (ShaderProgram::enableParallelCompile()) {
+		std::cout << "Parallel shader compilation enabled" << std::endl;
+	}
+	m_shaders->submit(getDefaultFeatures());
+	m_shaders->submit(getDefaultFeatures() & ~SHADER_FEATURE_FLASHLIGHT);
+
+	// The scene renders offscreen at a GPU-time-driven scale, then is upscaled
+	m_dynamicResolution = std::make_unique<DynamicResolution>();
+	m_sceneTarget = std::make_unique<SceneFramebuffer>();
+	m_upscaleShader = std::make_unique<ShaderProgram>();
+	if (!m_upscaleShader->submitFromFile("shaders/upscale_vertex.glsl", "shaders/upscale_fragment.glsl")) {
+		m_upscaleShader.reset();
+	}
+
+	// Optional depth-only pass in front of the batched surfaces
+	m_depthShader = std::make_unique<ShaderProgram>();
+	if (!m_depthShader->submitFromFile("shaders/depth_vertex.glsl", "shaders/depth_fragment.glsl")) {
+		m_depthShader.reset();
+	}
+
+	// Additive effects (the portal) can render at half resolution inside the scene target
+	m_halfTarget = std::make_unique<HalfResolutionTarget>();
+	m_depthDownsampleShader = std::make_unique<ShaderProgram>();
+	if (!m_depthDownsampleShader->submitFromFile("shaders/upscale_vertex.glsl", "shaders/depth_downsample_fragment.glsl")) {
+		m_depthDownsampleShader.reset();
+	}
+	m_bilateralShader = std::make_unique<ShaderProgram>();
+	if (!m_bilateralShader->submitFromFile("shaders/upscale_vertex.glsl", "shaders/bilateral_upsample_fragment.glsl")) {
+		m_bilateralShader.reset();
+	}
+	glGenVertexArrays(1, &m_fullscreenVao);
+
+	return true;
+}
+
+bool Renderer::finishShaders() {
+	// Failures surface at startup, and toggling the flashlight never compiles mid-game
+	unsigned int defaultFeatures = getDefaultFeatures();
+	if (!m_shaders->get(defaultFeatures) || !m_shaders->get(defaultFeatures & ~SHADER_FEATURE_FLASHLIGHT)) {
 		std::cerr << "Failed to load shaders" << std::endl;
 		return false;
 	}
 
+	// Optional: without it the scene simply renders at native resolution
+	if (m_upscaleShader && !m_upscaleShader->finish()) {
+		std::cerr << "WARNING: Upscale shader failed, dynamic resolution disabled" << std::endl;
+		m_upscaleShader.reset();
+	}
+
+	if (m_depthShader && !m_depthShader->finish()) {
+		std::cerr << "WARNING: Depth pre-pass shader failed, pre-pass disabled" << std::endl;
+		m_depthShader.reset();
+	}
+
+	// Optional too: effects then render at full resolution
+	bool downsampleReady = m_depthDownsampleShader && m_depthDownsampleShader->finish();
+	bool bilateralReady = m_bilateralShader && m_bilateralShader->finish();
+	if (!downsampleReady || !bilateralReady) {
+		std::cerr << "WARNING: Half-resolution effect shaders failed, effects render at full resolution" << std::endl;
+		m_depthDownsampleShader.reset();
+		m_bilateralShader.reset();
+	}
 	return true;
 }
 
+unsigned int Renderer::getDefaultFeatures() {
+	return SHADER_FEATURE_FLASHLIGHT | SHADER_FEATURE_FOG |
+		SHADER_FEATURE_SPECULAR | SHADER_FEATURE_TEXTURE_ARRAY | SHADER_FEATURE_CLUSTERED_LIGHTS |
+		SHADER_FEATURE_LIGHTMAP;
+}
+
+unsigned int Renderer::getLightGridFeatures() {
+	return (getDefaultFeatures() & ~SHADER_FEATURE_CLUSTERED_LIGHTS) | SHADER_FEATURE_LIGHT_GRID;
+}
+
+LightmapLighting Renderer::getStaticLighting(const Vector3& portalPos) {
+	LightmapLighting lighting;
+	lighting.ambient = kOverheadLightColor * kMaterialAmbient;
+	lighting.overheadColor = kOverheadLightColor * kMaterialDiffuse;
+	lighting.overheadDirection = kOverheadLightOffset.normalize();
+	lighting.portalPosition = portalPos;
+	lighting.portalRadius = kPortalLightRadius;
+	lighting.portalStrength = kPortalLightStrength;
+	return lighting;
+}
+
+void Renderer::setLightmap(const Lightmap& lightmap) {
+	if (lightmap.texels.empty()) return;
+
+	if (!m_lightmap) {
+		m_lightmap = std::make_unique<Texture>();
+	}
+	m_lightmap->createFloatRgba(lightmap.width, lightmap.height, lightmap.texels.data());
+}
+
+void Renderer::setLightGridEnabled(bool enabled) {
+	m_lightGridEnabled = enabled;
+	if (!isLightGridEnabled() || !m_shaders) {
+		return;
+	}
+
+	// As finishShaders() does for the defaults: both flashlight states, so
+	// neither the first frame nor a flashlight toggle compiles mid-game
+	unsigned int gridFeatures = getLightGridFeatures();
+	m_shaders->submit(gridFeatures);
+	m_shaders->submit(gridFeatures & ~SHADER_FEATURE_FLASHLIGHT);
+	if (!m_shaders->get(gridFeatures) || !m_shaders->get(gridFeatures & ~SHADER_FEATURE_FLASHLIGHT)) {
+		std::cerr << "WARNING: Light grid shaders failed, using clustered lighting" << std::endl;
+		m_lightGridEnabled = false;
+	}
+}
+
+void Renderer::setLightGridMaze(const Maze& maze) {
+	if (!m_lightGrid) {
+		m_lightGrid = std::make_unique<LightGrid>();
+		m_lightGridTexture = std::make_unique<Texture>();
+	}
+	m_lightGrid->setMaze(maze);
+	m_lightGridTexture->createFloatRgba(m_lightGrid->getWidth(), m_lightGrid->getHeight(), m_lightGrid->getTexels().data());
+	m_lightGrid->clearDirty();
+}
+
 void Renderer::initializeOpenGLState() {
+	// A new context: nothing the cache remembers applies to it
+	GLStateCache& state = GLStateCache::get();
+	state.invalidate();
+
 	// Enable depth testing with correct function
-	glEnable(GL_DEPTH_TEST);
-	glDepthFunc(GL_LESS);
-	glDepthMask(GL_TRUE);  // Ensure depth buffer writing is enabled
+	state.setEnabled(GL_DEPTH_TEST, true);
+	state.depthFunc(GL_LESS);
+	state.depthMask(true);  // Ensure depth buffer writing is enabled
 
 	// Enable face culling to prevent rendering inside faces
-	glEnable(GL_CULL_FACE);
+	state.setEnabled(GL_CULL_FACE, true);
 
 	// Disable blending by default (enable only for transparent objects)
-	glDisable(GL_BLEND);
+	state.setEnabled(GL_BLEND, false);
 
 	// Set clear color (dark blue-gray for better contrast)
 	glClearColor(0.05f, 0.05f, 0.1f, 1.0f);
@@ -55,6 +265,124 @@ void Renderer::setViewport(int width, int height) {
 	m_viewportHeight = height;
 	glViewport(0, 0, width, height);
 	std::cout << "Viewport set to: " << width << "x" << height << std::endl;
+
+	// The window's own MSAA is wasted on an upscaled image, so the scene target has its own
+	if (m_sceneTarget && (m_sceneTarget->getWidth() != width || m_sceneTarget->getHeight() != height)) {
+		m_sceneTarget->create(width, height, 4);
+		m_halfTarget->create(width, height);
+	}
+}
+
+void Renderer::beginScene() {
+	m_sceneActive = m_sceneTarget && m_sceneTarget->isValid() && m_upscaleShader && m_upscaleShader->getProgram() != 0;
+	if (!m_sceneActive) {
+		glBindFramebuffer(GL_FRAMEBUFFER, m_outputFramebuffer);
+		glViewport(0, 0, m_viewportWidth, m_viewportHeight);
+		return;
+	}
+
+	m_dynamicResolution->beginFrame();
+
+	float scale = m_dynamicResolution->getScale();
+	m_sceneTarget->bind(static_cast<int>(m_viewportWidth * scale + 0.5f),
+		static_cast<int>(m_viewportHeight * scale + 0.5f));
+}
+
+void Renderer::endScene() {
+	if (!m_sceneActive) {
+		return;
+	}
+	m_sceneActive = false;
+
+	m_dynamicResolution->endFrame();
+	m_sceneTarget->resolve();
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_outputFramebuffer);
+	glViewport(0, 0, m_viewportWidth, m_viewportHeight);
+
+	GLStateCache& state = GLStateCache::get();
+	state.setEnabled(GL_DEPTH_TEST, false);
+	state.setEnabled(GL_BLEND, false);
+	state.setEnabled(GL_CULL_FACE, false);
+
+	float width = static_cast<float>(m_sceneTarget->getWidth());
+	float height = static_cast<float>(m_sceneTarget->getHeight());
+	bool upscaled = m_sceneTarget->getRenderWidth() < m_sceneTarget->getWidth();
+
+	m_upscaleShader->use();
+	m_upscaleShader->setUniform("sceneTexture", 0);
+	m_upscaleShader->setUniform("u_uvScale", m_sceneTarget->getRenderWidth() / width, m_sceneTarget->getRenderHeight() / height);
+	m_upscaleShader->setUniform("u_texelSize", 1.0f / width, 1.0f / height);
+	m_upscaleShader->setUniform("u_sharpness", upscaled ? 0.5f : 0.0f);
+
+	state.bindTexture(0, GL_TEXTURE_2D, m_sceneTarget->getColorTexture());
+	state.bindVertexArray(m_fullscreenVao);
+	MAZE_GL_TRACE_DRAW(GL_TRIANGLES, 3, 1);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+
+	state.setEnabled(GL_DEPTH_TEST, true);
+}
+
+bool Renderer::beginHalfResolutionPass() {
+	if (!m_sceneActive || !m_halfResolutionEnabled || !m_halfTarget->isValid() ||
+		!m_depthDownsampleShader || !m_bilateralShader) {
+		return false;
+	}
+
+	m_sceneTarget->resolveDepth();
+	m_halfTarget->bind(m_sceneTarget->getRenderWidth(), m_sceneTarget->getRenderHeight());
+
+	// One fullscreen pass writes the downsampled depth and clears the colour
+	GLStateCache& state = GLStateCache::get();
+	state.setEnabled(GL_DEPTH_TEST, true);
+	state.depthFunc(GL_ALWAYS);
+	state.depthMask(true);
+	state.setEnabled(GL_BLEND, false);
+	state.setEnabled(GL_CULL_FACE, false);
+
+	m_depthDownsampleShader->use();
+	m_depthDownsampleShader->setUniform("sceneDepth", 0);
+	m_depthDownsampleShader->setUniform("u_sceneMax",
+		static_cast<float>(m_sceneTarget->getRenderWidth() - 1), static_cast<float>(m_sceneTarget->getRenderHeight() - 1));
+
+	state.bindTexture(0, GL_TEXTURE_2D, m_sceneTarget->getDepthTexture());
+	state.bindVertexArray(m_fullscreenVao);
+	MAZE_GL_TRACE_DRAW(GL_TRIANGLES, 3, 1);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+
+	state.depthFunc(GL_LESS);
+	return true;
+}
+
+void Renderer::endHalfResolutionPass() {
+	m_sceneTarget->bind(m_sceneTarget->getRenderWidth(), m_sceneTarget->getRenderHeight());
+
+	// Depth test off: occlusion was resolved against the downsampled depth.
+	// Depth writes off too, since the scene depth is also being sampled
+	GLStateCache& state = GLStateCache::get();
+	state.setEnabled(GL_DEPTH_TEST, false);
+	state.depthMask(false);
+	state.setEnabled(GL_BLEND, true);
+	state.blendFunc(GL_ONE, GL_ONE);
+
+	m_bilateralShader->use();
+	m_bilateralShader->setUniform("sceneDepth", 0);
+	m_bilateralShader->setUniform("halfColor", 1);
+	m_bilateralShader->setUniform("halfDepth", 2);
+	m_bilateralShader->setUniform("u_halfMax",
+		static_cast<float>(m_halfTarget->getRenderWidth() - 1), static_cast<float>(m_halfTarget->getRenderHeight() - 1));
+	m_bilateralShader->setUniform("u_depthRange", kNearPlane, kFarPlane);
+
+	state.bindTexture(0, GL_TEXTURE_2D, m_sceneTarget->getDepthTexture());
+	state.bindTexture(1, GL_TEXTURE_2D, m_halfTarget->getColorTexture());
+	state.bindTexture(2, GL_TEXTURE_2D, m_halfTarget->getDepthTexture());
+	state.bindVertexArray(m_fullscreenVao);
+	MAZE_GL_TRACE_DRAW(GL_TRIANGLES, 3, 1);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+
+	state.setEnabled(GL_DEPTH_TEST, true);
+	state.depthMask(true);
+	state.setEnabled(GL_BLEND, false);
 }
 
 void Renderer::clear() {
@@ -62,18 +390,36 @@ void Renderer::clear() {
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
-void Renderer::beginFrame(const Camera& camera) {
+bool Renderer::selectShader(unsigned int features) {
+	// Gameplay variants are built at startup; say so if one slipped through
+	if (m_shaders && !m_shaders->isReady(features)) {
+		std::cerr << "WARNING: Shader variant 0x" << std::hex << features << std::dec
+			<< " was not prebuilt and compiles mid-frame" << std::endl;
+	}
+	m_shader = m_shaders ? m_shaders->get(features) : nullptr;
+	m_activeFeatures = m_shader ? features : 0;
+	if (!m_shader) {
+		return false;
+	}
+
 	m_shader->use();
+	return true;
+}
+
+void Renderer::beginFrame(const Camera& camera) {
+	unsigned int features = m_specularEnabled ? SHADER_FEATURE_SPECULAR : 0u;
+	if (m_textureArrayEnabled) features |= SHADER_FEATURE_TEXTURE_ARRAY;
+	if (!selectShader(features)) return;
 
 	// Set view and projection matrices
 	auto viewMatrix = camera.getViewMatrix();
 
 	// Use more appropriate near plane (0.1f instead of 0.05f)
 	// This prevents z-fighting and improves depth precision
-	auto projMatrix = camera.getProjectionMatrix(60.0f, getAspectRatio(), 0.1f, 100.0f);
+	auto projMatrix = camera.getProjectionMatrix(60.0f, getAspectRatio(), kNearPlane, kFarPlane);
 
-	m_shader->setUniformMatrix4fv("view", viewMatrix.data());
-	m_shader->setUniformMatrix4fv("projection", projMatrix.data());
+	// Shared with every other shader through the FrameData block
+	uploadFrameData(viewMatrix, projMatrix, camera.getPosition(), 0.0f);
 
 	// Set lighting uniforms with better light position
 	// Position light above and slightly in front of player
@@ -94,6 +440,8 @@ void Renderer::beginFrame(const Camera& camera) {
 }
 
 void Renderer::renderMesh(const Mesh& mesh, const Texture& texture, const float* modelMatrix) {
+	if (!m_shader) return;
+
 	// Set model matrix
 	m_shader->setUniformMatrix4fv("model", modelMatrix);
 
@@ -104,19 +452,231 @@ void Renderer::renderMesh(const Mesh& mesh, const Texture& texture, const float*
 	mesh.draw();
 }
 
+void Renderer::renderMesh(const Mesh& mesh, const TextureArray& materials, const float* modelMatrix) {
+	if (!m_shader) return;
+
+	m_shader->setUniformMatrix4fv("model", modelMatrix);
+	materials.bind(0);
+
+	// One draw regardless of how many materials the mesh uses
+	mesh.draw();
+}
+
+void Renderer::renderMeshBatch(const std::vector<const Mesh*>& meshes, const TextureArray& materials, const float* modelMatrix) {
+	if (!m_shader || meshes.empty()) return;
+
+	GpuBufferArena* arena = meshes[0]->getArena();
+	if (!arena) return;
+	buildBatch(meshes, arena);
+
+	GLStateCache& state = GLStateCache::get();
+	bool prepass = m_depthPrepassEnabled && m_depthShader;
+	if (prepass) {
+		m_depthShader->use();
+		m_depthShader->setUniformMatrix4fv("model", modelMatrix);
+		state.colorMask(false);
+		drawBatch(arena);
+		state.colorMask(true);
+
+		// The depth buffer now holds the nearest surfaces; shade only those
+		state.depthFunc(GL_LEQUAL);
+		state.depthMask(false);
+	}
+
+	m_shader->use();
+	m_shader->setUniformMatrix4fv("model", modelMatrix);
+	materials.bind(0);
+	drawBatch(arena);
+
+	if (prepass) {
+		state.depthFunc(GL_LESS);
+		state.depthMask(true);
+	}
+}
+
+void Renderer::buildBatch(const std::vector<const Mesh*>& meshes, GpuBufferArena* arena) {
+	m_batchCounts.clear();
+	m_batchOffsets.clear();
+	m_batchBaseVertices.clear();
+	m_batchCommands.clear();
+	m_batchOthers.clear();
+
+	bool indirect = m_indirectDrawSupported && m_indirectDrawEnabled;
+	for (const Mesh* mesh : meshes) {
+		if (mesh->getArena() != arena) {
+			m_batchOthers.push_back(mesh);
+			continue;
+		}
+
+		if (indirect) {
+			DrawElementsIndirectCommand command;
+			command.count = mesh->getIndexCount();
+			command.instanceCount = 1;
+			command.firstIndex = mesh->getFirstIndex();
+			command.baseVertex = static_cast<GLint>(mesh->getBaseVertex());
+			command.baseInstance = 0;
+			m_batchCommands.push_back(command);
+		}
+		else {
+			m_batchCounts.push_back(static_cast<GLsizei>(mesh->getIndexCount()));
+			m_batchOffsets.push_back(reinterpret_cast<void*>(static_cast<size_t>(mesh->getFirstIndex()) * sizeof(unsigned int)));
+			m_batchBaseVertices.push_back(static_cast<GLint>(mesh->getBaseVertex()));
+		}
+	}
+
+	if (!m_batchCommands.empty()) {
+		if (m_indirectBuffer == 0) {
+			glGenBuffers(1, &m_indirectBuffer);
+		}
+
+		// Orphan and refill; the commands change with the camera every frame
+		GLStateCache::get().bindBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirectBuffer);
+		MAZE_GL_TRACE_UPLOAD(m_batchCommands.size() * sizeof(DrawElementsIndirectCommand));
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, m_batchCommands.size() * sizeof(DrawElementsIndirectCommand),
+			m_batchCommands.data(), GL_STREAM_DRAW);
+	}
+}
+
+void Renderer::drawBatch(GpuBufferArena* arena) {
+	arena->bind();
+	if (!m_batchCommands.empty()) {
+#if defined(MAZE_GL_TRACE)
+		for (const DrawElementsIndirectCommand& command : m_batchCommands) {
+			MAZE_GL_TRACE_COUNT(GLTRACE_TRIANGLES, command.count / 3);
+		}
+#endif
+		MAZE_GL_TRACE_COUNT(GLTRACE_DRAW_CALLS, 1);
+		GLStateCache::get().bindBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirectBuffer);
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr,
+			static_cast<GLsizei>(m_batchCommands.size()), 0);
+	}
+	else if (!m_batchCounts.empty()) {
+#if defined(MAZE_GL_TRACE)
+		for (GLsizei count : m_batchCounts) {
+			MAZE_GL_TRACE_COUNT(GLTRACE_TRIANGLES, count / 3);
+		}
+#endif
+		MAZE_GL_TRACE_COUNT(GLTRACE_DRAW_CALLS, 1);
+		glMultiDrawElementsBaseVertex(GL_TRIANGLES, m_batchCounts.data(), GL_UNSIGNED_INT,
+			m_batchOffsets.data(), static_cast<GLsizei>(m_batchCounts.size()), m_batchBaseVertices.data());
+	}
+
+	// Meshes from another arena, one draw each
+	for (const Mesh* mesh : m_batchOthers) {
+		mesh->draw();
+	}
+}
+
+void Renderer::uploadFrameData(const Mat4& view, const Mat4& projection, const Vector3& viewPos, float time) {
+	if (!m_frameRing) return;
+
+	m_frameRing->beginFrame();
+
+	FrameData* data = static_cast<FrameData*>(beginBlockData(UNIFORM_BLOCK_FRAME_DATA, sizeof(FrameData)));
+	if (!data) return;
+
+	std::memcpy(data->view, view.data(), sizeof(data->view));
+	std::memcpy(data->projection, projection.data(), sizeof(data->projection));
+	data->viewPosTime[0] = viewPos.x;
+	data->viewPosTime[1] = viewPos.y;
+	data->viewPosTime[2] = viewPos.z;
+	data->viewPosTime[3] = time;
+	endBlockData();
+}
+
+void Renderer::uploadLightClusters(const Mat4& view) {
+	m_lightClusters->build(m_frameLights, view, 60.0f, getAspectRatio(), kNearPlane, kFarPlane);
+	m_lightClusters->upload();
+	m_lightClusters->bind(kClusterTableUnit, kClusterLightUnit);
+
+	// The block is always whole; entries past the light count are never read
+	PointLightData* lights = static_cast<PointLightData*>(
+		beginBlockData(UNIFORM_BLOCK_POINT_LIGHTS, kMaxPointLights * sizeof(PointLightData)));
+	if (lights) {
+		for (size_t i = 0; i < m_lightClusters->getLightCount(); ++i) {
+			const PointLight& light = m_frameLights[i];
+			lights[i].positionRadius[0] = light.position.x;
+			lights[i].positionRadius[1] = light.position.y;
+			lights[i].positionRadius[2] = light.position.z;
+			lights[i].positionRadius[3] = light.radius;
+			lights[i].color[0] = light.color.x;
+			lights[i].color[1] = light.color.y;
+			lights[i].color[2] = light.color.z;
+			lights[i].color[3] = 0.0f;
+		}
+		endBlockData();
+	}
+
+	// Tiles are counted in pixels of whatever the scene renders to this frame
+	float renderWidth = static_cast<float>(m_sceneActive ? m_sceneTarget->getRenderWidth() : m_viewportWidth);
+	float renderHeight = static_cast<float>(m_sceneActive ? m_sceneTarget->getRenderHeight() : m_viewportHeight);
+	m_shader->setUniform("u_clusterTable", static_cast<int>(kClusterTableUnit));
+	m_shader->setUniform("u_clusterLights", static_cast<int>(kClusterLightUnit));
+	m_shader->setUniform("u_clusterTileScale",
+		ClusteredLighting::kTilesX / renderWidth, ClusteredLighting::kTilesY / renderHeight);
+	m_shader->setUniform("u_clusterSlice", m_lightClusters->getSliceScale(), m_lightClusters->getSliceBias());
+}
+
+void Renderer::uploadLightGrid() {
+	m_lightGrid->update(m_frameLights);
+
+	// Only the rectangle the changed lights touched
+	int x, z, width, height;
+	if (m_lightGrid->getDirtyRect(x, z, width, height)) {
+		const float* texels = m_lightGrid->getTexels().data();
+		m_lightGridTexture->updateFloatRgba(kLightGridUnit, x, z, width, height, m_lightGrid->getWidth(),
+			texels + (static_cast<size_t>(z) * m_lightGrid->getWidth() + x) * 4);
+		m_lightGrid->clearDirty();
+	}
+
+	// Texel centres sit at (i + 0.5) texels; the shader maps world x, z straight to texture coordinates
+	const float texelSize = LightGrid::getTexelSize();
+	m_lightGridTexture->bind(kLightGridUnit);
+	m_shader->setUniform("u_lightGrid", static_cast<int>(kLightGridUnit));
+	m_shader->setUniform("u_lightGridScale",
+		1.0f / (texelSize * m_lightGrid->getWidth()), 1.0f / (texelSize * m_lightGrid->getHeight()));
+	m_shader->setUniform("u_lightGridOffset", 0.5f * texelSize);
+}
+
+void* Renderer::beginBlockData(GLuint binding, size_t size) {
+	if (!m_frameRing) return nullptr;
+
+	void* data = m_frameRing->map(size, m_blockOffset);
+	if (data) {
+		m_blockBinding = binding;
+		m_blockSize = size;
+	}
+	return data;
+}
+
+void Renderer::endBlockData() {
+	m_frameRing->unmap();
+	m_frameRing->bindRange(m_blockBinding, m_blockOffset, static_cast<GLsizeiptr>(m_blockSize));
+}
+
+void Renderer::endFrame() {
+	if (m_frameRing) {
+		m_frameRing->endFrame();
+	}
+}
+
 float Renderer::getAspectRatio() const {
 	return static_cast<float>(m_viewportWidth) / static_cast<float>(m_viewportHeight);
 }
 
 void Renderer::beginFrameEnhanced(const Camera& camera, const Vector3& portalPos, float time) {
-	m_shader->use();
+	unsigned int features = SHADER_FEATURE_FLASHLIGHT;
+	if (m_fogEnabled) features |= SHADER_FEATURE_FOG;
+	if (m_portalLightEnabled) features |= SHADER_FEATURE_PORTAL_LIGHT;
+	if (m_specularEnabled) features |= SHADER_FEATURE_SPECULAR;
+	if (m_textureArrayEnabled) features |= SHADER_FEATURE_TEXTURE_ARRAY;
+	if (!selectShader(features)) return;
 
 	// Set view and projection matrices
 	auto viewMatrix = camera.getViewMatrix();
-	auto projMatrix = camera.getProjectionMatrix(60.0f, getAspectRatio(), 0.1f, 100.0f);
+	auto projMatrix = camera.getProjectionMatrix(60.0f, getAspectRatio(), kNearPlane, kFarPlane);
 
-	m_shader->setUniformMatrix4fv("view", viewMatrix.data());
-	m_shader->setUniformMatrix4fv("projection", projMatrix.data());
+	uploadFrameData(viewMatrix, projMatrix, camera.getPosition(), time);
 
 	// Basic lighting (overhead - very subtle)
 	Vector3 lightPos = camera.getPosition() + Vector3(0.0f, 5.0f, 5.0f);
@@ -131,7 +691,6 @@ void Renderer::beginFrameEnhanced(const Camera& camera, const Vector3& portalPos
 	m_shader->setUniform("material.shininess", 16.0f);
 
 	// === FEATURE 3: FLASHLIGHT ===
-	m_shader->setUniform("u_flashlightEnabled", true);
 	m_shader->setUniform("u_flashlightPos", camera.getPosition());
 	m_shader->setUniform("u_flashlightDir", camera.getFront());
 	//m_shader->setUniform("u_flashlightCutoff", std::cos(25.0f * 3.14159 / 180.0f));      // 25 degree inner
@@ -139,22 +698,22 @@ void Renderer::beginFrameEnhanced(const Camera& camera, const Vector3& portalPos
 	m_shader->setUniform("u_flashlightIntensity", 1.5f); // Bright flashlight
 
 	// === FEATURE 3: FOG ===
-	m_shader->setUniform("u_fogEnabled", true);
-	m_shader->setUniform("u_fogColor", Vector3(0.02f, 0.03f, 0.05f)); // Very dark blue
-	m_shader->setUniform("u_fogDensity", 0.15f);
-	m_shader->setUniform("u_fogStart", 5.0f);  // Fog starts at 5 units
-	m_shader->setUniform("u_fogEnd", 15.0f);   // Completely dark at 15 units
+	if (features & SHADER_FEATURE_FOG) {
+		m_shader->setUniform("u_fogColor", Vector3(0.02f, 0.03f, 0.05f)); // Very dark blue
+		m_shader->setUniform("u_fogStart", 5.0f);  // Fog starts at 5 units
+		m_shader->setUniform("u_fogEnd", 15.0f);   // Completely dark at 15 units
+	}
 
 	// === FEATURE 3: PORTAL LIGHT ===
-	m_shader->setUniform("u_portalLightEnabled", true);
-	m_shader->setUniform("u_portalPos", portalPos);
-	m_shader->setUniform("u_portalColor", Vector3(0.0f, 0.8f, 1.0f)); // Cyan
-	m_shader->setUniform("u_portalRadius", 8.0f); // Lights walls within 8 units
-
-	// Pulsing effect for portal light
-	float portalPulse = 0.8f + 0.2f * std::sin(time * 1.5f);
-	Vector3 portalColorPulsed = Vector3(0.0f, 0.8f * portalPulse, 1.0f * portalPulse);
-	m_shader->setUniform("u_portalColor", portalColorPulsed);
+	if (features & SHADER_FEATURE_PORTAL_LIGHT) {
+		m_shader->setUniform("u_portalPos", portalPos);
+		m_shader->setUniform("u_portalRadius", 8.0f); // Lights walls within 8 units
+
+		// Pulsing effect for portal light (cyan)
+		float portalPulse = 0.8f + 0.2f * std::sin(time * 1.5f);
+		Vector3 portalColorPulsed = Vector3(0.0f, 0.8f * portalPulse, 1.0f * portalPulse);
+		m_shader->setUniform("u_portalColor", portalColorPulsed);
+	}
 
 	// Set texture sampler
 	m_shader->setUniform("textureSampler", 0);
@@ -164,45 +723,89 @@ void Renderer::beginFrameEnhanced(const Camera& camera, const Vector3& portalPos
 
 void Renderer::beginFrameWithFlashlight(const Camera& camera, const Vector3& portalPos,
 	float time, bool flashlightOn, float flashlightIntensity) {
-	m_shader->use();
+	// Pick the variant for this frame's state instead of branching per fragment.
+	// The portal light is baked into the lightmap if there is one, else with
+	// the light grid or clustered lighting it is just the first point light.
+	unsigned int features = 0;
+	if (flashlightOn && flashlightIntensity > 0.0f) features |= SHADER_FEATURE_FLASHLIGHT;
+	if (m_fogEnabled) features |= SHADER_FEATURE_FOG;
+	if (isLightmapEnabled()) features |= SHADER_FEATURE_LIGHTMAP;
+	if (isLightGridEnabled()) features |= SHADER_FEATURE_LIGHT_GRID;
+	else if (isClusteredLightingEnabled()) features |= SHADER_FEATURE_CLUSTERED_LIGHTS;
+	else if (m_portalLightEnabled && !(features & SHADER_FEATURE_LIGHTMAP)) features |= SHADER_FEATURE_PORTAL_LIGHT;
+	if (m_specularEnabled) features |= SHADER_FEATURE_SPECULAR;
+	if (m_textureArrayEnabled) features |= SHADER_FEATURE_TEXTURE_ARRAY;
+	if (!selectShader(features)) return;
 
 	auto viewMatrix = camera.getViewMatrix();
-	auto projMatrix = camera.getProjectionMatrix(60.0f, getAspectRatio(), 0.1f, 100.0f);
+	auto projMatrix = camera.getProjectionMatrix(60.0f, getAspectRatio(), kNearPlane, kFarPlane);
 
-	m_shader->setUniformMatrix4fv("view", viewMatrix.data());
-	m_shader->setUniformMatrix4fv("projection", projMatrix.data());
+	uploadFrameData(viewMatrix, projMatrix, camera.getPosition(), time);
 
-	Vector3 lightPos = camera.getPosition() + Vector3(0.0f, 5.0f, 5.0f);
+	Vector3 lightPos = camera.getPosition() + kOverheadLightOffset;
 	m_shader->setUniform("lightPos", lightPos);
 	m_shader->setUniform("viewPos", camera.getPosition());
-	m_shader->setUniform("lightColor", Vector3(0.3f, 0.3f, 0.4f));
+	m_shader->setUniform("lightColor", kOverheadLightColor);
 
-	m_shader->setUniform("material.ambient", 0.15f);
-	m_shader->setUniform("material.diffuse", 0.3f);
+	m_shader->setUniform("material.ambient", kMaterialAmbient);
+	m_shader->setUniform("material.diffuse", kMaterialDiffuse);
 	m_shader->setUniform("material.specular", 0.2f);
 	m_shader->setUniform("material.shininess", 16.0f);
 
 	// === FLASHLIGHT WITH BATTERY CONTROL ===
-	m_shader->setUniform("u_flashlightEnabled", flashlightOn);
-	m_shader->setUniform("u_flashlightPos", camera.getPosition());
-	m_shader->setUniform("u_flashlightDir", camera.getFront());
-	m_shader->setUniform("u_flashlightIntensity", flashlightIntensity); // Dynamic intensity
+	if (features & SHADER_FEATURE_FLASHLIGHT) {
+		m_shader->setUniform("u_flashlightPos", camera.getPosition());
+		m_shader->setUniform("u_flashlightDir", camera.getFront());
+		m_shader->setUniform("u_flashlightIntensity", flashlightIntensity); // Dynamic intensity
+	}
 
 	// Fog
-	m_shader->setUniform("u_fogEnabled", true);
-	m_shader->setUniform("u_fogColor", Vector3(0.02f, 0.03f, 0.05f));
-	m_shader->setUniform("u_fogDensity", 0.15f);
-	m_shader->setUniform("u_fogStart", 5.0f);
-	m_shader->setUniform("u_fogEnd", 15.0f);
+	if (features & SHADER_FEATURE_FOG) {
+		m_shader->setUniform("u_fogColor", Vector3(0.02f, 0.03f, 0.05f));
+		m_shader->setUniform("u_fogStart", 5.0f);
+		m_shader->setUniform("u_fogEnd", 15.0f);
+	}
 
 	// Portal light
-	m_shader->setUniform("u_portalLightEnabled", true);
-	m_shader->setUniform("u_portalPos", portalPos);
+	if (features & SHADER_FEATURE_PORTAL_LIGHT) {
+		m_shader->setUniform("u_portalPos", portalPos);
+		m_shader->setUniform("u_portalColor", portalLightColor(time));
+		m_shader->setUniform("u_portalRadius", kPortalLightRadius);
+	}
+
+	// Baked light; the portal's intensity is in it, its colour is set here
+	if (features & SHADER_FEATURE_LIGHTMAP) {
+		m_lightmap->bind(kLightmapUnit);
+		m_shader->setUniform("u_lightmap", static_cast<int>(kLightmapUnit));
+		m_shader->setUniform("u_portalColor", m_portalLightEnabled ? portalLightColor(time) : Vector3());
+	}
 
-	float portalPulse = 0.8f + 0.2f * std::sin(time * 1.5f);
-	Vector3 portalColorPulsed = Vector3(0.0f, 0.8f * portalPulse, 1.0f * portalPulse);
-	m_shader->setUniform("u_portalColor", portalColorPulsed);
-	m_shader->setUniform("u_portalRadius", 8.0f);
+	// Point lights
+	if (features & (SHADER_FEATURE_CLUSTERED_LIGHTS | SHADER_FEATURE_LIGHT_GRID)) {
+		m_frameLights.clear();
+		if (m_portalLightEnabled && !(features & SHADER_FEATURE_LIGHTMAP)) {
+			PointLight portal;
+			portal.position = portalPos;
+			portal.radius = kPortalLightRadius;
+			portal.color = portalLightColor(time) * kPortalLightStrength;
+			m_frameLights.push_back(portal);
+		}
+		m_frameLights.insert(m_frameLights.end(), m_pointLights.begin(), m_pointLights.end());
+
+		if (features & SHADER_FEATURE_LIGHT_GRID) {
+			if (features & SHADER_FEATURE_FLASHLIGHT) {
+				PointLight spill;
+				spill.position = camera.getPosition();
+				spill.radius = kFlashlightSpillRadius;
+				spill.color = kFlashlightSpillColor * flashlightIntensity;
+				m_frameLights.push_back(spill);
+			}
+			uploadLightGrid();
+		}
+		else {
+			uploadLightClusters(viewMatrix);
+		}
+	}
 
 	m_shader->setUniform("textureSampler", 0);
 }
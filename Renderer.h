@@ -2,10 +2,75 @@
 #define RENDERER_H
 
 #include <memory>
+#include <vector>
 #include "ShaderProgram.h"
+#include "ProgramBinaryCache.h"
+#include "GpuBufferArena.h"
+#include "StreamingRingBuffer.h"
+#include "SceneFramebuffer.h"
+#include "HalfResolutionTarget.h"
+#include "ClusteredLighting.h"
+#include "LightGrid.h"
+#include "LightmapBaker.h"
+#include "DynamicResolution.h"
 #include "Camera.h"
 #include "Mesh.h"
 #include "Texture.h"
+#include "TextureArray.h"
+
+/**
+ * @brief Feature bits for the main surface shader permutations
+ *
+ * Each bit maps to a #define in shaders/fragment.glsl (same order as
+ * Renderer::initialize passes them to ShaderPermutationSet).
+ */
+enum ShaderFeature : unsigned int {
+	SHADER_FEATURE_FLASHLIGHT = 1u << 0,
+	SHADER_FEATURE_FOG = 1u << 1,
+	SHADER_FEATURE_PORTAL_LIGHT = 1u << 2,
+	SHADER_FEATURE_SPECULAR = 1u << 3,
+	SHADER_FEATURE_TEXTURE_ARRAY = 1u << 4,  // Sample a TextureArray by per-vertex layer
+	SHADER_FEATURE_CLUSTERED_LIGHTS = 1u << 5,  // Point lights binned by ClusteredLighting
+	SHADER_FEATURE_LIGHTMAP = 1u << 6,  // Static light from a baked Lightmap
+	SHADER_FEATURE_LIGHT_GRID = 1u << 7  // Point lights flood-filled over the maze by LightGrid
+};
+
+/**
+ * @brief Uniform block binding points, assigned to every program as it is built
+ */
+enum UniformBlockBinding {
+	UNIFORM_BLOCK_FRAME_DATA = 0,
+	UNIFORM_BLOCK_COLLECTIBLE_INSTANCES = 1,
+	UNIFORM_BLOCK_POINT_LIGHTS = 2
+};
+
+/**
+ * @brief Layout of the FrameData uniform block (std140), written once per frame
+ */
+struct FrameData {
+	float view[16];
+	float projection[16];
+	float viewPosTime[4];  // xyz = camera position, w = time in seconds
+};
+
+/**
+ * @brief One element of the CollectibleInstances uniform block (std140)
+ */
+struct CollectibleInstance {
+	float model[16];
+	float params[4];  // x = pulse
+};
+
+// Must match MAX_COLLECTIBLE_INSTANCES in collectible_vertex.glsl
+const int kMaxCollectibleInstances = 128;
+
+/**
+ * @brief One element of the PointLights uniform block (std140), kMaxPointLights of them
+ */
+struct PointLightData {
+	float positionRadius[4];  // xyz = world position, w = radius
+	float color[4];
+};
 
 /**
  * @class Renderer
@@ -17,14 +82,20 @@
 class Renderer {
 public:
 	Renderer();
-	~Renderer() = default;
+	~Renderer();
 
 	/**
-	 * @brief Initialize OpenGL state and load shaders
+	 * @brief Initialize OpenGL state and submit shaders for compilation
 	 * @return true if successful, false otherwise
 	 */
 	bool initialize();
 
+	/**
+	 * @brief Wait for the shaders submitted by initialize()
+	 * @return false if a required variant failed to build
+	 */
+	bool finishShaders();
+
 	/**
 	 * @brief Set viewport size
 	 */
@@ -35,6 +106,54 @@ public:
 	 */
 	void clear();
 
+	/**
+	 * @brief Redirect 3D rendering into the offscreen scene target
+	 *
+	 * The target is rendered at getRenderScale() times the viewport size.
+	 * Falls back to drawing straight to the window if the target or the
+	 * upscale shader is unavailable.
+	 */
+	void beginScene();
+
+	/**
+	 * @brief Upscale the scene to the window; 2D drawn afterwards is at native resolution
+	 */
+	void endScene();
+
+	/**
+	 * @brief Redirect the following draws into a half-resolution target
+	 *
+	 * Call between beginScene() and endScene(), after the opaque geometry:
+	 * the scene depth is downsampled first so the effect is still hidden
+	 * behind walls. The effect's colour must come out as an additive term
+	 * (blend GL_ONE or GL_SRC_ALPHA into GL_ONE); depth writes stay off.
+	 * @return false if the pass is disabled or unavailable; then nothing
+	 *         changed and the draws go to the scene as usual
+	 */
+	bool beginHalfResolutionPass();
+
+	/**
+	 * @brief Add the half-resolution colour to the scene with a bilateral upsample
+	 *
+	 * Leaves depth test on, depth writes on and blending off.
+	 */
+	void endHalfResolutionPass();
+
+	// On by default; off draws effects at full resolution (to compare cost and quality)
+	void setHalfResolutionEffectsEnabled(bool enabled) { m_halfResolutionEnabled = enabled; }
+	bool isHalfResolutionEffectsEnabled() const { return m_halfResolutionEnabled; }
+
+	/**
+	 * @brief Current render scale per axis (1.0 = native)
+	 */
+	float getRenderScale() const { return m_dynamicResolution ? m_dynamicResolution->getScale() : 1.0f; }
+	DynamicResolution* getDynamicResolution() const { return m_dynamicResolution.get(); }
+
+	/**
+	 * @brief Framebuffer the finished frame goes to (0 = the window)
+	 */
+	void setOutputFramebuffer(GLuint framebuffer) { m_outputFramebuffer = framebuffer; }
+
 	void beginFrameEnhanced(const Camera& camera, const Vector3& portalPos, float time);
 
 	void beginFrameWithFlashlight(const Camera& camera, const Vector3& portalPos, float time, bool flashlightOn, float flashlightIntensity);
@@ -53,16 +172,236 @@ public:
 	 */
 	void renderMesh(const Mesh& mesh, const Texture& texture, const float* modelMatrix);
 
+	/**
+	 * @brief Render a mesh whose vertices select their material layer
+	 *
+	 * Requires texture arrays to be enabled (see setTextureArrayEnabled).
+	 */
+	void renderMesh(const Mesh& mesh, const TextureArray& materials, const float* modelMatrix);
+
+	/**
+	 * @brief Render several meshes sharing one material array in a single call
+	 *
+	 * The meshes' arena ranges are gathered into one multi-draw: indirect
+	 * (glMultiDrawElementsIndirect) when the driver supports it and it is
+	 * enabled, glMultiDrawElementsBaseVertex otherwise. Meshes from another
+	 * arena than the first are drawn one by one.
+	 *
+	 * With the depth pre-pass on, the batch is drawn twice: depth only,
+	 * then shaded with GL_LEQUAL and depth writes off, so the surface
+	 * shader runs once per visible pixel whatever the draw order.
+	 */
+	void renderMeshBatch(const std::vector<const Mesh*>& meshes, const TextureArray& materials, const float* modelMatrix);
+
+	/**
+	 * @brief Point lights for the frames that follow, on top of the flashlight
+	 *
+	 * beginFrameWithFlashlight() bins them (and the portal light, unless
+	 * the lightmap holds it) into
+	 * view-space clusters, so each fragment only shades the lights that
+	 * can reach it. Only the first kMaxPointLights, minus one for the
+	 * portal, are used. With the light grid on they are flood-filled
+	 * into it instead, with no limit.
+	 */
+	void setPointLights(const std::vector<PointLight>& lights) { m_pointLights = lights; }
+
+	// On by default; off falls back to the portal light alone, as a uniform
+	void setClusteredLightingEnabled(bool enabled) { m_clusteredLightingEnabled = enabled; }
+	bool isClusteredLightingEnabled() const { return m_clusteredLightingEnabled && m_lightClusters; }
+
+	/**
+	 * @brief Size the light grid for a maze (needed before it can be enabled)
+	 */
+	void setLightGridMaze(const Maze& maze);
+
+	/**
+	 * @brief Light the maze from a LightGrid instead of clustered point lights
+	 *
+	 * Off by default. On, beginFrameWithFlashlight flood-fills the point
+	 * lights, the portal light (unless baked) and a soft spill around the
+	 * flashlight into the grid, refilling only lights that changed since
+	 * the last frame, and uploads the texels that changed. Each fragment
+	 * then reads one bilinear texel instead of looping over lights; light
+	 * trades N.L for its average and loses its height, but keeps to the
+	 * corridors.
+	 *
+	 * Call after setLightGridMaze() and finishShaders(), before the first
+	 * frame: enabling builds the grid's shader variants (flashlight on and
+	 * off) right away, so gameplay never compiles one.
+	 */
+	void setLightGridEnabled(bool enabled);
+	bool isLightGridEnabled() const { return m_lightGridEnabled && m_lightGrid; }
+	const LightGrid* getLightGrid() const { return m_lightGrid.get(); }
+
+	/**
+	 * @brief The static part of beginFrameWithFlashlight's lighting, for LightmapBaker
+	 *
+	 * The overhead light follows the camera at a fixed offset, so from any
+	 * surface near the player it arrives from about the same direction;
+	 * baked, it becomes a directional light along that offset.
+	 */
+	static LightmapLighting getStaticLighting(const Vector3& portalPos);
+
+	/**
+	 * @brief Upload the maze's lightmap (its meshes carry the atlas coordinates)
+	 *
+	 * While it is enabled, beginFrameWithFlashlight takes the ambient,
+	 * overhead and portal light from it; only the flashlight, specular
+	 * highlights, point lights and the portal's pulsing colour stay live.
+	 */
+	void setLightmap(const Lightmap& lightmap);
+
+	// On once a lightmap is set; off lights every fragment live again
+	void setLightmapEnabled(bool enabled) { m_lightmapEnabled = enabled; }
+	bool isLightmapEnabled() const { return m_lightmapEnabled && m_lightmap; }
+
+	// Depth pre-pass for renderMeshBatch
+	void setDepthPrepassEnabled(bool enabled) { m_depthPrepassEnabled = enabled; }
+	bool isDepthPrepassEnabled() const { return m_depthPrepassEnabled && m_depthShader; }
+
+	// Indirect multi-draw (GL 4.3 / ARB_multi_draw_indirect); on by default where supported
+	void setIndirectDrawEnabled(bool enabled) { m_indirectDrawEnabled = enabled; }
+	bool isIndirectDrawSupported() const { return m_indirectDrawSupported; }
+
+	/**
+	 * @brief Reserve this frame's data for a uniform block in the streaming buffer
+	 *
+	 * Write the data through the returned pointer, then call endBlockData()
+	 * before the draws that read it. The whole block must be covered, even
+	 * if only part of an array is used.
+	 * @return nullptr if the frame's streaming space is exhausted
+	 */
+	void* beginBlockData(GLuint binding, size_t size);
+	void endBlockData();
+
+	/**
+	 * @brief Fence this frame's streamed data; call after the last 3D draw
+	 */
+	void endFrame();
+
 	/**
 	 * @brief Get aspect ratio
 	 */
 	float getAspectRatio() const;
 
+	// Scene-wide feature toggles; each frame picks the matching shader variant
+	void setFogEnabled(bool enabled) { m_fogEnabled = enabled; }
+	void setPortalLightEnabled(bool enabled) { m_portalLightEnabled = enabled; }
+	void setSpecularEnabled(bool enabled) { m_specularEnabled = enabled; }
+	// Surfaces sample a TextureArray (on by default); turn off to use plain Textures
+	void setTextureArrayEnabled(bool enabled) { m_textureArrayEnabled = enabled; }
+
+	/**
+	 * @brief Feature mask of the variant bound by the last beginFrame call
+	 */
+	unsigned int getActiveFeatures() const { return m_activeFeatures; }
+
+	/**
+	 * @brief Program binary cache shared by every ShaderProgram (created in initialize)
+	 */
+	ProgramBinaryCache* getProgramCache() const { return m_programCache.get(); }
+
+	/**
+	 * @brief Buffer arena every Mesh allocates from (created in initialize)
+	 */
+	GpuBufferArena* getMeshArena() const { return m_meshArena.get(); }
+
 private:
-	std::unique_ptr<ShaderProgram> m_shader;
+	std::unique_ptr<ProgramBinaryCache> m_programCache;
+	std::unique_ptr<GpuBufferArena> m_meshArena;  // Must outlive every Mesh
+	std::unique_ptr<StreamingRingBuffer> m_frameRing;
+	std::unique_ptr<SceneFramebuffer> m_sceneTarget;
+	std::unique_ptr<DynamicResolution> m_dynamicResolution;
+	std::unique_ptr<ShaderProgram> m_upscaleShader;
+	std::unique_ptr<ShaderProgram> m_depthShader;  // Depth pre-pass
+	std::unique_ptr<HalfResolutionTarget> m_halfTarget;
+	std::unique_ptr<ShaderProgram> m_depthDownsampleShader;
+	std::unique_ptr<ShaderProgram> m_bilateralShader;
+	bool m_halfResolutionEnabled;
+	std::unique_ptr<ClusteredLighting> m_lightClusters;
+	std::vector<PointLight> m_pointLights;  // As given to setPointLights
+	std::vector<PointLight> m_frameLights;  // The portal light (unless baked), m_pointLights, then any flashlight spill
+	bool m_clusteredLightingEnabled;
+	std::unique_ptr<Texture> m_lightmap;
+	bool m_lightmapEnabled;
+	std::unique_ptr<LightGrid> m_lightGrid;
+	std::unique_ptr<Texture> m_lightGridTexture;
+	bool m_lightGridEnabled;
+	std::unique_ptr<ShaderPermutationSet> m_shaders;
+	ShaderProgram* m_shader;  // Variant selected for the current frame (owned by m_shaders)
+	unsigned int m_activeFeatures;
 	int m_viewportWidth;
 	int m_viewportHeight;
 
+	bool m_fogEnabled;
+	bool m_portalLightEnabled;
+	bool m_specularEnabled;
+	bool m_textureArrayEnabled;
+
+	// Multi-draw scratch arrays, reused every batch
+	struct DrawElementsIndirectCommand {
+		GLuint count;
+		GLuint instanceCount;
+		GLuint firstIndex;
+		GLint baseVertex;
+		GLuint baseInstance;
+	};
+	std::vector<GLsizei> m_batchCounts;
+	std::vector<void*> m_batchOffsets;  // GLEW declares the offsets array non-const
+	std::vector<GLint> m_batchBaseVertices;
+	std::vector<DrawElementsIndirectCommand> m_batchCommands;
+	std::vector<const Mesh*> m_batchOthers;  // Meshes from another arena
+	GLuint m_indirectBuffer;
+	bool m_indirectDrawSupported;
+	bool m_indirectDrawEnabled;
+	bool m_depthPrepassEnabled;
+
+	// Slice opened by beginBlockData
+	GLintptr m_blockOffset;
+	size_t m_blockSize;
+	GLuint m_blockBinding;
+
+	GLuint m_fullscreenVao;  // Empty; fullscreen passes generate their triangle
+	bool m_sceneActive;
+	GLuint m_outputFramebuffer;
+
+	/**
+	 * @brief Start the streaming frame and fill the FrameData block
+	 */
+	void uploadFrameData(const Mat4& view, const Mat4& projection, const Vector3& viewPos, float time);
+
+	/**
+	 * @brief Bin m_frameLights for the view, stream them and bind the clusters to the bound variant
+	 */
+	void uploadLightClusters(const Mat4& view);
+
+	/**
+	 * @brief Fill m_frameLights into the light grid, upload what changed and bind it to the bound variant
+	 */
+	void uploadLightGrid();
+
+	/**
+	 * @brief Fill the multi-draw arrays (and the indirect buffer) for a batch
+	 */
+	void buildBatch(const std::vector<const Mesh*>& meshes, GpuBufferArena* arena);
+
+	/**
+	 * @brief Issue the batch built by buildBatch() with the bound program
+	 */
+	void drawBatch(GpuBufferArena* arena);
+
+	/**
+	 * @brief Bind the shader variant for a feature mask
+	 * @return false if the variant is unavailable
+	 */
+	bool selectShader(unsigned int features);
+
+	/**
+	 * @brief Every feature on (the lightmap carries the portal light); the variant gameplay normally uses
+	 */
+	static unsigned int getDefaultFeatures();
+	static unsigned int getLightGridFeatures();  // getDefaultFeatures() with the grid instead of clusters
+
 	/**
 	 * @brief Initialize OpenGL settings
 	 */
@@ -0,0 +1,152 @@
+#include "SceneFramebuffer.h"
+#include "GLStateCache.h"
+#include <algorithm>
+#include <iostream>
+
+SceneFramebuffer::SceneFramebuffer()
+    : m_framebuffer(0),
+      m_resolveFramebuffer(0),
+      m_colorTexture(0),
+      m_depthTexture(0),
+      m_colorRenderbuffer(0),
+      m_depthRenderbuffer(0),
+      m_width(0),
+      m_height(0),
+      m_samples(1),
+      m_renderWidth(0),
+      m_renderHeight(0) {}
+
+SceneFramebuffer::~SceneFramebuffer() {
+    release();
+}
+
+bool SceneFramebuffer::create(int width, int height, int samples) {
+    release();
+
+    GLint maxSamples = 1;
+    glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+    m_samples = std::max(1, std::min(samples, static_cast<int>(maxSamples)));
+    m_width = width;
+    m_height = height;
+    m_renderWidth = width;
+    m_renderHeight = height;
+
+    // Sampled by the upscale pass; linear so the upscale is bilinear for free
+    glGenTextures(1, &m_colorTexture);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D, m_colorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    // Same format as the depth renderbuffer, which depth blits require
+    glGenTextures(1, &m_depthTexture);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D, m_depthTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, width, height, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D, 0);
+
+    if (m_samples > 1) {
+        glGenRenderbuffers(1, &m_depthRenderbuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_depthRenderbuffer);
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, m_samples, GL_DEPTH24_STENCIL8, width, height);
+
+        glGenRenderbuffers(1, &m_colorRenderbuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_colorRenderbuffer);
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, m_samples, GL_RGBA8, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    }
+
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    if (m_samples > 1) {
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorRenderbuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depthRenderbuffer);
+    }
+    else {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_colorTexture, 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, m_depthTexture, 0);
+    }
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+    if (complete && m_samples > 1) {
+        glGenFramebuffers(1, &m_resolveFramebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_resolveFramebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_colorTexture, 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, m_depthTexture, 0);
+        complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (!complete) {
+        std::cerr << "ERROR: Scene framebuffer incomplete (" << width << "x" << height
+            << ", " << m_samples << " samples)" << std::endl;
+        release();
+        return false;
+    }
+    return true;
+}
+
+void SceneFramebuffer::bind(int renderWidth, int renderHeight) {
+    m_renderWidth = std::max(1, std::min(renderWidth, m_width));
+    m_renderHeight = std::max(1, std::min(renderHeight, m_height));
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glViewport(0, 0, m_renderWidth, m_renderHeight);
+}
+
+void SceneFramebuffer::resolve() {
+    if (m_samples <= 1) {
+        return;  // Rendered straight into the texture
+    }
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_resolveFramebuffer);
+    glBlitFramebuffer(0, 0, m_renderWidth, m_renderHeight, 0, 0, m_renderWidth, m_renderHeight,
+        GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void SceneFramebuffer::resolveDepth() {
+    if (m_samples <= 1) {
+        return;  // Rendered straight into the texture
+    }
+
+    // Multisampled depth cannot be averaged; NEAREST keeps one sample
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_resolveFramebuffer);
+    glBlitFramebuffer(0, 0, m_renderWidth, m_renderHeight, 0, 0, m_renderWidth, m_renderHeight,
+        GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+}
+
+void SceneFramebuffer::release() {
+    if (m_resolveFramebuffer != 0) {
+        glDeleteFramebuffers(1, &m_resolveFramebuffer);
+        m_resolveFramebuffer = 0;
+    }
+    if (m_framebuffer != 0) {
+        glDeleteFramebuffers(1, &m_framebuffer);
+        m_framebuffer = 0;
+    }
+    if (m_colorRenderbuffer != 0) {
+        glDeleteRenderbuffers(1, &m_colorRenderbuffer);
+        m_colorRenderbuffer = 0;
+    }
+    if (m_depthRenderbuffer != 0) {
+        glDeleteRenderbuffers(1, &m_depthRenderbuffer);
+        m_depthRenderbuffer = 0;
+    }
+    if (m_colorTexture != 0) {
+        GLStateCache::get().deleteTexture(m_colorTexture);
+        m_colorTexture = 0;
+    }
+    if (m_depthTexture != 0) {
+        GLStateCache::get().deleteTexture(m_depthTexture);
+        m_depthTexture = 0;
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef SCENEFRAMEBUFFER_H
+#define SCENEFRAMEBUFFER_H
+
+#include <gl/glew/glew.h>
+
+/**
+ * @class SceneFramebuffer
+ * @brief Offscreen colour + depth target the 3D scene renders into
+ *
+ * Storage is allocated once at the full output size. A lower render scale
+ * only shrinks the viewport used inside it, so changing the scale every
+ * frame never reallocates anything. With samples > 1 the scene renders
+ * into multisampled renderbuffers and resolve() blits the used area into
+ * a single-sample texture; otherwise it renders into the texture directly.
+ * Depth works the same way through resolveDepth() and getDepthTexture(),
+ * for passes that need the scene depth (see HalfResolutionTarget).
+ */
+class SceneFramebuffer {
+public:
+    SceneFramebuffer();
+    ~SceneFramebuffer();
+
+    SceneFramebuffer(const SceneFramebuffer&) = delete;
+    SceneFramebuffer& operator=(const SceneFramebuffer&) = delete;
+
+    /**
+     * @brief (Re)allocate for a maximum size
+     * @return false if the framebuffer is incomplete
+     */
+    bool create(int width, int height, int samples);
+
+    /**
+     * @brief Bind for rendering and set the viewport to the scaled size
+     */
+    void bind(int renderWidth, int renderHeight);
+
+    /**
+     * @brief Make the rendered area available in getColorTexture()
+     */
+    void resolve();
+
+    /**
+     * @brief Make the rendered area's depth available in getDepthTexture()
+     *
+     * Takes one sample per pixel when multisampling. Leaves the scene target bound.
+     */
+    void resolveDepth();
+
+    GLuint getColorTexture() const { return m_colorTexture; }
+    GLuint getDepthTexture() const { return m_depthTexture; }
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    int getRenderWidth() const { return m_renderWidth; }
+    int getRenderHeight() const { return m_renderHeight; }
+    bool isValid() const { return m_framebuffer != 0; }
+
+private:
+    GLuint m_framebuffer;         // Render target (multisampled if m_samples > 1)
+    GLuint m_resolveFramebuffer;  // Wraps m_colorTexture and m_depthTexture when multisampling
+    GLuint m_colorTexture;
+    GLuint m_depthTexture;        // GL_DEPTH24_STENCIL8, read as depth
+    GLuint m_colorRenderbuffer;
+    GLuint m_depthRenderbuffer;
+    int m_width;
+    int m_height;
+    int m_samples;
+    int m_renderWidth;
+    int m_renderHeight;
+
+    void release();
+};
+
+#endif // SCENEFRAMEBUFFER_H
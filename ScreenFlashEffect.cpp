@@ -7,9 +7,6 @@ ScreenFlashEffect::ScreenFlashEffect()
     m_duration(0.5f),
     m_elapsed(0.0f),
     m_active(false) {
-
-    // Flash overlay will be resized in draw() to match window size
-    m_flashOverlay.setFillColor(sf::Color(255, 255, 255, 0));
 }
 
 void ScreenFlashEffect::trigger(const sf::Color& color, float duration) {
@@ -31,27 +28,29 @@ void ScreenFlashEffect::update(float deltaTime) {
     }
 }
 
-void ScreenFlashEffect::draw(sf::RenderWindow& window) {
-    if (!m_active) return;
+sf::Color ScreenFlashEffect::getColor() const {
+    if (!m_active) return sf::Color::Transparent;
+
+    // Apply color with calculated alpha
+    sf::Color flashColor = m_flashColor;
+    flashColor.a = static_cast<sf::Uint8>(calculateAlpha());
+    return flashColor;
+}
 
-    // Resize overlay to match window
+void ScreenFlashEffect::draw(sf::RenderWindow& window, const sf::Color& color) {
+    if (color.a == 0) return;
+
+    // Overlay covering the whole window
     sf::Vector2u windowSize = window.getSize();
-    m_flashOverlay.setSize(sf::Vector2f(
+    sf::RectangleShape overlay(sf::Vector2f(
         static_cast<float>(windowSize.x),
         static_cast<float>(windowSize.y)
     ));
-    m_flashOverlay.setPosition(0, 0);
-
-    // Calculate alpha based on animation curve
-    int alpha = calculateAlpha();
-
-    // Apply color with calculated alpha
-    sf::Color flashColor = m_flashColor;
-    flashColor.a = static_cast<sf::Uint8>(alpha);
-    m_flashOverlay.setFillColor(flashColor);
+    overlay.setPosition(0, 0);
+    overlay.setFillColor(color);
 
     // Draw the overlay
-    window.draw(m_flashOverlay);
+    window.draw(overlay);
 }
 
 int ScreenFlashEffect::calculateAlpha() const {
@@ -11,14 +11,17 @@ public:
     // Update the flash animation
     void update(float deltaTime);
 
-    // Draw the flash overlay
-    void draw(sf::RenderWindow& window);
+    // Overlay colour for the current moment (alpha 0 when inactive)
+    sf::Color getColor() const;
+
+    // Draw an overlay of the given colour; takes a value from getColor(),
+    // possibly captured on another thread
+    static void draw(sf::RenderWindow& window, const sf::Color& color);
 
     // Check if flash is currently active
     bool isActive() const { return m_active; }
 
 private:
-    sf::RectangleShape m_flashOverlay;
     sf::Color m_flashColor;
     float m_duration;
     float m_elapsed;
@@ -1,32 +1,97 @@
 #include "ShaderProgram.h"
+#include "GLStateCache.h"
+#include "GLTrace.h"
+#include "ProgramBinaryCache.h"
+#include <chrono>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 
-ShaderProgram::ShaderProgram() : m_program(0) {}
+ProgramBinaryCache* ShaderProgram::s_binaryCache = nullptr;
+bool ShaderProgram::s_parallelCompile = false;
+std::vector<std::pair<std::string, GLuint>> ShaderProgram::s_uniformBlocks;
+
+namespace {
+    typedef std::chrono::steady_clock CompileClock;
+
+    float millisecondsSince(CompileClock::time_point start) {
+        return std::chrono::duration<float, std::milli>(CompileClock::now() - start).count();
+    }
+}
+
+ShaderProgram::ShaderProgram()
+    : m_program(0),
+      m_pendingVertex(0),
+      m_pendingFragment(0),
+      m_pendingCacheKey(0),
+      m_pendingMilliseconds(0.0f),
+      m_pending(false) {}
 
 ShaderProgram::~ShaderProgram() {
+    releasePendingShaders();
     if (m_program != 0) {
         glDeleteProgram(m_program);
     }
 }
 
-ShaderProgram::ShaderProgram(ShaderProgram&& other) noexcept : m_program(other.m_program) {
+ShaderProgram::ShaderProgram(ShaderProgram&& other) noexcept
+    : m_program(other.m_program),
+      m_pendingVertex(other.m_pendingVertex),
+      m_pendingFragment(other.m_pendingFragment),
+      m_pendingCacheKey(other.m_pendingCacheKey),
+      m_pendingMilliseconds(other.m_pendingMilliseconds),
+      m_pending(other.m_pending) {
     other.m_program = 0;
+    other.m_pendingVertex = 0;
+    other.m_pendingFragment = 0;
+    other.m_pending = false;
 }
 
 ShaderProgram& ShaderProgram::operator=(ShaderProgram&& other) noexcept {
     if (this != &other) {
+        releasePendingShaders();
         if (m_program != 0) {
             glDeleteProgram(m_program);
         }
         m_program = other.m_program;
+        m_pendingVertex = other.m_pendingVertex;
+        m_pendingFragment = other.m_pendingFragment;
+        m_pendingCacheKey = other.m_pendingCacheKey;
+        m_pendingMilliseconds = other.m_pendingMilliseconds;
+        m_pending = other.m_pending;
         other.m_program = 0;
+        other.m_pendingVertex = 0;
+        other.m_pendingFragment = 0;
+        other.m_pending = false;
     }
     return *this;
 }
 
-bool ShaderProgram::loadFromFile(const std::string& vertexPath, const std::string& fragmentPath) {
+bool ShaderProgram::enableParallelCompile() {
+    // 0xFFFFFFFF lets the driver pick the number of compiler threads
+    if (GLEW_KHR_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+        s_parallelCompile = true;
+    }
+    else if (GLEW_ARB_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+        s_parallelCompile = true;
+    }
+    return s_parallelCompile;
+}
+
+bool ShaderProgram::loadFromFile(const std::string& vertexPath, const std::string& fragmentPath,
+                                 const std::vector<std::string>& defines) {
+    return submitFromFile(vertexPath, fragmentPath, defines) && finish();
+}
+
+bool ShaderProgram::loadFromSource(const std::string& vertexSource, const std::string& fragmentSource,
+                                   const std::vector<std::string>& defines) {
+    return submitFromSource(vertexSource, fragmentSource, defines) && finish();
+}
+
+bool ShaderProgram::submitFromFile(const std::string& vertexPath, const std::string& fragmentPath,
+                                   const std::vector<std::string>& defines) {
     // Read shader sources
     std::string vertexSource = readShaderFile(vertexPath);
     std::string fragmentSource = readShaderFile(fragmentPath);
@@ -36,28 +101,147 @@ bool ShaderProgram::loadFromFile(const std::string& vertexPath, const std::strin
         return false;
     }
 
-    // Compile shaders
-    GLuint vertexShader = compileShader(vertexSource, GL_VERTEX_SHADER);
-    GLuint fragmentShader = compileShader(fragmentSource, GL_FRAGMENT_SHADER);
+    return submitFromSource(vertexSource, fragmentSource, defines);
+}
 
-    if (vertexShader == 0 || fragmentShader == 0) {
-        if (vertexShader != 0) glDeleteShader(vertexShader);
-        if (fragmentShader != 0) glDeleteShader(fragmentShader);
-        return false;
+bool ShaderProgram::submitFromSource(const std::string& vertexSource, const std::string& fragmentSource,
+                                     const std::vector<std::string>& defines) {
+    CompileClock::time_point submitStart = CompileClock::now();
+
+    std::string finalVertexSource = injectDefines(vertexSource, defines);
+    std::string finalFragmentSource = injectDefines(fragmentSource, defines);
+
+    // Defines are part of the final sources, so they are part of the key too
+    m_pendingCacheKey = 0;
+    if (s_binaryCache != nullptr && s_binaryCache->isSupported()) {
+        m_pendingCacheKey = s_binaryCache->computeKey(finalVertexSource, finalFragmentSource);
+
+        GLuint program = glCreateProgram();
+        if (s_binaryCache->load(m_pendingCacheKey, program)) {
+            m_program = program;
+            bindUniformBlocks();
+            return true;
+        }
+        glDeleteProgram(program);  // Missing or stale entry, compile below
     }
 
-    // Link program
-    bool success = linkProgram(vertexShader, fragmentShader);
+    // Queue compile and link without querying any status, so the driver
+    // (or its compiler threads) can work while we do something else
+    m_pendingVertex = compileShader(finalVertexSource, GL_VERTEX_SHADER);
+    m_pendingFragment = compileShader(finalFragmentSource, GL_FRAGMENT_SHADER);
+    linkProgram(m_pendingVertex, m_pendingFragment);
+
+    m_pending = true;
+    m_pendingMilliseconds = millisecondsSince(submitStart);
+    return true;
+}
+
+bool ShaderProgram::isCompletionReady() const {
+    if (!m_pending) {
+        return true;
+    }
+    if (!s_parallelCompile) {
+        return true;  // No way to ask without blocking; finish() will wait
+    }
+
+    GLint done = GL_FALSE;
+    glGetProgramiv(m_program, GL_COMPLETION_STATUS_KHR, &done);
+    return done == GL_TRUE;
+}
+
+bool ShaderProgram::finish() {
+    if (!m_pending) {
+        return m_program != 0;
+    }
+
+    CompileClock::time_point finishStart = CompileClock::now();
+
+    // Compile errors are more useful than the resulting link error
+    bool success = checkCompileErrors(m_pendingVertex, "VERTEX") &&
+        checkCompileErrors(m_pendingFragment, "FRAGMENT") &&
+        checkLinkErrors();
 
     // Clean up shaders (no longer needed after linking)
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    releasePendingShaders();
+    m_pending = false;
+
+    if (!success) {
+        glDeleteProgram(m_program);
+        m_program = 0;
+        return false;
+    }
+
+    if (s_binaryCache != nullptr && s_binaryCache->isSupported()) {
+        // Only main-thread time counts: that is what a cache hit saves
+        s_binaryCache->store(m_pendingCacheKey, m_program, m_pendingMilliseconds + millisecondsSince(finishStart));
+    }
+
+    bindUniformBlocks();
+    return true;
+}
+
+void ShaderProgram::registerUniformBlock(const std::string& name, GLuint binding) {
+    for (auto& block : s_uniformBlocks) {
+        if (block.first == name) {
+            block.second = binding;
+            return;
+        }
+    }
+    s_uniformBlocks.emplace_back(name, binding);
+}
 
-    return success;
+void ShaderProgram::bindUniformBlocks() const {
+    for (const auto& block : s_uniformBlocks) {
+        GLuint index = glGetUniformBlockIndex(m_program, block.first.c_str());
+        if (index != GL_INVALID_INDEX) {
+            glUniformBlockBinding(m_program, index, block.second);
+        }
+    }
+}
+
+void ShaderProgram::releasePendingShaders() {
+    if (m_pendingVertex != 0) {
+        glDeleteShader(m_pendingVertex);
+        m_pendingVertex = 0;
+    }
+    if (m_pendingFragment != 0) {
+        glDeleteShader(m_pendingFragment);
+        m_pendingFragment = 0;
+    }
+}
+
+std::string ShaderProgram::injectDefines(const std::string& source, const std::vector<std::string>& defines) {
+    if (defines.empty()) {
+        return source;
+    }
+
+    std::string header;
+    for (const auto& define : defines) {
+        header += "#define " + define + "\n";
+    }
+
+    // #version must stay the first directive, so insert after that line
+    size_t versionPos = source.find("#version");
+    if (versionPos == std::string::npos) {
+        return header + "#line 1\n" + source;
+    }
+
+    size_t lineEnd = source.find('\n', versionPos);
+    if (lineEnd == std::string::npos) {
+        return source + "\n" + header;
+    }
+
+    int nextLine = 2;
+    for (size_t i = 0; i < versionPos; ++i) {
+        if (source[i] == '\n') ++nextLine;
+    }
+
+    return source.substr(0, lineEnd + 1) + header +
+        "#line " + std::to_string(nextLine) + "\n" + source.substr(lineEnd + 1);
 }
 
 void ShaderProgram::use() const {
-    glUseProgram(m_program);
+    GLStateCache::get().useProgram(m_program);
 }
 
 GLuint ShaderProgram::compileShader(const std::string& source, GLenum type) {
@@ -65,23 +249,17 @@ GLuint ShaderProgram::compileShader(const std::string& source, GLenum type) {
     const char* sourceCStr = source.c_str();
     glShaderSource(shader, 1, &sourceCStr, nullptr);
     glCompileShader(shader);
-
-    std::string typeStr = (type == GL_VERTEX_SHADER) ? "VERTEX" : "FRAGMENT";
-    if (!checkCompileErrors(shader, typeStr)) {
-        glDeleteShader(shader);
-        return 0;
-    }
-
     return shader;
 }
 
-bool ShaderProgram::linkProgram(GLuint vertexShader, GLuint fragmentShader) {
+void ShaderProgram::linkProgram(GLuint vertexShader, GLuint fragmentShader) {
     m_program = glCreateProgram();
     glAttachShader(m_program, vertexShader);
     glAttachShader(m_program, fragmentShader);
+    if (s_binaryCache != nullptr && s_binaryCache->isSupported()) {
+        glProgramParameteri(m_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     glLinkProgram(m_program);
-
-    return checkLinkErrors();
 }
 
 bool ShaderProgram::checkCompileErrors(GLuint shader, const std::string& type) {
@@ -123,29 +301,111 @@ std::string ShaderProgram::readShaderFile(const std::string& filepath) {
 }
 
 void ShaderProgram::setUniform(const std::string& name, int value) const {
+    MAZE_GL_TRACE_COUNT(GLTRACE_UNIFORM_LOOKUPS, 1);
     GLint location = glGetUniformLocation(m_program, name.c_str());
     if (location != -1) {
+        MAZE_GL_TRACE_COUNT(GLTRACE_UNIFORM_CALLS, 1);
         glUniform1i(location, value);
     }
 }
 
 void ShaderProgram::setUniform(const std::string& name, float value) const {
+    MAZE_GL_TRACE_COUNT(GLTRACE_UNIFORM_LOOKUPS, 1);
     GLint location = glGetUniformLocation(m_program, name.c_str());
     if (location != -1) {
+        MAZE_GL_TRACE_COUNT(GLTRACE_UNIFORM_CALLS, 1);
         glUniform1f(location, value);
     }
 }
 
+void ShaderProgram::setUniform(const std::string& name, float x, float y) const {
+    MAZE_GL_TRACE_COUNT(GLTRACE_UNIFORM_LOOKUPS, 1);
+    GLint location = glGetUniformLocation(m_program, name.c_str());
+    if (location != -1) {
+        MAZE_GL_TRACE_COUNT(GLTRACE_UNIFORM_CALLS, 1);
+        glUniform2f(location, x, y);
+    }
+}
+
 void ShaderProgram::setUniform(const std::string& name, const Vector3& value) const {
+    MAZE_GL_TRACE_COUNT(GLTRACE_UNIFORM_LOOKUPS, 1);
     GLint location = glGetUniformLocation(m_program, name.c_str());
     if (location != -1) {
+        MAZE_GL_TRACE_COUNT(GLTRACE_UNIFORM_CALLS, 1);
         glUniform3f(location, value.x, value.y, value.z);
     }
 }
 
 void ShaderProgram::setUniformMatrix4fv(const std::string& name, const float* matrix) const {
+    MAZE_GL_TRACE_COUNT(GLTRACE_UNIFORM_LOOKUPS, 1);
     GLint location = glGetUniformLocation(m_program, name.c_str());
     if (location != -1) {
+        MAZE_GL_TRACE_COUNT(GLTRACE_UNIFORM_CALLS, 1);
         glUniformMatrix4fv(location, 1, GL_FALSE, matrix);
     }
+}
+
+// =====================================================
+// ShaderPermutationSet
+// =====================================================
+
+ShaderPermutationSet::ShaderPermutationSet(const std::string& vertexPath, const std::string& fragmentPath,
+                                           const std::vector<std::string>& featureDefines)
+    : m_vertexPath(vertexPath),
+      m_fragmentPath(fragmentPath),
+      m_featureDefines(featureDefines) {
+    m_vertexSource = ShaderProgram::readShaderFile(vertexPath);
+    m_fragmentSource = ShaderProgram::readShaderFile(fragmentPath);
+}
+
+void ShaderPermutationSet::submit(unsigned int featureMask) {
+    if (m_variants.find(featureMask) != m_variants.end()) {
+        return;
+    }
+
+    std::unique_ptr<ShaderProgram> program;
+    if (!m_vertexSource.empty() && !m_fragmentSource.empty()) {
+        program = std::make_unique<ShaderProgram>();
+        if (!program->submitFromSource(m_vertexSource, m_fragmentSource, getDefines(featureMask))) {
+            program.reset();
+        }
+    }
+    m_variants[featureMask] = std::move(program);
+}
+
+ShaderProgram* ShaderPermutationSet::get(unsigned int featureMask) {
+    submit(featureMask);
+
+    std::unique_ptr<ShaderProgram>& program = m_variants[featureMask];
+    if (program && program->isPending() && !program->finish()) {
+        std::cerr << "Failed to build shader variant 0x" << std::hex << featureMask << std::dec
+            << " of " << m_fragmentPath << std::endl;
+        program.reset();  // Remember the failure so it isn't rebuilt every frame
+    }
+    return program.get();
+}
+
+bool ShaderPermutationSet::isReady(unsigned int featureMask) const {
+    auto variant = m_variants.find(featureMask);
+    // A failed variant is remembered as nullptr; get() returns that at once too
+    return variant != m_variants.end() && (!variant->second || !variant->second->isPending());
+}
+
+bool ShaderPermutationSet::isCompletionReady() const {
+    for (const auto& variant : m_variants) {
+        if (variant.second && !variant.second->isCompletionReady()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<std::string> ShaderPermutationSet::getDefines(unsigned int featureMask) const {
+    std::vector<std::string> defines;
+    for (size_t i = 0; i < m_featureDefines.size(); ++i) {
+        if (featureMask & (1u << i)) {
+            defines.push_back(m_featureDefines[i]);
+        }
+    }
+    return defines;
 }
\ No newline at end of file
@@ -2,9 +2,15 @@
 #define SHADERPROGRAM_H
 
 #include <string>
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <unordered_map>
 #include <gl/glew/glew.h>
 #include "Vector3.h"
 
+class ProgramBinaryCache;
+
 /**
  * @class ShaderProgram
  * @brief Manages OpenGL shader programs (compilation, linking, and uniform setting)
@@ -29,9 +35,74 @@ public:
      * @brief Load and compile shaders from files
      * @param vertexPath Path to vertex shader file
      * @param fragmentPath Path to fragment shader file
+     * @param defines Preprocessor symbols injected after the #version line
      * @return true if successful, false otherwise
      */
-    bool loadFromFile(const std::string& vertexPath, const std::string& fragmentPath);
+    bool loadFromFile(const std::string& vertexPath, const std::string& fragmentPath,
+                      const std::vector<std::string>& defines = {});
+
+    /**
+     * @brief Compile and link from in-memory sources
+     */
+    bool loadFromSource(const std::string& vertexSource, const std::string& fragmentSource,
+                        const std::vector<std::string>& defines = {});
+
+    /**
+     * @brief Start compiling and linking without waiting for the result
+     *
+     * Only fails if the files can't be read. Call finish() before using the
+     * program; a program restored from the binary cache is ready immediately.
+     */
+    bool submitFromFile(const std::string& vertexPath, const std::string& fragmentPath,
+                        const std::vector<std::string>& defines = {});
+    bool submitFromSource(const std::string& vertexSource, const std::string& fragmentSource,
+                          const std::vector<std::string>& defines = {});
+
+    /**
+     * @brief Non-blocking check whether finish() would return without stalling
+     *
+     * Needs GL_KHR_parallel_shader_compile; without it this always returns true.
+     */
+    bool isCompletionReady() const;
+
+    /**
+     * @brief Wait for a submitted program and report compile/link errors
+     * @return true if the program is usable
+     */
+    bool finish();
+
+    bool isPending() const { return m_pending; }
+
+    /**
+     * @brief Let the driver compile on background threads (KHR/ARB_parallel_shader_compile)
+     * @return true if the extension is available
+     */
+    static bool enableParallelCompile();
+
+    /**
+     * @brief Insert "#define NAME" lines right after the #version directive
+     *
+     * A #line directive follows so compiler errors still report file line numbers.
+     */
+    static std::string injectDefines(const std::string& source, const std::vector<std::string>& defines);
+
+    /**
+     * @brief Read shader source from file
+     */
+    static std::string readShaderFile(const std::string& filepath);
+
+    /**
+     * @brief Route every subsequent load through a program binary cache
+     * @param cache Cache to use, or nullptr to always compile from source
+     */
+    static void setBinaryCache(ProgramBinaryCache* cache) { s_binaryCache = cache; }
+    static ProgramBinaryCache* getBinaryCache() { return s_binaryCache; }
+
+    /**
+     * @brief Bind the uniform block called name to a binding point in every
+     *        program built from now on (GLSL 3.30 has no layout(binding))
+     */
+    static void registerUniformBlock(const std::string& name, GLuint binding);
 
     /**
      * @brief Activate this shader program for rendering
@@ -46,21 +117,40 @@ public:
     // Uniform setters
     void setUniform(const std::string& name, int value) const;
     void setUniform(const std::string& name, float value) const;
+    void setUniform(const std::string& name, float x, float y) const;
     void setUniform(const std::string& name, const Vector3& value) const;
     void setUniformMatrix4fv(const std::string& name, const float* matrix) const;
 
 private:
     GLuint m_program;
+
+    // State between submit and finish
+    GLuint m_pendingVertex;
+    GLuint m_pendingFragment;
+    uint64_t m_pendingCacheKey;
+    float m_pendingMilliseconds;  // Main-thread time spent submitting
+    bool m_pending;
+
+    static ProgramBinaryCache* s_binaryCache;
+    static bool s_parallelCompile;
+    static std::vector<std::pair<std::string, GLuint>> s_uniformBlocks;
+
+    /**
+     * @brief Apply the registered uniform block bindings to m_program
+     */
+    void bindUniformBlocks() const;
     
     /**
-     * @brief Compile a shader from source code
+     * @brief Create a shader object and queue its compile (status not checked)
      */
     GLuint compileShader(const std::string& source, GLenum type);
     
     /**
-     * @brief Link vertex and fragment shaders into a program
+     * @brief Create the program and queue the link (status not checked)
      */
-    bool linkProgram(GLuint vertexShader, GLuint fragmentShader);
+    void linkProgram(GLuint vertexShader, GLuint fragmentShader);
+
+    void releasePendingShaders();
     
     /**
      * @brief Check for shader compilation errors
@@ -71,11 +161,57 @@ private:
      * @brief Check for program linking errors
      */
     bool checkLinkErrors();
-    
+};
+
+/**
+ * @class ShaderPermutationSet
+ * @brief Compiles one ShaderProgram per feature combination, on first use
+ *
+ * Bit i of a feature mask enables the i-th define name passed to the
+ * constructor. Sources are read once; variants are cached for the lifetime
+ * of the set. submit() queues a variant so it compiles in the background
+ * until the first get().
+ */
+class ShaderPermutationSet {
+public:
+    ShaderPermutationSet(const std::string& vertexPath, const std::string& fragmentPath,
+                         const std::vector<std::string>& featureDefines);
+
     /**
-     * @brief Read shader source from file
+     * @brief Start building a variant in the background (no-op if it exists)
      */
-    std::string readShaderFile(const std::string& filepath);
+    void submit(unsigned int featureMask);
+
+    /**
+     * @brief Get (compiling or finishing if needed) the variant for a feature mask
+     * @return nullptr if the variant failed to compile
+     */
+    ShaderProgram* get(unsigned int featureMask);
+
+    /**
+     * @brief True if get() would return this variant (or its failure) without compiling or waiting
+     */
+    bool isReady(unsigned int featureMask) const;
+
+    /**
+     * @brief True once no submitted variant would block in get()
+     */
+    bool isCompletionReady() const;
+
+    /**
+     * @brief Defines that make up a feature mask
+     */
+    std::vector<std::string> getDefines(unsigned int featureMask) const;
+
+    size_t getVariantCount() const { return m_variants.size(); }
+
+private:
+    std::string m_vertexPath;
+    std::string m_fragmentPath;
+    std::string m_vertexSource;
+    std::string m_fragmentSource;
+    std::vector<std::string> m_featureDefines;
+    std::unordered_map<unsigned int, std::unique_ptr<ShaderProgram>> m_variants;
 };
 
 #endif // SHADERPROGRAM_H
\ No newline at end of file
@@ -0,0 +1,225 @@
+#include "SimdMath.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+const char* simd::backendName() {
+#if defined(MAZE_MATH_SSE)
+    return "SSE2";
+#elif defined(MAZE_MATH_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+// =====================================================
+// Mat4
+// =====================================================
+
+Mat4 Mat4::identity() {
+    return Mat4(
+        Vec4(1.0f, 0.0f, 0.0f, 0.0f),
+        Vec4(0.0f, 1.0f, 0.0f, 0.0f),
+        Vec4(0.0f, 0.0f, 1.0f, 0.0f),
+        Vec4(0.0f, 0.0f, 0.0f, 1.0f)
+    );
+}
+
+Mat4 Mat4::translation(const Vector3& t) {
+    Mat4 result = identity();
+    result.col[3] = Vec4(t, 1.0f);
+    return result;
+}
+
+Mat4 Mat4::scale(float s) {
+    return Mat4(
+        Vec4(s, 0.0f, 0.0f, 0.0f),
+        Vec4(0.0f, s, 0.0f, 0.0f),
+        Vec4(0.0f, 0.0f, s, 0.0f),
+        Vec4(0.0f, 0.0f, 0.0f, 1.0f)
+    );
+}
+
+Mat4 Mat4::rotationY(float radians) {
+    float c = std::cos(radians);
+    float s = std::sin(radians);
+    return Mat4(
+        Vec4(c, 0.0f, -s, 0.0f),
+        Vec4(0.0f, 1.0f, 0.0f, 0.0f),
+        Vec4(s, 0.0f, c, 0.0f),
+        Vec4(0.0f, 0.0f, 0.0f, 1.0f)
+    );
+}
+
+Mat4 Mat4::perspective(float fovDegrees, float aspect, float nearPlane, float farPlane) {
+    float tanHalfFov = static_cast<float>(std::tan(fovDegrees * M_PI / 360.0));
+
+    return Mat4(
+        Vec4(1.0f / (aspect * tanHalfFov), 0.0f, 0.0f, 0.0f),
+        Vec4(0.0f, 1.0f / tanHalfFov, 0.0f, 0.0f),
+        Vec4(0.0f, 0.0f, -(farPlane + nearPlane) / (farPlane - nearPlane), -1.0f),
+        Vec4(0.0f, 0.0f, -(2.0f * farPlane * nearPlane) / (farPlane - nearPlane), 0.0f)
+    );
+}
+
+Mat4 Mat4::view(const Vector3& right, const Vector3& up, const Vector3& front, const Vector3& position) {
+    return Mat4(
+        Vec4(right.x, up.x, -front.x, 0.0f),
+        Vec4(right.y, up.y, -front.y, 0.0f),
+        Vec4(right.z, up.z, -front.z, 0.0f),
+        Vec4(-right.dot(position), -up.dot(position), front.dot(position), 1.0f)
+    );
+}
+
+Mat4 Mat4::operator*(const Mat4& o) const {
+    return Mat4(transform(o.col[0]), transform(o.col[1]), transform(o.col[2]), transform(o.col[3]));
+}
+
+// =====================================================
+// Frustum
+// =====================================================
+
+Frustum::Frustum() {
+    // Degenerate frustum that accepts everything
+    for (int g = 0; g < 2; ++g) {
+        m_nx[g] = simd::splat(0.0f);
+        m_ny[g] = simd::splat(0.0f);
+        m_nz[g] = simd::splat(0.0f);
+        m_d[g] = simd::splat(1.0f);
+    }
+}
+
+Frustum::Frustum(const Mat4& viewProjection) {
+    // Rows of the matrix (Gribb/Hartmann plane extraction)
+    simd::float4 r0 = viewProjection.col[0].m;
+    simd::float4 r1 = viewProjection.col[1].m;
+    simd::float4 r2 = viewProjection.col[2].m;
+    simd::float4 r3 = viewProjection.col[3].m;
+    simd::transpose(r0, r1, r2, r3);
+
+    // Left, right, bottom, top, near, far
+    simd::float4 planes[6] = {
+        simd::add(r3, r0), simd::sub(r3, r0),
+        simd::add(r3, r1), simd::sub(r3, r1),
+        simd::add(r3, r2), simd::sub(r3, r2)
+    };
+
+    float p[8][4];
+    for (int i = 0; i < 6; ++i) {
+        simd::store(p[i], planes[i]);
+        float len = std::sqrt(p[i][0] * p[i][0] + p[i][1] * p[i][1] + p[i][2] * p[i][2]);
+        if (len > 0.0f) {
+            for (int k = 0; k < 4; ++k) p[i][k] /= len;
+        }
+    }
+    for (int i = 6; i < 8; ++i) {
+        p[i][0] = 0.0f; p[i][1] = 0.0f; p[i][2] = 0.0f; p[i][3] = 1.0f;
+    }
+
+    for (int g = 0; g < 2; ++g) {
+        int b = g * 4;
+        m_nx[g] = simd::set(p[b][0], p[b + 1][0], p[b + 2][0], p[b + 3][0]);
+        m_ny[g] = simd::set(p[b][1], p[b + 1][1], p[b + 2][1], p[b + 3][1]);
+        m_nz[g] = simd::set(p[b][2], p[b + 1][2], p[b + 2][2], p[b + 3][2]);
+        m_d[g] = simd::set(p[b][3], p[b + 1][3], p[b + 2][3], p[b + 3][3]);
+    }
+}
+
+bool Frustum::intersectsAABB(const AABB& box) const {
+    simd::float4 minX = simd::splat(box.min.x), maxX = simd::splat(box.max.x);
+    simd::float4 minY = simd::splat(box.min.y), maxY = simd::splat(box.max.y);
+    simd::float4 minZ = simd::splat(box.min.z), maxZ = simd::splat(box.max.z);
+    simd::float4 zero = simd::splat(0.0f);
+
+    for (int g = 0; g < 2; ++g) {
+        // Distance of the "positive vertex": per axis pick whichever corner
+        // gives the larger projection, which is just max(n*min, n*max)
+        simd::float4 d = m_d[g];
+        d = simd::add(d, simd::max(simd::mul(m_nx[g], minX), simd::mul(m_nx[g], maxX)));
+        d = simd::add(d, simd::max(simd::mul(m_ny[g], minY), simd::mul(m_ny[g], maxY)));
+        d = simd::add(d, simd::max(simd::mul(m_nz[g], minZ), simd::mul(m_nz[g], maxZ)));
+
+        if (simd::moveMask(simd::lessThan(d, zero)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::size_t Frustum::cullAABBs(const AABB* boxes, std::size_t count, unsigned char* visible) const {
+    std::size_t visibleCount = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        bool inside = intersectsAABB(boxes[i]);
+        visible[i] = inside ? 1 : 0;
+        visibleCount += inside ? 1 : 0;
+    }
+    return visibleCount;
+}
+
+// =====================================================
+// Batched operations
+// =====================================================
+
+namespace {
+    // Vector3 arrays are tightly packed floats, so 4 elements are 12 floats
+    static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 must be tightly packed");
+
+    inline void loadSoA(const Vector3* v, simd::float4& X, simd::float4& Y, simd::float4& Z) {
+        simd::loadXYZ4(&v[0].x, X, Y, Z);
+    }
+
+    inline void storeSoA(Vector3* v, simd::float4 X, simd::float4 Y, simd::float4 Z) {
+        simd::storeXYZ4(&v[0].x, X, Y, Z);
+    }
+}
+
+void transformPoints(const Mat4& matrix, const Vector3* in, Vector3* out, std::size_t count) {
+    float m[16];
+    for (int c = 0; c < 4; ++c) {
+        simd::store(&m[c * 4], matrix.col[c].m);
+    }
+
+    simd::float4 m00 = simd::splat(m[0]), m10 = simd::splat(m[1]), m20 = simd::splat(m[2]);
+    simd::float4 m01 = simd::splat(m[4]), m11 = simd::splat(m[5]), m21 = simd::splat(m[6]);
+    simd::float4 m02 = simd::splat(m[8]), m12 = simd::splat(m[9]), m22 = simd::splat(m[10]);
+    simd::float4 m03 = simd::splat(m[12]), m13 = simd::splat(m[13]), m23 = simd::splat(m[14]);
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        simd::float4 X, Y, Z;
+        loadSoA(in + i, X, Y, Z);
+
+        simd::float4 ox = simd::madd(m00, X, simd::madd(m01, Y, simd::madd(m02, Z, m03)));
+        simd::float4 oy = simd::madd(m10, X, simd::madd(m11, Y, simd::madd(m12, Z, m13)));
+        simd::float4 oz = simd::madd(m20, X, simd::madd(m21, Y, simd::madd(m22, Z, m23)));
+
+        storeSoA(out + i, ox, oy, oz);
+    }
+
+    for (; i < count; ++i) {
+        out[i] = matrix.transformPoint(in[i]);
+    }
+}
+
+void normalizeBatch(Vector3* vectors, std::size_t count) {
+    simd::float4 zero = simd::splat(0.0f);
+    simd::float4 one = simd::splat(1.0f);
+
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        simd::float4 X, Y, Z;
+        loadSoA(vectors + i, X, Y, Z);
+
+        simd::float4 lenSq = simd::madd(X, X, simd::madd(Y, Y, simd::mul(Z, Z)));
+        simd::float4 nonZero = simd::greaterThan(lenSq, zero);
+        simd::float4 invLen = simd::select(nonZero, simd::div(one, simd::sqrt(lenSq)), zero);
+
+        storeSoA(vectors + i, simd::mul(X, invLen), simd::mul(Y, invLen), simd::mul(Z, invLen));
+    }
+
+    for (; i < count; ++i) {
+        vectors[i] = vectors[i].normalize();
+    }
+}
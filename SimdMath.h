@@ -0,0 +1,372 @@
+#ifndef SIMDMATH_H
+#define SIMDMATH_H
+
+#include "Vector3.h"
+#include <cstddef>
+#include <cmath>
+
+// Backend selection: SSE2 on x86/x64, NEON on ARM, plain floats otherwise.
+// Define MAZE_MATH_SCALAR to force the scalar fallback (useful for benchmarks).
+#if !defined(MAZE_MATH_SCALAR)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MAZE_MATH_SSE 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define MAZE_MATH_NEON 1
+#include <arm_neon.h>
+#endif
+#endif
+
+/**
+ * @brief Thin per-backend wrappers around a 4-wide float register
+ *
+ * Everything above this block is written once against these helpers.
+ */
+namespace simd {
+#if defined(MAZE_MATH_SSE)
+    typedef __m128 float4;
+
+    inline float4 set(float x, float y, float z, float w) { return _mm_set_ps(w, z, y, x); }
+    inline float4 splat(float s) { return _mm_set1_ps(s); }
+    inline float4 load(const float* p) { return _mm_loadu_ps(p); }
+    inline void store(float* p, float4 a) { _mm_storeu_ps(p, a); }
+    inline float4 add(float4 a, float4 b) { return _mm_add_ps(a, b); }
+    inline float4 sub(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+    inline float4 mul(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+    inline float4 div(float4 a, float4 b) { return _mm_div_ps(a, b); }
+    inline float4 min(float4 a, float4 b) { return _mm_min_ps(a, b); }
+    inline float4 max(float4 a, float4 b) { return _mm_max_ps(a, b); }
+    inline float4 sqrt(float4 a) { return _mm_sqrt_ps(a); }
+    inline float4 madd(float4 a, float4 b, float4 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    inline float4 lessThan(float4 a, float4 b) { return _mm_cmplt_ps(a, b); }
+    inline float4 greaterThan(float4 a, float4 b) { return _mm_cmpgt_ps(a, b); }
+    inline float4 select(float4 mask, float4 a, float4 b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+    inline int moveMask(float4 mask) { return _mm_movemask_ps(mask); }
+    inline float lane0(float4 a) { return _mm_cvtss_f32(a); }
+    template <int I> inline float4 broadcast(float4 a) {
+        return _mm_shuffle_ps(a, a, _MM_SHUFFLE(I, I, I, I));
+    }
+    inline void transpose(float4& r0, float4& r1, float4& r2, float4& r3) {
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    }
+    // Deinterleave 4 packed xyz triples (12 floats) into x, y and z registers
+    inline void loadXYZ4(const float* p, float4& x, float4& y, float4& z) {
+        float4 a = _mm_loadu_ps(p);     // x0 y0 z0 x1
+        float4 b = _mm_loadu_ps(p + 4); // y1 z1 x2 y2
+        float4 c = _mm_loadu_ps(p + 8); // z2 x3 y3 z3
+        x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+        y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+            _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+            _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+    }
+    inline void storeXYZ4(float* p, float4 x, float4 y, float4 z) {
+        _mm_storeu_ps(p, _mm_shuffle_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 1, 0)),
+            _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(p + 4, _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)),
+            _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(p + 8, _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)),
+            _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0)));
+    }
+#elif defined(MAZE_MATH_NEON)
+    typedef float32x4_t float4;
+
+    inline float4 set(float x, float y, float z, float w) {
+        const float v[4] = { x, y, z, w };
+        return vld1q_f32(v);
+    }
+    inline float4 splat(float s) { return vdupq_n_f32(s); }
+    inline float4 load(const float* p) { return vld1q_f32(p); }
+    inline void store(float* p, float4 a) { vst1q_f32(p, a); }
+    inline float4 add(float4 a, float4 b) { return vaddq_f32(a, b); }
+    inline float4 sub(float4 a, float4 b) { return vsubq_f32(a, b); }
+    inline float4 mul(float4 a, float4 b) { return vmulq_f32(a, b); }
+    inline float4 div(float4 a, float4 b) {
+        // Two Newton-Raphson steps on the reciprocal estimate (ARMv7 has no vdivq)
+        float32x4_t r = vrecpeq_f32(b);
+        r = vmulq_f32(vrecpsq_f32(b, r), r);
+        r = vmulq_f32(vrecpsq_f32(b, r), r);
+        return vmulq_f32(a, r);
+    }
+    inline float4 min(float4 a, float4 b) { return vminq_f32(a, b); }
+    inline float4 max(float4 a, float4 b) { return vmaxq_f32(a, b); }
+    inline float4 sqrt(float4 a) {
+        float32x4_t r = vrsqrteq_f32(a);
+        r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+        r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+        float32x4_t s = vmulq_f32(a, r);
+        // sqrt(0) would otherwise come out as 0 * inf = NaN
+        uint32x4_t zero = vceqq_f32(a, vdupq_n_f32(0.0f));
+        return vbslq_f32(zero, vdupq_n_f32(0.0f), s);
+    }
+    inline float4 madd(float4 a, float4 b, float4 c) { return vmlaq_f32(c, a, b); }
+    inline float4 lessThan(float4 a, float4 b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+    inline float4 greaterThan(float4 a, float4 b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+    inline float4 select(float4 mask, float4 a, float4 b) {
+        return vbslq_f32(vreinterpretq_u32_f32(mask), a, b);
+    }
+    inline int moveMask(float4 mask) {
+        uint32x4_t m = vreinterpretq_u32_f32(mask);
+        return static_cast<int>((vgetq_lane_u32(m, 0) >> 31) | ((vgetq_lane_u32(m, 1) >> 31) << 1) |
+            ((vgetq_lane_u32(m, 2) >> 31) << 2) | ((vgetq_lane_u32(m, 3) >> 31) << 3));
+    }
+    inline float lane0(float4 a) { return vgetq_lane_f32(a, 0); }
+    template <int I> inline float4 broadcast(float4 a) { return vdupq_n_f32(vgetq_lane_f32(a, I)); }
+    inline void transpose(float4& r0, float4& r1, float4& r2, float4& r3) {
+        float32x4x2_t t01 = vtrnq_f32(r0, r1);
+        float32x4x2_t t23 = vtrnq_f32(r2, r3);
+        r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+        r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+        r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+        r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+    }
+    inline void loadXYZ4(const float* p, float4& x, float4& y, float4& z) {
+        float32x4x3_t v = vld3q_f32(p);
+        x = v.val[0]; y = v.val[1]; z = v.val[2];
+    }
+    inline void storeXYZ4(float* p, float4 x, float4 y, float4 z) {
+        float32x4x3_t v;
+        v.val[0] = x; v.val[1] = y; v.val[2] = z;
+        vst3q_f32(p, v);
+    }
+#else
+    struct float4 { float f[4]; };
+
+    inline float4 set(float x, float y, float z, float w) { return { { x, y, z, w } }; }
+    inline float4 splat(float s) { return { { s, s, s, s } }; }
+    inline float4 load(const float* p) { return { { p[0], p[1], p[2], p[3] } }; }
+    inline void store(float* p, float4 a) { for (int i = 0; i < 4; ++i) p[i] = a.f[i]; }
+    inline float4 add(float4 a, float4 b) { for (int i = 0; i < 4; ++i) a.f[i] += b.f[i]; return a; }
+    inline float4 sub(float4 a, float4 b) { for (int i = 0; i < 4; ++i) a.f[i] -= b.f[i]; return a; }
+    inline float4 mul(float4 a, float4 b) { for (int i = 0; i < 4; ++i) a.f[i] *= b.f[i]; return a; }
+    inline float4 div(float4 a, float4 b) { for (int i = 0; i < 4; ++i) a.f[i] /= b.f[i]; return a; }
+    inline float4 min(float4 a, float4 b) { for (int i = 0; i < 4; ++i) a.f[i] = a.f[i] < b.f[i] ? a.f[i] : b.f[i]; return a; }
+    inline float4 max(float4 a, float4 b) { for (int i = 0; i < 4; ++i) a.f[i] = a.f[i] > b.f[i] ? a.f[i] : b.f[i]; return a; }
+    inline float4 sqrt(float4 a) { for (int i = 0; i < 4; ++i) a.f[i] = std::sqrt(a.f[i]); return a; }
+    inline float4 madd(float4 a, float4 b, float4 c) { return add(mul(a, b), c); }
+    inline float4 lessThan(float4 a, float4 b) {
+        float4 r;
+        for (int i = 0; i < 4; ++i) r.f[i] = a.f[i] < b.f[i] ? -1.0f : 0.0f;
+        return r;
+    }
+    inline float4 greaterThan(float4 a, float4 b) { return lessThan(b, a); }
+    inline float4 select(float4 mask, float4 a, float4 b) {
+        for (int i = 0; i < 4; ++i) a.f[i] = mask.f[i] != 0.0f ? a.f[i] : b.f[i];
+        return a;
+    }
+    inline int moveMask(float4 mask) {
+        int bits = 0;
+        for (int i = 0; i < 4; ++i) if (mask.f[i] != 0.0f) bits |= 1 << i;
+        return bits;
+    }
+    inline float lane0(float4 a) { return a.f[0]; }
+    template <int I> inline float4 broadcast(float4 a) { return splat(a.f[I]); }
+    inline void transpose(float4& r0, float4& r1, float4& r2, float4& r3) {
+        float4 c0 = { { r0.f[0], r1.f[0], r2.f[0], r3.f[0] } };
+        float4 c1 = { { r0.f[1], r1.f[1], r2.f[1], r3.f[1] } };
+        float4 c2 = { { r0.f[2], r1.f[2], r2.f[2], r3.f[2] } };
+        float4 c3 = { { r0.f[3], r1.f[3], r2.f[3], r3.f[3] } };
+        r0 = c0; r1 = c1; r2 = c2; r3 = c3;
+    }
+    inline void loadXYZ4(const float* p, float4& x, float4& y, float4& z) {
+        for (int i = 0; i < 4; ++i) {
+            x.f[i] = p[i * 3]; y.f[i] = p[i * 3 + 1]; z.f[i] = p[i * 3 + 2];
+        }
+    }
+    inline void storeXYZ4(float* p, float4 x, float4 y, float4 z) {
+        for (int i = 0; i < 4; ++i) {
+            p[i * 3] = x.f[i]; p[i * 3 + 1] = y.f[i]; p[i * 3 + 2] = z.f[i];
+        }
+    }
+#endif
+
+    /**
+     * @brief Name of the compiled backend ("SSE2", "NEON" or "scalar")
+     */
+    const char* backendName();
+}
+
+/**
+ * @struct Vec4
+ * @brief 4-wide vector held in a SIMD register
+ *
+ * Used for arithmetic; Vector3 remains the storage type for vertex data.
+ * Three-component helpers (dot3, cross3, ...) ignore the w lane.
+ */
+struct alignas(16) Vec4 {
+    simd::float4 m;
+
+    Vec4() : m(simd::splat(0.0f)) {}
+    explicit Vec4(simd::float4 v) : m(v) {}
+    Vec4(float x, float y, float z, float w) : m(simd::set(x, y, z, w)) {}
+    explicit Vec4(const Vector3& v, float w = 0.0f) : m(simd::set(v.x, v.y, v.z, w)) {}
+
+    static Vec4 splat(float s) { return Vec4(simd::splat(s)); }
+
+    float x() const { float f[4]; simd::store(f, m); return f[0]; }
+    float y() const { float f[4]; simd::store(f, m); return f[1]; }
+    float z() const { float f[4]; simd::store(f, m); return f[2]; }
+    float w() const { float f[4]; simd::store(f, m); return f[3]; }
+
+    Vector3 toVector3() const {
+        float f[4];
+        simd::store(f, m);
+        return Vector3(f[0], f[1], f[2]);
+    }
+
+    Vec4 operator+(const Vec4& o) const { return Vec4(simd::add(m, o.m)); }
+    Vec4 operator-(const Vec4& o) const { return Vec4(simd::sub(m, o.m)); }
+    Vec4 operator*(const Vec4& o) const { return Vec4(simd::mul(m, o.m)); }
+    Vec4 operator*(float s) const { return Vec4(simd::mul(m, simd::splat(s))); }
+    Vec4& operator+=(const Vec4& o) { m = simd::add(m, o.m); return *this; }
+    Vec4& operator-=(const Vec4& o) { m = simd::sub(m, o.m); return *this; }
+
+    /**
+     * @brief Copy with the y lane zeroed (projects onto the ground plane)
+     */
+    Vec4 flattened() const { return Vec4(simd::mul(m, simd::set(1.0f, 0.0f, 1.0f, 1.0f))); }
+
+    float dot3(const Vec4& o) const {
+        float f[4];
+        simd::store(f, simd::mul(m, o.m));
+        return f[0] + f[1] + f[2];
+    }
+
+    float dot4(const Vec4& o) const {
+        float f[4];
+        simd::store(f, simd::mul(m, o.m));
+        return (f[0] + f[1]) + (f[2] + f[3]);
+    }
+
+    Vec4 cross3(const Vec4& o) const {
+        Vector3 a = toVector3();
+        Vector3 b = o.toVector3();
+        return Vec4(a.cross(b));
+    }
+
+    float length3() const { return std::sqrt(dot3(*this)); }
+
+    float lengthSquared3() const { return dot3(*this); }
+
+    /**
+     * @brief Normalize the xyz part; zero-length input returns zero
+     */
+    Vec4 normalized3() const {
+        float len = length3();
+        if (len > 0.0f) {
+            return Vec4(simd::mul(m, simd::splat(1.0f / len)));
+        }
+        return Vec4();
+    }
+
+    static Vec4 min(const Vec4& a, const Vec4& b) { return Vec4(simd::min(a.m, b.m)); }
+    static Vec4 max(const Vec4& a, const Vec4& b) { return Vec4(simd::max(a.m, b.m)); }
+};
+
+/**
+ * @struct Mat4
+ * @brief Column-major 4x4 matrix (OpenGL layout)
+ */
+struct alignas(16) Mat4 {
+    Vec4 col[4];
+
+    Mat4() { *this = identity(); }
+    Mat4(const Vec4& c0, const Vec4& c1, const Vec4& c2, const Vec4& c3) {
+        col[0] = c0; col[1] = c1; col[2] = c2; col[3] = c3;
+    }
+
+    /**
+     * @brief Pointer to 16 floats, suitable for glUniformMatrix4fv
+     */
+    const float* data() const { return reinterpret_cast<const float*>(col); }
+
+    static Mat4 identity();
+    static Mat4 translation(const Vector3& t);
+    static Mat4 scale(float s);
+    static Mat4 rotationY(float radians);
+
+    /**
+     * @brief Perspective projection
+     * @param fovDegrees Vertical field of view in degrees
+     */
+    static Mat4 perspective(float fovDegrees, float aspect, float nearPlane, float farPlane);
+
+    /**
+     * @brief View matrix from an orthonormal camera basis
+     */
+    static Mat4 view(const Vector3& right, const Vector3& up, const Vector3& front, const Vector3& position);
+
+    Mat4 operator*(const Mat4& o) const;
+
+    Vec4 transform(const Vec4& v) const {
+        simd::float4 r = simd::mul(col[0].m, simd::broadcast<0>(v.m));
+        r = simd::madd(col[1].m, simd::broadcast<1>(v.m), r);
+        r = simd::madd(col[2].m, simd::broadcast<2>(v.m), r);
+        r = simd::madd(col[3].m, simd::broadcast<3>(v.m), r);
+        return Vec4(r);
+    }
+
+    Vector3 transformPoint(const Vector3& p) const { return transform(Vec4(p, 1.0f)).toVector3(); }
+};
+
+/**
+ * @struct AABB
+ * @brief Axis-aligned bounding box in world space
+ */
+struct AABB {
+    Vector3 min;
+    Vector3 max;
+
+    AABB() {}
+    AABB(const Vector3& minCorner, const Vector3& maxCorner) : min(minCorner), max(maxCorner) {}
+
+    static AABB fromCenter(const Vector3& center, const Vector3& halfExtents) {
+        return AABB(center - halfExtents, center + halfExtents);
+    }
+};
+
+/**
+ * @class Frustum
+ * @brief View frustum planes extracted from a view-projection matrix
+ *
+ * Planes are kept in structure-of-arrays form so a single box is tested
+ * against four planes per SIMD operation.
+ */
+class Frustum {
+public:
+    Frustum();
+    explicit Frustum(const Mat4& viewProjection);
+
+    /**
+     * @brief Conservative box test (may report boxes near corners as visible)
+     */
+    bool intersectsAABB(const AABB& box) const;
+
+    /**
+     * @brief Test many boxes at once
+     * @param visible Output flags, one per box (1 = visible, 0 = culled)
+     * @return Number of visible boxes
+     */
+    std::size_t cullAABBs(const AABB* boxes, std::size_t count, unsigned char* visible) const;
+
+private:
+    // Planes 0-3 in group 0, planes 4-5 plus two always-passing planes in group 1
+    simd::float4 m_nx[2];
+    simd::float4 m_ny[2];
+    simd::float4 m_nz[2];
+    simd::float4 m_d[2];
+};
+
+/**
+ * @brief Transform positions by a matrix (w = 1), 4 points per iteration
+ */
+void transformPoints(const Mat4& matrix, const Vector3* in, Vector3* out, std::size_t count);
+
+/**
+ * @brief Normalize vectors in place, 4 vectors per iteration; zero vectors stay zero
+ */
+void normalizeBatch(Vector3* vectors, std::size_t count);
+
+#endif // SIMDMATH_H
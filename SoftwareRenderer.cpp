@@ -0,0 +1,499 @@
+#include "SoftwareRenderer.h"
+#include "SimdMath.h"
+#include "TextureArray.h"
+#include <SFML/Graphics/Image.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+    // Layers are resampled to one power-of-two size so texel lookups are masks
+    const int kTextureSize = 128;
+
+    // Columns per ThreadPool task; wide enough that rows are written a cache line at a time
+    const int kColumnGrain = 16;
+
+    // Values Renderer::beginFrameWithFlashlight feeds fragment.glsl
+    const float kVerticalFov = 60.0f;
+    const float kFarPlane = 100.0f;
+    const float kAmbientRG = 0.15f * 0.3f;   // material.ambient * lightColor
+    const float kAmbientB = 0.15f * 0.4f;
+    const float kDiffuseRG = 0.3f * 0.3f;    // material.diffuse * lightColor
+    const float kDiffuseB = 0.3f * 0.4f;
+    const float kFogStart = 5.0f;
+    const float kFogEnd = 15.0f;
+    const float kFogColor[3] = { 0.02f, 0.03f, 0.05f };
+    const float kPortalRadius = 8.0f;
+    const float kPortalStrength = 0.8f;
+    const float kFlashlightSpillRadius = 4.0f;   // Light grid only
+    const float kFlashlightSpillColor[3] = { 0.08f, 0.08f, 0.07f };
+
+    inline float fract(float x) {
+        return x - std::floor(x);
+    }
+
+    inline unsigned char toByte(float value) {
+        value = value * 255.0f + 0.5f;
+        return static_cast<unsigned char>(value < 0.0f ? 0.0f : (value > 255.0f ? 255.0f : value));
+    }
+}
+
+void SoftwareRenderer::ColumnScratch::resize(int rows) {
+    // Spans are lit four rows at a time and may run up to three rows past their end
+    size_t padded = static_cast<size_t>((rows + 3) & ~3) + 4;
+    x.assign(padded, 0.0f);
+    y.assign(padded, 0.0f);
+    z.assign(padded, 0.0f);
+    texel.assign(padded, 0u);
+    lightRG.assign(padded, 0.0f);
+    lightB.assign(padded, 0.0f);
+    portal.assign(padded, 0.0f);
+    fog.assign(padded, 0.0f);
+    gridR.assign(padded, 0.0f);
+    gridG.assign(padded, 0.0f);
+    gridB.assign(padded, 0.0f);
+}
+
+SoftwareRenderer::SoftwareRenderer(ThreadPool* pool)
+    : m_pool(pool),
+      m_width(0),
+      m_height(0),
+      m_fogEnabled(true),
+      m_portalLightEnabled(true),
+      m_coneInnerCos(0.0f),
+      m_coneOuterCos(0.0f),
+      m_lightGrid(nullptr) {
+    setFlashlightCone(90.0f, 90.0f);
+}
+
+void SoftwareRenderer::setFlashlightCone(float innerDegrees, float outerDegrees) {
+    m_coneInnerCos = std::cos(innerDegrees * static_cast<float>(M_PI) / 180.0f);
+    m_coneOuterCos = std::cos(outerDegrees * static_cast<float>(M_PI) / 180.0f);
+}
+
+void SoftwareRenderer::setSize(int width, int height) {
+    m_width = std::max(width, 1);
+    m_height = std::max(height, 1);
+    m_pixels.assign(static_cast<size_t>(m_width) * m_height * 4, 255);
+}
+
+SoftwareRenderer::MipChain SoftwareRenderer::buildMipChain(const unsigned char* rgba, int size) {
+    MipChain chain;
+
+    MipLevel base;
+    base.size = size;
+    base.mask = size - 1;
+    base.texels.resize(static_cast<size_t>(size) * size);
+    for (size_t i = 0; i < base.texels.size(); ++i) {
+        const unsigned char* p = rgba + i * 4;
+        base.texels[i] = p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+    chain.push_back(std::move(base));
+
+    // 2x2 box filter down to 1x1
+    while (chain.back().size > 1) {
+        const MipLevel& src = chain.back();
+        MipLevel dst;
+        dst.size = src.size / 2;
+        dst.mask = dst.size - 1;
+        dst.texels.resize(static_cast<size_t>(dst.size) * dst.size);
+
+        for (int y = 0; y < dst.size; ++y) {
+            for (int x = 0; x < dst.size; ++x) {
+                uint32_t quad[4] = {
+                    src.texels[(2 * y) * src.size + 2 * x],
+                    src.texels[(2 * y) * src.size + 2 * x + 1],
+                    src.texels[(2 * y + 1) * src.size + 2 * x],
+                    src.texels[(2 * y + 1) * src.size + 2 * x + 1]
+                };
+                uint32_t packed = 0;
+                for (int channel = 0; channel < 4; ++channel) {
+                    uint32_t sum = 2;  // Rounds to nearest
+                    for (uint32_t texel : quad) {
+                        sum += (texel >> (channel * 8)) & 0xFFu;
+                    }
+                    packed |= (sum / 4) << (channel * 8);
+                }
+                dst.texels[y * dst.size + x] = packed;
+            }
+        }
+        chain.push_back(std::move(dst));
+    }
+    return chain;
+}
+
+SoftwareRenderer::MipChain SoftwareRenderer::makePlaceholder() {
+    std::vector<unsigned char> grey(4, 128);
+    grey[3] = 255;
+    return buildMipChain(grey.data(), 1);
+}
+
+bool SoftwareRenderer::loadMaterials(const std::vector<std::string>& filepaths, const MazeMaterials& materials) {
+    m_materials = materials;
+    m_layers.clear();
+
+    bool allLoaded = true;
+    for (const std::string& path : filepaths) {
+        sf::Image image;
+        if (!image.loadFromFile(path) || image.getSize().x == 0 || image.getSize().y == 0) {
+            std::cerr << "WARNING: Software renderer could not load " << path << ", using grey" << std::endl;
+            m_layers.push_back(makePlaceholder());
+            allLoaded = false;
+            continue;
+        }
+
+        // Same orientation as the GL upload: row 0 is v = 0
+        image.flipVertically();
+        std::vector<unsigned char> resized = TextureArray::resample(image.getPixelsPtr(),
+            image.getSize().x, image.getSize().y, kTextureSize, kTextureSize);
+        m_layers.push_back(buildMipChain(resized.data(), kTextureSize));
+    }
+
+    std::cout << "Software renderer: " << m_layers.size() << " material layers at "
+        << kTextureSize << "x" << kTextureSize << std::endl;
+    return allLoaded;
+}
+
+const SoftwareRenderer::MipChain& SoftwareRenderer::layer(int index) const {
+    static const MipChain placeholder = makePlaceholder();
+    if (index < 0 || index >= static_cast<int>(m_layers.size())) {
+        return placeholder;
+    }
+    return m_layers[index];
+}
+
+uint32_t SoftwareRenderer::sample(const MipChain& chain, float u, float v, float footprint) {
+    // footprint is uv units per pixel; pick the level where one texel covers about one pixel
+    float texelsPerPixel = footprint * chain[0].size;
+    size_t level = 0;
+    while (texelsPerPixel >= 2.0f && level + 1 < chain.size()) {
+        texelsPerPixel *= 0.5f;
+        ++level;
+    }
+
+    const MipLevel& mip = chain[level];
+    int x = static_cast<int>(std::floor(u * mip.size)) & mip.mask;
+    int y = static_cast<int>(std::floor(v * mip.size)) & mip.mask;
+    return mip.texels[y * mip.size + x];
+}
+
+void SoftwareRenderer::render(const Maze& maze, const Camera& camera, const Vector3& portalPos,
+                              float time, bool flashlightOn, float flashlightIntensity) {
+    if (m_pixels.empty()) {
+        setSize(640, 360);
+    }
+
+    const float degToRad = static_cast<float>(M_PI) / 180.0f;
+    Vector3 eye = camera.getPosition();
+    Vector3 front = camera.getFront();
+    float yaw = camera.getYaw() * degToRad;
+    float pitch = camera.getPitch() * degToRad;
+
+    FrameState state;
+    state.eyeX = eye.x;
+    state.eyeY = eye.y;
+    state.eyeZ = eye.z;
+    state.forwardX = std::cos(yaw);
+    state.forwardZ = std::sin(yaw);
+    state.rightX = -state.forwardZ;  // front x worldUp, as in Camera
+    state.rightZ = state.forwardX;
+    state.frontX = front.x;
+    state.frontY = front.y;
+    state.frontZ = front.z;
+    state.focal = (m_height * 0.5f) / std::tan(kVerticalFov * 0.5f * degToRad);
+    state.horizon = m_height * 0.5f + std::tan(pitch) * state.focal;
+    // Beyond the fog end everything is fog colour, so the DDA can stop there
+    state.maxDistance = m_fogEnabled ? kFogEnd : kFarPlane;
+    state.flashlightOn = flashlightOn && flashlightIntensity > 0.0f;
+    state.flashlightIntensity = flashlightIntensity;
+    state.portalLight = m_portalLightEnabled;
+    state.portalX = portalPos.x;
+    state.portalY = portalPos.y;
+    state.portalZ = portalPos.z;
+    state.portalPulse = 0.8f + 0.2f * std::sin(time * 1.5f);
+    state.lightGrid = m_lightGrid;
+
+    // Same lights the GL renderer floods; the grid redoes only those that changed
+    if (m_lightGrid) {
+        m_gridLights.clear();
+        if (m_portalLightEnabled) {
+            PointLight portal;
+            portal.position = portalPos;
+            portal.radius = kPortalRadius;
+            portal.color = Vector3(0.0f, 0.8f * state.portalPulse, state.portalPulse) * kPortalStrength;
+            m_gridLights.push_back(portal);
+        }
+        if (state.flashlightOn) {
+            PointLight spill;
+            spill.position = eye;
+            spill.radius = kFlashlightSpillRadius;
+            spill.color = Vector3(kFlashlightSpillColor[0], kFlashlightSpillColor[1], kFlashlightSpillColor[2]) * flashlightIntensity;
+            m_gridLights.push_back(spill);
+        }
+        m_lightGrid->update(m_gridLights);
+        m_lightGrid->clearDirty();  // Nothing to upload
+        state.portalLight = false;
+    }
+
+    if (m_pool) {
+        m_pool->parallelFor(m_width, kColumnGrain, [&](int begin, int end) {
+            renderColumns(maze, state, begin, end);
+        });
+    }
+    else {
+        renderColumns(maze, state, 0, m_width);
+    }
+}
+
+void SoftwareRenderer::renderColumns(const Maze& maze, const FrameState& state, int firstColumn, int endColumn) {
+    const float cellSize = Maze::kCellSize;
+    const float wallHeight = Maze::kWallHeight;
+    const float halfWidth = m_width * 0.5f;
+
+    ColumnScratch scratch;
+    scratch.resize(m_height);
+
+    const MipChain& floorChain = layer(m_materials.floorLayer);
+    const MipChain& ceilingChain = layer(m_materials.ceilingLayer);
+
+    for (int column = firstColumn; column < endColumn; ++column) {
+        // Ray with unit length along the forward axis, so t is the perpendicular distance
+        float offset = (column + 0.5f - halfWidth) / state.focal;
+        float dirX = state.forwardX + state.rightX * offset;
+        float dirZ = state.forwardZ + state.rightZ * offset;
+
+        // === DDA through the grid ===
+        int cellX = static_cast<int>(std::floor(state.eyeX / cellSize));
+        int cellZ = static_cast<int>(std::floor(state.eyeZ / cellSize));
+        int stepX = dirX < 0.0f ? -1 : 1;
+        int stepZ = dirZ < 0.0f ? -1 : 1;
+        float deltaX = dirX != 0.0f ? std::fabs(cellSize / dirX) : 1e30f;
+        float deltaZ = dirZ != 0.0f ? std::fabs(cellSize / dirZ) : 1e30f;
+        float sideX = dirX != 0.0f
+            ? ((dirX < 0.0f ? state.eyeX - cellX * cellSize : (cellX + 1) * cellSize - state.eyeX) / std::fabs(dirX))
+            : 1e30f;
+        float sideZ = dirZ != 0.0f
+            ? ((dirZ < 0.0f ? state.eyeZ - cellZ * cellSize : (cellZ + 1) * cellSize - state.eyeZ) / std::fabs(dirZ))
+            : 1e30f;
+
+        bool hit = false;
+        bool crossedX = false;
+        float t = 0.0f;
+        while (true) {
+            if (sideX < sideZ) {
+                t = sideX;
+                sideX += deltaX;
+                cellX += stepX;
+                crossedX = true;
+            }
+            else {
+                t = sideZ;
+                sideZ += deltaZ;
+                cellZ += stepZ;
+                crossedX = false;
+            }
+            if (t > state.maxDistance) break;
+            if (maze.getCellType(cellX, cellZ) != 0) {  // Outside the grid counts as wall
+                hit = true;
+                break;
+            }
+        }
+
+        // === Screen rows of the wall slice ===
+        float wallTop = state.horizon;
+        float wallBottom = state.horizon;
+        if (hit) {
+            wallTop = state.horizon - (wallHeight - state.eyeY) * state.focal / t;
+            wallBottom = state.horizon + state.eyeY * state.focal / t;
+        }
+        int wallStart = std::max(0, std::min(m_height, static_cast<int>(std::ceil(wallTop - 0.5f))));
+        int wallEnd = std::max(wallStart, std::min(m_height, static_cast<int>(std::ceil(wallBottom - 0.5f))));
+
+        // === Gather positions and texels ===
+        for (int row = 0; row < wallStart; ++row) {
+            float above = state.horizon - (row + 0.5f);
+            float z = above > 0.0f ? (wallHeight - state.eyeY) * state.focal / above : state.maxDistance;
+            z = std::min(z, state.maxDistance);
+
+            float px = state.eyeX + dirX * z;
+            float pz = state.eyeZ + dirZ * z;
+            scratch.x[row] = px;
+            scratch.y[row] = wallHeight;
+            scratch.z[row] = pz;
+            scratch.texel[row] = sample(ceilingChain, fract(px / cellSize), fract(pz / cellSize), z / (state.focal * cellSize));
+        }
+
+        if (wallEnd > wallStart) {
+            float hitX = state.eyeX + dirX * t;
+            float hitZ = state.eyeZ + dirZ * t;
+            float fracX = fract(hitX / cellSize);
+            float fracZ = fract(hitZ / cellSize);
+
+            // U runs the same way as Maze::addWallQuad lays out each face
+            float u;
+            if (crossedX) {
+                u = stepX > 0 ? fracZ : 1.0f - fracZ;  // West (-X) or east (+X) face
+            }
+            else {
+                u = stepZ > 0 ? 1.0f - fracX : fracX;  // North (-Z) or south (+Z) face
+            }
+
+            const MipChain& wallChain = layer(m_materials.wallLayer +
+                maze.getWallVariant(cellX, cellZ, m_materials.wallVariantCount));
+            float footprint = t / (state.focal * cellSize);
+            float heightPerRow = t / state.focal;
+
+            for (int row = wallStart; row < wallEnd; ++row) {
+                float height = state.eyeY + (state.horizon - (row + 0.5f)) * heightPerRow;
+                scratch.x[row] = hitX;
+                scratch.y[row] = height;
+                scratch.z[row] = hitZ;
+                scratch.texel[row] = sample(wallChain, u, height / wallHeight, footprint);
+            }
+        }
+
+        for (int row = wallEnd; row < m_height; ++row) {
+            float below = (row + 0.5f) - state.horizon;
+            float z = below > 0.0f ? state.eyeY * state.focal / below : state.maxDistance;
+            z = std::min(z, state.maxDistance);
+
+            float px = state.eyeX + dirX * z;
+            float pz = state.eyeZ + dirZ * z;
+            scratch.x[row] = px;
+            scratch.y[row] = 0.0f;
+            scratch.z[row] = pz;
+            scratch.texel[row] = sample(floorChain, fract(px / cellSize), fract(pz / cellSize), z / (state.focal * cellSize));
+        }
+
+        // === Light, in order so each span's overrun is redone by the next ===
+        float normalX = crossedX ? -static_cast<float>(stepX) : 0.0f;
+        float normalZ = crossedX ? 0.0f : -static_cast<float>(stepZ);
+        lightSpan(state, scratch, 0, wallStart, 0.0f, -1.0f, 0.0f);
+        if (wallEnd > wallStart) {
+            lightSpan(state, scratch, wallStart, wallEnd, normalX, 0.0f, normalZ);
+        }
+        lightSpan(state, scratch, wallEnd, m_height, 0.0f, 1.0f, 0.0f);
+
+        // Floor and ceiling read the grid where they are; a wall slice reads
+        // the texel in front of it, once, as the grid has no height
+        if (state.lightGrid) {
+            auto gridSpan = [&](int begin, int end, float nx, float nz, bool perRow) {
+                Vector3 light;
+                for (int row = begin; row < end; ++row) {
+                    if (perRow || row == begin) {
+                        light = state.lightGrid->sample(scratch.x[row], scratch.z[row], nx, nz);
+                    }
+                    scratch.gridR[row] = light.x;
+                    scratch.gridG[row] = light.y;
+                    scratch.gridB[row] = light.z;
+                }
+            };
+            gridSpan(0, wallStart, 0.0f, 0.0f, true);
+            gridSpan(wallStart, wallEnd, normalX, normalZ, false);
+            gridSpan(wallEnd, m_height, 0.0f, 0.0f, true);
+        }
+
+        // === Resolve ===
+        const float portalG = 0.8f * state.portalPulse;
+        const float portalB = state.portalPulse;
+        const float inv255 = 1.0f / 255.0f;
+        unsigned char* out = m_pixels.data() + column * 4;
+        const size_t stride = static_cast<size_t>(m_width) * 4;
+
+        for (int row = 0; row < m_height; ++row, out += stride) {
+            uint32_t texel = scratch.texel[row];
+            float r = (texel & 0xFFu) * inv255 * scratch.lightRG[row] + scratch.gridR[row];
+            float g = ((texel >> 8) & 0xFFu) * inv255 * scratch.lightRG[row] + portalG * scratch.portal[row] + scratch.gridG[row];
+            float b = ((texel >> 16) & 0xFFu) * inv255 * scratch.lightB[row] + portalB * scratch.portal[row] + scratch.gridB[row];
+
+            float fog = scratch.fog[row];
+            out[0] = toByte(kFogColor[0] + (r - kFogColor[0]) * fog);
+            out[1] = toByte(kFogColor[1] + (g - kFogColor[1]) * fog);
+            out[2] = toByte(kFogColor[2] + (b - kFogColor[2]) * fog);
+            out[3] = 255;
+        }
+    }
+}
+
+void SoftwareRenderer::lightSpan(const FrameState& state, ColumnScratch& scratch, int begin, int end,
+                                 float normalX, float normalY, float normalZ) const {
+    using namespace simd;
+
+    const float4 eyeX = splat(state.eyeX);
+    const float4 eyeY = splat(state.eyeY);
+    const float4 eyeZ = splat(state.eyeZ);
+    const float4 nx = splat(normalX);
+    const float4 ny = splat(normalY);
+    const float4 nz = splat(normalZ);
+    const float4 zero = splat(0.0f);
+    const float4 one = splat(1.0f);
+    const float4 epsilon = splat(1e-4f);
+
+    // Flashlight cone: linear ramp between the cutoffs as in the shader, a step when they coincide
+    const float coneRange = m_coneInnerCos - m_coneOuterCos;
+    const float4 coneOuter = splat(m_coneOuterCos);
+    const float4 coneScale = splat(coneRange > 1e-6f ? 1.0f / coneRange : 0.0f);
+    const bool coneStep = coneRange <= 1e-6f;
+
+    for (int i = begin; i < end; i += 4) {
+        float4 toEyeX = sub(eyeX, load(&scratch.x[i]));
+        float4 toEyeY = sub(eyeY, load(&scratch.y[i]));
+        float4 toEyeZ = sub(eyeZ, load(&scratch.z[i]));
+        float4 distance = max(sqrt(madd(toEyeX, toEyeX, madd(toEyeY, toEyeY, mul(toEyeZ, toEyeZ)))), epsilon);
+        float4 invDistance = div(one, distance);
+
+        // Overhead light at eye + (0, 5, 5)
+        float4 lightX = toEyeX;
+        float4 lightY = add(toEyeY, splat(5.0f));
+        float4 lightZ = add(toEyeZ, splat(5.0f));
+        float4 lightLength = max(sqrt(madd(lightX, lightX, madd(lightY, lightY, mul(lightZ, lightZ)))), epsilon);
+        float4 diffuse = max(div(madd(nx, lightX, madd(ny, lightY, mul(nz, lightZ))), lightLength), zero);
+
+        float4 lightRG = madd(diffuse, splat(kDiffuseRG), splat(kAmbientRG));
+        float4 lightB = madd(diffuse, splat(kDiffuseB), splat(kAmbientB));
+
+        if (state.flashlightOn) {
+            float4 dirX = mul(toEyeX, invDistance);
+            float4 dirY = mul(toEyeY, invDistance);
+            float4 dirZ = mul(toEyeZ, invDistance);
+
+            // theta = dot(towards eye, -front)
+            float4 theta = sub(zero, madd(dirX, splat(state.frontX), madd(dirY, splat(state.frontY), mul(dirZ, splat(state.frontZ)))));
+            float4 cone = coneStep
+                ? select(greaterThan(theta, coneOuter), one, zero)
+                : min(max(mul(sub(theta, coneOuter), coneScale), zero), one);
+
+            float4 attenuation = div(one, madd(distance, madd(distance, splat(0.032f), splat(0.09f)), one));
+            float4 facing = max(madd(nx, dirX, madd(ny, dirY, mul(nz, dirZ))), zero);
+            float4 flash = mul(mul(facing, splat(state.flashlightIntensity)), mul(cone, attenuation));
+
+            lightRG = add(lightRG, flash);
+            lightB = add(lightB, flash);
+        }
+        store(&scratch.lightRG[i], lightRG);
+        store(&scratch.lightB[i], lightB);
+
+        float4 portal = zero;
+        if (state.portalLight) {
+            float4 px = sub(splat(state.portalX), load(&scratch.x[i]));
+            float4 py = sub(splat(state.portalY), load(&scratch.y[i]));
+            float4 pz = sub(splat(state.portalZ), load(&scratch.z[i]));
+            float4 portalDistance = max(sqrt(madd(px, px, madd(py, py, mul(pz, pz)))), epsilon);
+            float4 facing = max(div(madd(nx, px, madd(ny, py, mul(nz, pz))), portalDistance), zero);
+            float4 falloff = max(sub(one, div(portalDistance, splat(kPortalRadius))), zero);
+            portal = mul(mul(facing, mul(falloff, falloff)), splat(0.8f));
+        }
+        store(&scratch.portal[i], portal);
+
+        float4 fog = one;
+        if (m_fogEnabled) {
+            fog = div(sub(splat(kFogEnd), distance), splat(kFogEnd - kFogStart));
+            fog = min(max(fog, zero), one);
+        }
+        store(&scratch.fog[i], fog);
+    }
+}
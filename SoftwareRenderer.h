@@ -0,0 +1,146 @@
+#ifndef SOFTWARERENDERER_H
+#define SOFTWARERENDERER_H
+
+#include "Camera.h"
+#include "LightGrid.h"
+#include "Maze.h"
+#include "ThreadPool.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class SoftwareRenderer
+ * @brief CPU grid raycaster for the maze, for hosts without a GPU
+ *
+ * Walls have constant height on a uniform grid, so each screen column is
+ * one DDA walk through the cells until it hits a wall; floor and ceiling
+ * rows are recovered from their distance to the eye plane. Pitch is
+ * approximated by shifting the horizon (y-shearing), which is close to
+ * the GL image for the small pitches used while walking.
+ *
+ * Lighting follows fragment.glsl (ambient, overhead diffuse, flashlight,
+ * portal glow, linear fog) without the specular terms. Each column first
+ * gathers positions and texels, then lights them four rows at a time with
+ * the simd:: helpers, and columns are spread over a ThreadPool. No GL
+ * context is needed.
+ *
+ * With a LightGrid set, the portal and the flashlight's spill are flooded
+ * into the grid once per frame and every pixel adds one filtered lookup,
+ * as the GL LIGHT_GRID variant does, instead of lighting the portal per pixel.
+ */
+class SoftwareRenderer {
+public:
+    /**
+     * @param pool Workers for column blocks; nullptr renders on the caller only
+     */
+    explicit SoftwareRenderer(ThreadPool* pool = nullptr);
+
+    /**
+     * @brief Load one image per material layer, laid out as in MazeMaterials
+     *
+     * Layers that fail to load become grey, like the GL placeholder.
+     * @return false if any layer failed
+     */
+    bool loadMaterials(const std::vector<std::string>& filepaths, const MazeMaterials& materials);
+
+    void setSize(int width, int height);
+
+    /**
+     * @brief Render one frame into getPixels()
+     */
+    void render(const Maze& maze, const Camera& camera, const Vector3& portalPos,
+                float time, bool flashlightOn, float flashlightIntensity);
+
+    /**
+     * @brief Last frame as top-down RGBA8 rows
+     */
+    const std::vector<unsigned char>& getPixels() const { return m_pixels; }
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+
+    void setFogEnabled(bool enabled) { m_fogEnabled = enabled; }
+    void setPortalLightEnabled(bool enabled) { m_portalLightEnabled = enabled; }
+
+    /**
+     * @brief Light the portal and the flashlight's spill through a grid
+     * @param grid Sized for the rendered maze (LightGrid::setMaze); owned by the caller. nullptr turns it off.
+     */
+    void setLightGrid(LightGrid* grid) { m_lightGrid = grid; }
+
+    /**
+     * @brief Flashlight cone half-angles in degrees
+     *
+     * The GL path never sets its cutoff uniforms, which makes its cone a
+     * hemisphere; the default of 90/90 reproduces that.
+     */
+    void setFlashlightCone(float innerDegrees, float outerDegrees);
+
+private:
+    struct MipLevel {
+        int size;          // Square, power of two
+        int mask;          // size - 1, for wrapping
+        std::vector<uint32_t> texels;  // Packed RGBA8, row 0 at v = 0 (as GL samples it)
+    };
+
+    typedef std::vector<MipLevel> MipChain;
+
+    // Everything a column needs, fixed for the frame
+    struct FrameState {
+        float eyeX, eyeY, eyeZ;
+        float forwardX, forwardZ;  // Horizontal view direction (unit)
+        float rightX, rightZ;
+        float frontX, frontY, frontZ;  // Full view direction, for the flashlight
+        float focal;     // Pixels per unit at distance 1
+        float horizon;   // Screen row of the horizon after pitch
+        float maxDistance;
+        bool flashlightOn;
+        float flashlightIntensity;
+        bool portalLight;
+        float portalX, portalY, portalZ;
+        float portalPulse;
+        const LightGrid* lightGrid;  // Or nullptr
+    };
+
+    // Per-column scratch in structure-of-arrays form, padded to a multiple of 4
+    struct ColumnScratch {
+        std::vector<float> x, y, z;
+        std::vector<uint32_t> texel;
+        std::vector<float> lightRG, lightB, portal, fog;
+        std::vector<float> gridR, gridG, gridB;  // Untextured, like the GL point lights
+
+        void resize(int rows);
+    };
+
+    ThreadPool* m_pool;
+    int m_width;
+    int m_height;
+    std::vector<unsigned char> m_pixels;
+
+    std::vector<MipChain> m_layers;
+    MazeMaterials m_materials;
+
+    bool m_fogEnabled;
+    bool m_portalLightEnabled;
+    float m_coneInnerCos;
+    float m_coneOuterCos;
+
+    LightGrid* m_lightGrid;
+    std::vector<PointLight> m_gridLights;
+
+    static MipChain buildMipChain(const unsigned char* rgba, int size);
+    static MipChain makePlaceholder();
+    const MipChain& layer(int index) const;
+
+    static uint32_t sample(const MipChain& chain, float u, float v, float texelsPerPixel);
+
+    void renderColumns(const Maze& maze, const FrameState& state, int firstColumn, int endColumn);
+
+    /**
+     * @brief Light rows [begin, end) of the scratch, all with the same normal
+     */
+    void lightSpan(const FrameState& state, ColumnScratch& scratch, int begin, int end,
+                   float normalX, float normalY, float normalZ) const;
+};
+
+#endif // SOFTWARERENDERER_H
@@ -0,0 +1,142 @@
+#include "StreamingRingBuffer.h"
+#include "GLStateCache.h"
+#include "GLTrace.h"
+#include <algorithm>
+#include <iostream>
+
+StreamingRingBuffer::StreamingRingBuffer(GLenum target, size_t frameCapacity, int frameCount)
+    : m_target(target),
+      m_buffer(0),
+      m_frameCapacity(frameCapacity),
+      m_alignment(16),
+      m_frameCount(std::max(frameCount, 1)),
+      m_frameIndex(0),
+      m_head(0),
+      m_persistentData(nullptr),
+      m_sliceMapped(false),
+      m_fences(m_frameCount, nullptr),
+      m_stallCount(0),
+      m_peakFrameBytes(0),
+      m_overflowReported(false) {
+    if (m_target == GL_UNIFORM_BUFFER) {
+        GLint alignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        m_alignment = std::max<size_t>(m_alignment, static_cast<size_t>(alignment));
+    }
+
+    // Keep every region start aligned as well
+    m_frameCapacity = (m_frameCapacity + m_alignment - 1) / m_alignment * m_alignment;
+    GLsizeiptr totalSize = static_cast<GLsizeiptr>(m_frameCapacity * m_frameCount);
+
+    glGenBuffers(1, &m_buffer);
+    GLStateCache::get().bindBuffer(m_target, m_buffer);
+
+    if (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(m_target, totalSize, nullptr, flags);
+        m_persistentData = static_cast<unsigned char*>(glMapBufferRange(m_target, 0, totalSize, flags));
+        if (!m_persistentData) {
+            // Immutable storage cannot be re-specified; start over with a plain buffer
+            GLStateCache::get().deleteBuffer(m_buffer);
+            glGenBuffers(1, &m_buffer);
+            GLStateCache::get().bindBuffer(m_target, m_buffer);
+        }
+    }
+    if (!m_persistentData) {
+        glBufferData(m_target, totalSize, nullptr, GL_STREAM_DRAW);
+    }
+
+    GLStateCache::get().bindBuffer(m_target, 0);
+}
+
+StreamingRingBuffer::~StreamingRingBuffer() {
+    for (GLsync fence : m_fences) {
+        if (fence) glDeleteSync(fence);
+    }
+    if (m_buffer != 0) {
+        if (m_persistentData || m_sliceMapped) {
+            GLStateCache::get().bindBuffer(m_target, m_buffer);
+            glUnmapBuffer(m_target);
+            GLStateCache::get().bindBuffer(m_target, 0);
+        }
+        GLStateCache::get().deleteBuffer(m_buffer);
+    }
+}
+
+void StreamingRingBuffer::beginFrame() {
+    m_frameIndex = (m_frameIndex + 1) % m_frameCount;
+    m_head = 0;
+
+    GLsync fence = m_fences[m_frameIndex];
+    if (!fence) {
+        return;
+    }
+
+    GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        // The GPU is more than frameCount - 1 frames behind; wait rather than corrupt its data
+        ++m_stallCount;
+        do {
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);  // 1 ms
+        } while (status == GL_TIMEOUT_EXPIRED);
+    }
+
+    glDeleteSync(fence);
+    m_fences[m_frameIndex] = nullptr;
+}
+
+void* StreamingRingBuffer::map(size_t size, GLintptr& offset) {
+    if (m_sliceMapped) {
+        unmap();
+    }
+
+    size_t start = (m_head + m_alignment - 1) / m_alignment * m_alignment;
+    if (start + size > m_frameCapacity) {
+        if (!m_overflowReported) {
+            std::cerr << "WARNING: Streaming buffer full (" << m_frameCapacity << " bytes per frame)" << std::endl;
+            m_overflowReported = true;
+        }
+        return nullptr;
+    }
+
+    m_head = start + size;
+    m_peakFrameBytes = std::max(m_peakFrameBytes, m_head);
+    MAZE_GL_TRACE_UPLOAD(size);  // Written by the caller through the returned pointer
+    offset = static_cast<GLintptr>(m_frameIndex * m_frameCapacity + start);
+
+    if (m_persistentData) {
+        return m_persistentData + offset;
+    }
+
+    // The fences already guarantee the GPU is not reading this slice. The
+    // buffer stays bound, so the unmap and the next slice skip the rebind
+    GLStateCache::get().bindBuffer(m_target, m_buffer);
+    void* data = glMapBufferRange(m_target, offset, static_cast<GLsizeiptr>(size),
+        GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+
+    m_sliceMapped = data != nullptr;
+    return data;
+}
+
+void StreamingRingBuffer::unmap() {
+    if (!m_sliceMapped) {
+        return;  // Persistent and coherent: writes are already visible
+    }
+
+    GLStateCache::get().bindBuffer(m_target, m_buffer);
+    glUnmapBuffer(m_target);
+    m_sliceMapped = false;
+}
+
+void StreamingRingBuffer::endFrame() {
+    unmap();
+
+    if (m_fences[m_frameIndex]) {
+        glDeleteSync(m_fences[m_frameIndex]);
+    }
+    m_fences[m_frameIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void StreamingRingBuffer::bindRange(GLuint index, GLintptr offset, GLsizeiptr size) const {
+    GLStateCache::get().bindBufferRange(m_target, index, m_buffer, offset, size);
+}
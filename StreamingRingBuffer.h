@@ -0,0 +1,90 @@
+#ifndef STREAMINGRINGBUFFER_H
+#define STREAMINGRINGBUFFER_H
+
+#include <cstddef>
+#include <vector>
+#include <gl/glew/glew.h>
+
+/**
+ * @class StreamingRingBuffer
+ * @brief One GPU buffer split into per-frame regions for data rewritten every frame
+ *
+ * Frame N writes only into region N % frameCount, and a fence placed at
+ * endFrame() tells beginFrame() when the GPU is done with a region, so the
+ * CPU never overwrites data a queued draw still reads. With triple
+ * buffering that wait is normally already satisfied.
+ *
+ * With GL_ARB_buffer_storage the buffer is mapped once, persistently and
+ * coherently, and map() is pointer arithmetic. Otherwise each map() is an
+ * unsynchronized glMapBufferRange of just that slice (the fences provide
+ * the synchronization the driver is told to skip).
+ *
+ * Usage per frame: beginFrame(), then any number of map()/unmap() pairs,
+ * each followed by draws that read the slice, then endFrame().
+ */
+class StreamingRingBuffer {
+public:
+    /**
+     * @param target Binding target the data is consumed through (e.g. GL_UNIFORM_BUFFER)
+     * @param frameCapacity Bytes available to each frame
+     * @param frameCount Number of regions (3 = triple buffering)
+     */
+    StreamingRingBuffer(GLenum target, size_t frameCapacity, int frameCount = 3);
+    ~StreamingRingBuffer();
+
+    StreamingRingBuffer(const StreamingRingBuffer&) = delete;
+    StreamingRingBuffer& operator=(const StreamingRingBuffer&) = delete;
+
+    /**
+     * @brief Move to the next region, waiting for its fence if the GPU lags behind
+     */
+    void beginFrame();
+
+    /**
+     * @brief Reserve size bytes in the current region and return a CPU pointer to them
+     * @param offset Receives the slice's offset in the buffer, for glBindBufferRange etc.
+     * @return nullptr if the region is full (the frame should skip that data)
+     */
+    void* map(size_t size, GLintptr& offset);
+
+    /**
+     * @brief Finish writing the last slice; must be called before draws read it
+     */
+    void unmap();
+
+    /**
+     * @brief Fence the current region
+     */
+    void endFrame();
+
+    /**
+     * @brief glBindBufferRange on the buffer's target (indexed targets only)
+     */
+    void bindRange(GLuint index, GLintptr offset, GLsizeiptr size) const;
+
+    GLuint getBuffer() const { return m_buffer; }
+    bool isPersistent() const { return m_persistentData != nullptr; }
+
+    // Frames whose region was still in use by the GPU at beginFrame()
+    int getStallCount() const { return m_stallCount; }
+    size_t getPeakFrameBytes() const { return m_peakFrameBytes; }
+
+private:
+    GLenum m_target;
+    GLuint m_buffer;
+    size_t m_frameCapacity;
+    size_t m_alignment;
+    int m_frameCount;
+    int m_frameIndex;
+    size_t m_head;  // Bytes used in the current region
+
+    unsigned char* m_persistentData;  // Whole buffer, when persistently mapped
+    bool m_sliceMapped;               // Unsynchronized map outstanding
+    std::vector<GLsync> m_fences;
+
+    int m_stallCount;
+    size_t m_peakFrameBytes;
+    bool m_overflowReported;
+};
+
+#endif // STREAMINGRINGBUFFER_H
@@ -1,4 +1,7 @@
 #include "Texture.h"
+#include "GLStateCache.h"
+#include "GLTrace.h"
+#include "DdsImage.h"
 #include <SFML/Graphics/Image.hpp>
 #include <iostream>
 
@@ -6,7 +9,7 @@ Texture::Texture() : m_textureId(0) {}
 
 Texture::~Texture() {
     if (m_textureId != 0) {
-        glDeleteTextures(1, &m_textureId);
+        GLStateCache::get().deleteTexture(m_textureId);
     }
 }
 
@@ -17,7 +20,7 @@ Texture::Texture(Texture&& other) noexcept : m_textureId(other.m_textureId) {
 Texture& Texture::operator=(Texture&& other) noexcept {
     if (this != &other) {
         if (m_textureId != 0) {
-            glDeleteTextures(1, &m_textureId);
+            GLStateCache::get().deleteTexture(m_textureId);
         }
         m_textureId = other.m_textureId;
         other.m_textureId = 0;
@@ -26,6 +29,11 @@ Texture& Texture::operator=(Texture&& other) noexcept {
 }
 
 bool Texture::loadFromFile(const std::string& filepath, bool generateMipmap) {
+    // Prefer a converted .dds next to the image (see --convert-textures)
+    if (loadCompressed(getCompressedPath(filepath), generateMipmap)) {
+        return true;
+    }
+
     // Load image using SFML
     sf::Image image;
     if (!image.loadFromFile(filepath)) {
@@ -42,7 +50,7 @@ bool Texture::loadFromFile(const std::string& filepath, bool generateMipmap) {
 
     // Generate OpenGL texture
     glGenTextures(1, &m_textureId);
-    glBindTexture(GL_TEXTURE_2D, m_textureId);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D, m_textureId);
 
     // Set texture parameters
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -51,6 +59,7 @@ bool Texture::loadFromFile(const std::string& filepath, bool generateMipmap) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
     // Upload texture data
+    MAZE_GL_TRACE_UPLOAD(static_cast<size_t>(size.x) * size.y * 4);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
 
     // Generate mipmaps if requested
@@ -58,17 +67,130 @@ bool Texture::loadFromFile(const std::string& filepath, bool generateMipmap) {
         glGenerateMipmap(GL_TEXTURE_2D);
     }
 
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D, 0);
 
     std::cout << "Loaded texture: " << filepath << " (" << size.x << "x" << size.y << ")" << std::endl;
     return true;
 }
 
+bool Texture::loadCompressed(const std::string& ddsPath, bool useMipmaps) {
+    DdsImage image;
+    if (!image.loadFromFile(ddsPath)) {
+        return false;
+    }
+
+    if (!DdsImage::isFormatSupported(image.getFormat())) {
+        std::cout << "  " << image.getFormatName() << " not supported by driver, skipping " << ddsPath << std::endl;
+        return false;
+    }
+
+    const auto& levels = image.getLevels();
+    GLint levelCount = useMipmaps ? static_cast<GLint>(levels.size()) : 1;
+
+    glGenTextures(1, &m_textureId);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D, m_textureId);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+
+    // The mip chain comes from the file; rows are already bottom-up
+    size_t uploadedBytes = 0;
+    for (GLint i = 0; i < levelCount; ++i) {
+        const DdsImage::Level& level = levels[i];
+        MAZE_GL_TRACE_UPLOAD(level.data.size());
+        glCompressedTexImage2D(GL_TEXTURE_2D, i, image.getGLFormat(), level.width, level.height, 0,
+            static_cast<GLsizei>(level.data.size()), level.data.data());
+        uploadedBytes += level.data.size();
+    }
+
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D, 0);
+
+    std::cout << "Loaded texture: " << ddsPath << " (" << image.getWidth() << "x" << image.getHeight()
+        << ", " << image.getFormatName() << ", " << levelCount << " mips, "
+        << uploadedBytes / 1024 << " KB)" << std::endl;
+    return true;
+}
+
+void Texture::createPlaceholder(unsigned char r, unsigned char g, unsigned char b) {
+    if (m_textureId == 0) {
+        glGenTextures(1, &m_textureId);
+    }
+
+    const unsigned char pixel[4] = { r, g, b, 255 };
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D, m_textureId);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    MAZE_GL_TRACE_UPLOAD(sizeof(pixel));
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D, 0);
+}
+
+void Texture::createSingleChannel(int width, int height, const unsigned char* pixels) {
+    if (m_textureId == 0) {
+        glGenTextures(1, &m_textureId);
+    }
+
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D, m_textureId);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+
+    // Rows are tightly packed bytes
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    MAZE_GL_TRACE_UPLOAD(static_cast<size_t>(width) * height);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, pixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D, 0);
+}
+
+void Texture::createFloatRgba(int width, int height, const float* pixels) {
+    if (m_textureId == 0) {
+        glGenTextures(1, &m_textureId);
+    }
+
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D, m_textureId);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+
+    MAZE_GL_TRACE_UPLOAD(static_cast<size_t>(width) * height * 4 * sizeof(float));
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, pixels);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D, 0);
+}
+
+void Texture::updateFloatRgba(unsigned int unit, int x, int y, int width, int height, int rowLength, const float* pixels) {
+    if (m_textureId == 0) return;
+
+    bind(unit);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength);
+    MAZE_GL_TRACE_UPLOAD(static_cast<size_t>(width) * height * 4 * sizeof(float));
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_FLOAT, pixels);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+}
+
+std::string Texture::getCompressedPath(const std::string& filepath) {
+    size_t dot = filepath.find_last_of('.');
+    size_t slash = filepath.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return filepath + ".dds";
+    }
+    return filepath.substr(0, dot) + ".dds";
+}
+
 void Texture::bind(unsigned int unit) const {
-    glActiveTexture(GL_TEXTURE0 + unit);
-    glBindTexture(GL_TEXTURE_2D, m_textureId);
+    GLStateCache::get().bindTexture(unit, GL_TEXTURE_2D, m_textureId);
 }
 
 void Texture::unbind() const {
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D, 0);
 }
\ No newline at end of file
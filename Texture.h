@@ -25,12 +25,60 @@ public:
 
     /**
      * @brief Load texture from image file
+     *
+     * If a block-compressed .dds with the same base name exists (and the
+     * driver supports its format), it is used instead of decoding the image.
+     *
      * @param filepath Path to image file
      * @param generateMipmap Whether to generate mipmaps
      * @return true if successful, false otherwise
      */
     bool loadFromFile(const std::string& filepath, bool generateMipmap = true);
 
+    /**
+     * @brief Load a .dds file with its stored mip chain
+     * @param useMipmaps Upload all levels (otherwise only the top one)
+     * @return false if missing or unsupported
+     */
+    bool loadCompressed(const std::string& ddsPath, bool useMipmaps = true);
+
+    /**
+     * @brief "textures/wall.png" -> "textures/wall.dds"
+     */
+    static std::string getCompressedPath(const std::string& filepath);
+
+    /**
+     * @brief Replace the contents with a 1x1 solid colour (stand-in while loading)
+     */
+    void createPlaceholder(unsigned char r, unsigned char g, unsigned char b);
+
+    /**
+     * @brief Replace the contents with a single-channel (GL_R8) image
+     *
+     * Repeating and bilinear without mipmaps, for lookup data such as
+     * NoiseTexture that shaders sample at a known scale.
+     * @param pixels width * height bytes, bottom row first
+     */
+    void createSingleChannel(int width, int height, const unsigned char* pixels);
+
+    /**
+     * @brief Replace the contents with a floating-point RGBA (GL_RGBA16F) image
+     *
+     * Clamped and bilinear without mipmaps, for baked data such as a
+     * Lightmap whose values may leave the 0..1 range.
+     * @param pixels width * height * 4 floats, bottom row first
+     */
+    void createFloatRgba(int width, int height, const float* pixels);
+
+    /**
+     * @brief Overwrite a rectangle of an image made by createFloatRgba()
+     *
+     * Meant for every frame: the texture is bound to unit, where it stays,
+     * so textures bound on the other units are left alone.
+     * @param pixels The rectangle's first texel; its rows are rowLength texels apart
+     */
+    void updateFloatRgba(unsigned int unit, int x, int y, int width, int height, int rowLength, const float* pixels);
+
     /**
      * @brief Bind this texture to the specified texture unit
      * @param unit Texture unit (0-31)
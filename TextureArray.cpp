@@ -0,0 +1,219 @@
+#include "TextureArray.h"
+#include "GLStateCache.h"
+#include "GLTrace.h"
+#include "Texture.h"
+#include "DdsImage.h"
+#include <SFML/Graphics/Image.hpp>
+#include <algorithm>
+#include <iostream>
+
+TextureArray::TextureArray() : m_textureId(0), m_layerCount(0) {}
+
+TextureArray::~TextureArray() {
+    release();
+}
+
+TextureArray::TextureArray(TextureArray&& other) noexcept
+    : m_textureId(other.m_textureId),
+      m_layerCount(other.m_layerCount) {
+    other.m_textureId = 0;
+    other.m_layerCount = 0;
+}
+
+TextureArray& TextureArray::operator=(TextureArray&& other) noexcept {
+    if (this != &other) {
+        release();
+        m_textureId = other.m_textureId;
+        m_layerCount = other.m_layerCount;
+        other.m_textureId = 0;
+        other.m_layerCount = 0;
+    }
+    return *this;
+}
+
+bool TextureArray::loadFromFiles(const std::vector<std::string>& filepaths) {
+    release();
+    if (filepaths.empty()) {
+        return false;
+    }
+
+    if (loadCompressedLayers(filepaths) || loadImageLayers(filepaths)) {
+        m_layerCount = static_cast<int>(filepaths.size());
+        return true;
+    }
+
+    release();
+    return false;
+}
+
+bool TextureArray::loadCompressedLayers(const std::vector<std::string>& filepaths) {
+    std::vector<DdsImage> images(filepaths.size());
+    for (size_t i = 0; i < filepaths.size(); ++i) {
+        if (!images[i].loadFromFile(Texture::getCompressedPath(filepaths[i]))) {
+            return false;
+        }
+
+        // All layers share one format, size and mip count
+        const DdsImage& first = images[0];
+        if (images[i].getFormat() != first.getFormat() ||
+            images[i].getWidth() != first.getWidth() || images[i].getHeight() != first.getHeight() ||
+            images[i].getLevels().size() != first.getLevels().size()) {
+            std::cout << "  Texture array: .dds layers differ, using source images" << std::endl;
+            return false;
+        }
+    }
+
+    if (!DdsImage::isFormatSupported(images[0].getFormat())) {
+        return false;
+    }
+
+    GLsizei layers = static_cast<GLsizei>(images.size());
+    GLenum format = images[0].getGLFormat();
+    int levelCount = static_cast<int>(images[0].getLevels().size());
+
+    glGenTextures(1, &m_textureId);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D_ARRAY, m_textureId);
+
+    size_t uploadedBytes = 0;
+    for (int level = 0; level < levelCount; ++level) {
+        const DdsImage::Level& size = images[0].getLevels()[level];
+        GLsizei layerBytes = static_cast<GLsizei>(size.data.size());
+
+        // Allocate the level, then fill it one layer at a time
+        glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, format, size.width, size.height, layers, 0,
+            layerBytes * layers, nullptr);
+        for (GLsizei layer = 0; layer < layers; ++layer) {
+            const DdsImage::Level& data = images[layer].getLevels()[level];
+            MAZE_GL_TRACE_UPLOAD(layerBytes);
+            glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layer, size.width, size.height, 1,
+                format, layerBytes, data.data.data());
+        }
+        uploadedBytes += static_cast<size_t>(layerBytes) * layers;
+    }
+
+    setSamplingParameters(levelCount);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    std::cout << "Loaded texture array: " << layers << " layers (" << images[0].getWidth() << "x"
+        << images[0].getHeight() << ", " << images[0].getFormatName() << ", "
+        << uploadedBytes / 1024 << " KB)" << std::endl;
+    return true;
+}
+
+bool TextureArray::loadImageLayers(const std::vector<std::string>& filepaths) {
+    std::vector<sf::Image> images(filepaths.size());
+    unsigned int width = 0;
+    unsigned int height = 0;
+
+    for (size_t i = 0; i < filepaths.size(); ++i) {
+        if (!images[i].loadFromFile(filepaths[i])) {
+            std::cerr << "Failed to load texture array layer: " << filepaths[i] << std::endl;
+            return false;
+        }
+
+        // Flip image vertically (OpenGL expects origin at bottom-left)
+        images[i].flipVertically();
+
+        width = std::max(width, images[i].getSize().x);
+        height = std::max(height, images[i].getSize().y);
+    }
+
+    GLsizei layers = static_cast<GLsizei>(images.size());
+
+    glGenTextures(1, &m_textureId);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D_ARRAY, m_textureId);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, width, height, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    for (GLsizei layer = 0; layer < layers; ++layer) {
+        sf::Vector2u size = images[layer].getSize();
+        const sf::Uint8* pixels = images[layer].getPixelsPtr();
+
+        std::vector<unsigned char> resized;
+        if (size.x != width || size.y != height) {
+            resized = resample(pixels, size.x, size.y, width, height);
+            pixels = resized.data();
+        }
+
+        MAZE_GL_TRACE_UPLOAD(static_cast<size_t>(width) * height * 4);
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    }
+
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+    int levelCount = 1;
+    for (unsigned int s = std::max(width, height); s > 1; s /= 2) {
+        ++levelCount;
+    }
+    setSamplingParameters(levelCount);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    std::cout << "Loaded texture array: " << layers << " layers (" << width << "x" << height << ")" << std::endl;
+    return true;
+}
+
+std::vector<unsigned char> TextureArray::resample(const unsigned char* src, unsigned int srcWidth, unsigned int srcHeight,
+                                                  unsigned int dstWidth, unsigned int dstHeight) {
+    std::vector<unsigned char> dst(static_cast<size_t>(dstWidth) * dstHeight * 4);
+    for (unsigned int y = 0; y < dstHeight; ++y) {
+        float fy = std::max((y + 0.5f) * srcHeight / dstHeight - 0.5f, 0.0f);
+        unsigned int y0 = std::min(static_cast<unsigned int>(fy), srcHeight - 1);
+        unsigned int y1 = std::min(y0 + 1, srcHeight - 1);
+        float ty = fy - y0;
+
+        for (unsigned int x = 0; x < dstWidth; ++x) {
+            float fx = std::max((x + 0.5f) * srcWidth / dstWidth - 0.5f, 0.0f);
+            unsigned int x0 = std::min(static_cast<unsigned int>(fx), srcWidth - 1);
+            unsigned int x1 = std::min(x0 + 1, srcWidth - 1);
+            float tx = fx - x0;
+
+            for (int c = 0; c < 4; ++c) {
+                float top = src[(y0 * srcWidth + x0) * 4 + c] * (1.0f - tx) + src[(y0 * srcWidth + x1) * 4 + c] * tx;
+                float bottom = src[(y1 * srcWidth + x0) * 4 + c] * (1.0f - tx) + src[(y1 * srcWidth + x1) * 4 + c] * tx;
+                dst[(y * dstWidth + x) * 4 + c] = static_cast<unsigned char>(top * (1.0f - ty) + bottom * ty + 0.5f);
+            }
+        }
+    }
+    return dst;
+}
+
+void TextureArray::createPlaceholder(int layerCount, unsigned char r, unsigned char g, unsigned char b) {
+    if (m_textureId == 0) {
+        glGenTextures(1, &m_textureId);
+    }
+
+    std::vector<unsigned char> pixels(static_cast<size_t>(layerCount) * 4);
+    for (int i = 0; i < layerCount; ++i) {
+        pixels[i * 4 + 0] = r;
+        pixels[i * 4 + 1] = g;
+        pixels[i * 4 + 2] = b;
+        pixels[i * 4 + 3] = 255;
+    }
+
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D_ARRAY, m_textureId);
+    MAZE_GL_TRACE_UPLOAD(pixels.size());
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, 1, 1, layerCount, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    setSamplingParameters(1);
+    GLStateCache::get().bindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    m_layerCount = layerCount;
+}
+
+void TextureArray::setSamplingParameters(int levelCount) {
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, levelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+}
+
+void TextureArray::bind(unsigned int unit) const {
+    GLStateCache::get().bindTexture(unit, GL_TEXTURE_2D_ARRAY, m_textureId);
+}
+
+void TextureArray::release() {
+    if (m_textureId != 0) {
+        GLStateCache::get().deleteTexture(m_textureId);
+        m_textureId = 0;
+    }
+    m_layerCount = 0;
+}
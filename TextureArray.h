@@ -0,0 +1,70 @@
+#ifndef TEXTUREARRAY_H
+#define TEXTUREARRAY_H
+
+#include <string>
+#include <vector>
+#include <gl/glew/glew.h>
+
+/**
+ * @class TextureArray
+ * @brief A GL_TEXTURE_2D_ARRAY holding one material per layer
+ *
+ * Layers must share a size, so images are resampled to the largest one.
+ * When every layer has a converted .dds of the same format and size, the
+ * compressed data and its mip chain are used instead.
+ */
+class TextureArray {
+public:
+    TextureArray();
+    ~TextureArray();
+
+    // Disable copy operations
+    TextureArray(const TextureArray&) = delete;
+    TextureArray& operator=(const TextureArray&) = delete;
+
+    // Enable move operations
+    TextureArray(TextureArray&& other) noexcept;
+    TextureArray& operator=(TextureArray&& other) noexcept;
+
+    /**
+     * @brief Load one image per layer, in order
+     * @param filepaths Layer i is loaded from filepaths[i]
+     * @return false if any layer fails to load
+     */
+    bool loadFromFiles(const std::vector<std::string>& filepaths);
+
+    /**
+     * @brief Replace the contents with 1x1 solid-colour layers (stand-in while loading)
+     */
+    void createPlaceholder(int layerCount, unsigned char r, unsigned char g, unsigned char b);
+
+    /**
+     * @brief Wrap/filter state for the currently bound array with levelCount mips
+     */
+    static void setSamplingParameters(int levelCount);
+
+    /**
+     * @brief Bilinear resize of an RGBA8 image to a common layer size
+     */
+    static std::vector<unsigned char> resample(const unsigned char* src, unsigned int srcWidth, unsigned int srcHeight,
+                                               unsigned int dstWidth, unsigned int dstHeight);
+
+    /**
+     * @brief Bind to a texture unit as GL_TEXTURE_2D_ARRAY
+     */
+    void bind(unsigned int unit = 0) const;
+
+    GLuint getTextureId() const { return m_textureId; }
+    int getLayerCount() const { return m_layerCount; }
+    bool isValid() const { return m_textureId != 0; }
+
+private:
+    GLuint m_textureId;
+    int m_layerCount;
+
+    bool loadCompressedLayers(const std::vector<std::string>& filepaths);
+    bool loadImageLayers(const std::vector<std::string>& filepaths);
+    void release();
+};
+
+#endif // TEXTUREARRAY_H
@@ -0,0 +1,116 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <memory>
+
+ThreadPool::ThreadPool(unsigned int threadCount) : m_activeTasks(0), m_stopping(false) {
+    if (threadCount == 0) {
+        // Leave one core for the main (GL) thread
+        unsigned int cores = std::thread::hardware_concurrency();
+        threadCount = std::max(cores > 1 ? cores - 1 : 1u, 1u);
+    }
+
+    m_workers.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_taskAvailable.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_taskAvailable.notify_one();
+}
+
+void ThreadPool::waitIdle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this]() { return m_tasks.empty() && m_activeTasks == 0; });
+}
+
+void ThreadPool::parallelFor(int count, int grain, const std::function<void(int, int)>& fn) {
+    if (count <= 0) {
+        return;
+    }
+    grain = std::max(grain, 1);
+    const int chunkCount = (count + grain - 1) / grain;
+    if (chunkCount == 1) {
+        fn(0, count);
+        return;
+    }
+
+    // Shared so helper tasks that only start after the call returned stay safe;
+    // they find no chunks left and never touch fn
+    struct Range {
+        std::atomic<int> nextChunk;
+        std::atomic<int> doneChunks;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    auto range = std::make_shared<Range>();
+    range->nextChunk = 0;
+    range->doneChunks = 0;
+
+    const std::function<void(int, int)>* body = &fn;
+    auto work = [range, body, count, grain, chunkCount]() {
+        int chunk;
+        while ((chunk = range->nextChunk.fetch_add(1)) < chunkCount) {
+            int begin = chunk * grain;
+            (*body)(begin, std::min(begin + grain, count));
+            if (range->doneChunks.fetch_add(1) + 1 == chunkCount) {
+                std::lock_guard<std::mutex> lock(range->mutex);
+                range->finished.notify_all();
+            }
+        }
+    };
+
+    int helpers = std::min(static_cast<int>(m_workers.size()), chunkCount - 1);
+    for (int i = 0; i < helpers; ++i) {
+        enqueue(work);
+    }
+    work();
+
+    std::unique_lock<std::mutex> lock(range->mutex);
+    range->finished.wait(lock, [&range, chunkCount]() { return range->doneChunks.load() == chunkCount; });
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_taskAvailable.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+
+            // Drain the queue before exiting so waitIdle() callers are released
+            if (m_tasks.empty()) {
+                return;
+            }
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+            ++m_activeTasks;
+        }
+
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_activeTasks;
+            if (m_tasks.empty() && m_activeTasks == 0) {
+                m_idle.notify_all();
+            }
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Fixed set of worker threads consuming a FIFO task queue
+ *
+ * Tasks must not touch OpenGL; only the thread that owns the context may.
+ */
+class ThreadPool {
+public:
+    /**
+     * @param threadCount Number of workers; 0 uses all cores but one (at least 1)
+     */
+    explicit ThreadPool(unsigned int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queue a task; returns immediately
+     */
+    void enqueue(std::function<void()> task);
+
+    /**
+     * @brief Block until the queue is empty and no task is running
+     */
+    void waitIdle();
+
+    /**
+     * @brief Run fn(begin, end) over [0, count) in chunks of `grain`, blocking until done
+     *
+     * The calling thread works through chunks too, so this makes progress
+     * even while the workers are busy with other tasks. Only this call's
+     * chunks are waited for, not the rest of the queue.
+     */
+    void parallelFor(int count, int grain, const std::function<void(int, int)>& fn);
+
+    unsigned int getThreadCount() const { return static_cast<unsigned int>(m_workers.size()); }
+
+private:
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_taskAvailable;
+    std::condition_variable m_idle;
+    unsigned int m_activeTasks;
+    bool m_stopping;
+
+    void workerLoop();
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,63 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+/**
+ * @class TripleBuffer
+ * @brief Lock-free hand-over of the latest value from one writer to one reader
+ *
+ * Three slots: the writer fills its own, then swaps it with the shared
+ * middle slot; the reader swaps its slot with the middle one when a newer
+ * value is there. Neither side ever waits for the other, and the reader
+ * always sees a complete value. Values the reader never picked up are
+ * simply overwritten. Slots are reused, so T keeps its allocations.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : m_writeIndex(0), m_shared(1), m_readIndex(2) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /**
+     * @brief Writer side: the slot to fill next (holds an older value, overwrite all of it)
+     */
+    T& writeSlot() { return m_slots[m_writeIndex]; }
+
+    /**
+     * @brief Writer side: make the filled slot the latest value
+     */
+    void publish() {
+        m_writeIndex = m_shared.exchange(m_writeIndex | kFresh, std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    /**
+     * @brief Reader side: move to the latest value if one was published since the last call
+     * @return true if readSlot() changed
+     */
+    bool acquire() {
+        if (!(m_shared.load(std::memory_order_relaxed) & kFresh)) {
+            return false;
+        }
+        m_readIndex = m_shared.exchange(m_readIndex, std::memory_order_acq_rel) & kIndexMask;
+        return true;
+    }
+
+    /**
+     * @brief Reader side: the value acquired last; stays valid until the next acquire()
+     */
+    const T& readSlot() const { return m_slots[m_readIndex]; }
+
+private:
+    static const int kIndexMask = 3;
+    static const int kFresh = 4;  // Set while the shared slot holds an unread value
+
+    T m_slots[3];
+    int m_writeIndex;             // Only touched by the writer
+    std::atomic<int> m_shared;    // Slot index | kFresh
+    int m_readIndex;              // Only touched by the reader
+};
+
+#endif // TRIPLEBUFFER_H
@@ -1,16 +1,213 @@
 #include "Game.h"
+#include "Benchmarks.h"
+#include "DdsImage.h"
+#include "Texture.h"
 #include <iostream>
 #include <memory>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdlib>
+#include <sstream>
+
+namespace {
+    // 3D-Maze --headless [--frames N] [--size WxH] [--seed S] [--capture 0,60,...]
+    //                    [--output DIR] [--stats FILE.csv] [--record FILE] [--dynamic-resolution] [--software]
+    //                    [--light-grid]
+    bool parseHeadlessOptions(int argc, char* argv[], HeadlessOptions& options) {
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (arg == "--dynamic-resolution") {
+                options.dynamicResolution = true;
+            }
+            else if (arg == "--software") {
+                options.software = true;
+            }
+            else if (arg == "--light-grid") {
+                options.lightGrid = true;
+            }
+            else if (arg == "--frames" && hasValue) {
+                options.frames = std::atoi(argv[++i]);
+            }
+            else if (arg == "--size" && hasValue) {
+                char separator = 0;
+                std::istringstream size(argv[++i]);
+                if (!(size >> options.width >> separator >> options.height) || separator != 'x') {
+                    std::cerr << "Invalid --size, expected WxH" << std::endl;
+                    return false;
+                }
+            }
+            else if (arg == "--seed" && hasValue) {
+                options.seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+            }
+            else if (arg == "--capture" && hasValue) {
+                std::istringstream frames(argv[++i]);
+                std::string frame;
+                while (std::getline(frames, frame, ',')) {
+                    options.captureFrames.push_back(std::atoi(frame.c_str()));
+                }
+            }
+            else if (arg == "--output" && hasValue) {
+                options.outputDirectory = argv[++i];
+            }
+            else if (arg == "--stats" && hasValue) {
+                options.statsPath = argv[++i];
+            }
+            else if (arg == "--record" && hasValue) {
+                options.recordPath = argv[++i];
+            }
+            else {
+                std::cerr << "Unknown headless option '" << arg << "'" << std::endl;
+                return false;
+            }
+        }
+
+        if (options.frames <= 0 || options.width <= 0 || options.height <= 0) {
+            std::cerr << "Frame count and size must be positive" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // 3D-Maze --replay FILE [--loops N] [--null] [--no-depth-prepass] [--no-lightmap] [--light-grid]
+    //                      [--stats FILE.csv]
+    bool parseReplayOptions(int argc, char* argv[], ReplayOptions& options) {
+        for (int i = 3; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (arg == "--null") {
+                options.nullBackend = true;
+            }
+            else if (arg == "--no-depth-prepass") {
+                options.depthPrepass = false;
+            }
+            else if (arg == "--no-lightmap") {
+                options.lightmap = false;
+            }
+            else if (arg == "--light-grid") {
+                options.lightGrid = true;
+            }
+            else if (arg == "--loops" && hasValue) {
+                options.loops = std::atoi(argv[++i]);
+            }
+            else if (arg == "--stats" && hasValue) {
+                options.statsPath = argv[++i];
+            }
+            else {
+                std::cerr << "Unknown replay option '" << arg << "'" << std::endl;
+                return false;
+            }
+        }
+
+        if (options.loops <= 0) {
+            std::cerr << "Loop count must be positive" << std::endl;
+            return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    // Developer benchmarks: 3D-Maze --bench <name>
+    if (argc >= 3 && std::string(argv[1]) == "--bench") {
+        return Benchmarks::run(argv[2]);
+    }
+
+    // Offline texture conversion: 3D-Maze --convert-textures [image ...]
+    // Writes a BC1/BC3 .dds with mips next to each image; no window needed
+    if (argc >= 2 && std::string(argv[1]) == "--convert-textures") {
+        std::vector<std::string> images(argv + 2, argv + argc);
+        if (images.empty()) {
+            images = { "textures/wall.png", "textures/floor.png", "textures/ceiling.png",
+                       "textures/wall2.png", "textures/floor2.png", "textures/ceiling2.png" };
+        }
+
+        int failures = 0;
+        for (const auto& image : images) {
+            if (argc == 2 && !std::ifstream(image).good()) {
+                continue;  // Default list: skip textures this checkout doesn't have
+            }
+            if (!DdsImage::convertImageFile(image, Texture::getCompressedPath(image))) {
+                ++failures;
+            }
+        }
+        return failures == 0 ? 0 : 1;
+    }
+
+    // Windowless render benchmark / golden images: 3D-Maze --headless [options]
+    if (argc >= 2 && std::string(argv[1]) == "--headless") {
+        HeadlessOptions options;
+        if (!parseHeadlessOptions(argc, argv, options)) {
+            return 1;
+        }
+        if (options.software) {
+            return Game::runSoftware(options);
+        }
+
+        auto game = std::make_unique<Game>();
+        if (!game->initializeHeadless(options)) {
+            std::cerr << "Failed to initialize headless renderer" << std::endl;
+            return 1;
+        }
+        return game->runHeadless();
+    }
+
+    // Render command replay: 3D-Maze --replay FILE [options]
+    // Plays a --record file through the renderer headless, as fast as it goes
+    if (argc >= 3 && std::string(argv[1]) == "--replay") {
+        ReplayOptions replayOptions;
+        if (!parseReplayOptions(argc, argv, replayOptions)) {
+            return 1;
+        }
+
+        RenderRecording recording;
+        if (!recording.load(argv[2])) {
+            return 1;
+        }
+
+        // Same maze and size as the recorded run, so chunk indices line up
+        HeadlessOptions options;
+        options.seed = recording.getSeed();
+        options.width = recording.getWidth();
+        options.height = recording.getHeight();
+
+        auto game = std::make_unique<Game>();
+        if (!game->initializeHeadless(options)) {
+            std::cerr << "Failed to initialize headless renderer" << std::endl;
+            return 1;
+        }
+        return game->runReplay(recording, replayOptions);
+    }
 
-int main() {
     try {
         auto game = std::make_unique<Game>();
-        
+
+        // 3D-Maze --record FILE: write every frame's render commands for --replay
+        for (int i = 1; i + 1 < argc; ++i) {
+            if (std::string(argv[i]) == "--record") {
+                game->setRecordPath(argv[i + 1]);
+            }
+        }
+
         if (!game->initialize()) {
             std::cerr << "Failed to initialize game" << std::endl;
             return 1;
         }
 
+        // 3D-Maze --pipelined: simulate the next frame while the last one renders
+        for (int i = 1; i < argc; ++i) {
+            if (std::string(argv[i]) == "--pipelined") {
+                game->setPipelined(true);
+            }
+            // 3D-Maze --light-grid: point lights flood-filled over the maze instead of per pixel
+            else if (std::string(argv[i]) == "--light-grid") {
+                game->setLightGridEnabled(true);
+            }
+        }
+
         game->run();
 
     } catch (const std::exception& e) {
@@ -19,4 +216,4 @@ int main() {
     }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,47 @@
+#version 330 core
+// Adds the half-resolution effect colour to the scene (drawn with
+// upscale_vertex.glsl, blended GL_ONE, GL_ONE). Each pixel blends its 4
+// nearest half-resolution texels with bilinear weights, scaled down where
+// a texel's depth differs from the pixel's, so effects do not smear
+// across wall edges.
+out vec4 FragColor;
+
+uniform sampler2D sceneDepth;  // Full resolution
+uniform sampler2D halfColor;
+uniform sampler2D halfDepth;
+uniform vec2 u_halfMax;        // Last texel of the half-resolution rendered area
+uniform vec2 u_depthRange;     // Near and far plane
+
+float linearDepth(float depth) {
+    float near = u_depthRange.x;
+    float far = u_depthRange.y;
+    return near * far / (far - depth * (far - near));
+}
+
+void main() {
+    float depth = linearDepth(texelFetch(sceneDepth, ivec2(gl_FragCoord.xy), 0).r);
+
+    // Half-resolution texel i is centred on full-resolution pixel edge 2i + 1
+    vec2 position = gl_FragCoord.xy * 0.5 - 0.5;
+    vec2 cell = floor(position);
+    vec2 f = position - cell;
+    ivec2 base = ivec2(cell);
+    ivec2 maxTexel = ivec2(u_halfMax);
+
+    vec3 color = vec3(0.0);
+    float totalWeight = 0.0;
+    for (int i = 0; i < 4; i++) {
+        ivec2 offset = ivec2(i & 1, i >> 1);
+        ivec2 texel = clamp(base + offset, ivec2(0), maxTexel);
+
+        vec2 bilinear = mix(1.0 - f, f, vec2(offset));
+        float sampleDepth = linearDepth(texelFetch(halfDepth, texel, 0).r);
+        float weight = bilinear.x * bilinear.y / (0.001 + abs(sampleDepth - depth) / depth);
+
+        color += texelFetch(halfColor, texel, 0).rgb * weight;
+        totalWeight += weight;
+    }
+
+    // Alpha 0 leaves the scene's alpha alone under additive blending
+    FragColor = vec4(color / max(totalWeight, 1e-6), 0.0);
+}
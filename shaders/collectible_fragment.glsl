@@ -4,9 +4,9 @@ out vec4 FragColor;
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoord;
+flat in float Pulse;
 
 uniform float u_time;
-uniform float u_pulse;
 
 void main() {
     // Orange/Gold color scheme (contrasts with cyan portal)
@@ -18,7 +18,7 @@ void main() {
     float fresnel = pow(1.0 - abs(dot(normalize(Normal), viewDir)), 3.0);
     
     // Pulsing animation
-    float pulse = u_pulse;
+    float pulse = Pulse;
     
     // Energy pattern using UV coordinates
     float pattern = sin(TexCoord.x * 10.0 + u_time * 2.0) * 
@@ -6,12 +6,29 @@ layout (location = 2) in vec2 aTexCoord;
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoord;
+flat out float Pulse;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// Per-frame constants, streamed once per frame (see Renderer::uploadFrameData)
+layout(std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPosTime;  // xyz = camera position, w = time
+};
+
+// One entry per orb; the whole visible set is drawn instanced
+#define MAX_COLLECTIBLE_INSTANCES 128
+struct CollectibleInstance {
+    mat4 model;
+    vec4 params;  // x = pulse
+};
+layout(std140) uniform CollectibleInstances {
+    CollectibleInstance instances[MAX_COLLECTIBLE_INSTANCES];
+};
 
 void main() {
+    mat4 model = instances[gl_InstanceID].model;
+    Pulse = instances[gl_InstanceID].params.x;
+
     vec4 worldPos = model * vec4(aPos, 1.0);
     FragPos = worldPos.xyz;
     
@@ -0,0 +1,22 @@
+#version 330 core
+// Scene depth at half resolution (drawn with upscale_vertex.glsl). Each
+// texel keeps the farthest of the 2x2 pixels it covers, so an effect is
+// drawn wherever any of them can see it; the bilateral upsample sorts out
+// the edges. Writing the colour clears it for the effect pass at no cost.
+out vec4 FragColor;
+
+uniform sampler2D sceneDepth;
+uniform vec2 u_sceneMax;  // Last texel of the scene's rendered area
+
+void main() {
+    ivec2 texel = ivec2(gl_FragCoord.xy) * 2;
+    ivec2 maxTexel = ivec2(u_sceneMax);
+
+    float d0 = texelFetch(sceneDepth, min(texel, maxTexel), 0).r;
+    float d1 = texelFetch(sceneDepth, min(texel + ivec2(1, 0), maxTexel), 0).r;
+    float d2 = texelFetch(sceneDepth, min(texel + ivec2(0, 1), maxTexel), 0).r;
+    float d3 = texelFetch(sceneDepth, min(texel + ivec2(1, 1), maxTexel), 0).r;
+
+    gl_FragDepth = max(max(d0, d1), max(d2, d3));
+    FragColor = vec4(0.0);
+}
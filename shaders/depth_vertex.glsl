@@ -0,0 +1,19 @@
+#version 330 core
+// Depth pre-pass: positions only, computed exactly as in vertex.glsl
+layout (location = 0) in vec3 aPos;
+
+invariant gl_Position;
+
+uniform mat4 model;
+
+// Per-frame constants, streamed once per frame (see Renderer::uploadFrameData)
+layout(std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPosTime;  // xyz = camera position, w = time
+};
+
+void main() {
+    vec4 worldPos = model * vec4(aPos, 1.0);
+    gl_Position = projection * view * worldPos;
+}
@@ -1,4 +1,6 @@
 #version 330 core
+// Feature permutations are selected by Renderer through injected #defines:
+//   FLASHLIGHT, FOG, PORTAL_LIGHT, SPECULAR, TEXTURE_ARRAY, CLUSTERED_LIGHTS, LIGHTMAP, LIGHT_GRID
 out vec4 FragColor;
 
 in vec3 FragPos;
@@ -6,7 +8,12 @@ in vec3 Normal;
 in vec2 TexCoord;
 
 // Textures
+#ifdef TEXTURE_ARRAY
+uniform sampler2DArray textureSampler;  // One material per layer
+flat in float Layer;
+#else
 uniform sampler2D textureSampler;
+#endif
 
 // Camera/View
 uniform vec3 viewPos;
@@ -24,59 +31,121 @@ struct Material {
 };
 uniform Material material;
 
-// === NEW: FLASHLIGHT ===
-uniform bool u_flashlightEnabled;
+#ifdef FLASHLIGHT
 uniform vec3 u_flashlightPos;
 uniform vec3 u_flashlightDir;
 uniform float u_flashlightCutoff;      // Inner cone angle (cos)
 uniform float u_flashlightOuterCutoff; // Outer cone angle (cos)
 uniform float u_flashlightIntensity;
+#endif
 
-// === NEW: FOG ===
-uniform bool u_fogEnabled;
+#ifdef FOG
 uniform vec3 u_fogColor;
-uniform float u_fogDensity;
 uniform float u_fogStart;
 uniform float u_fogEnd;
+#endif
 
-// === NEW: PORTAL LIGHT ===
-uniform bool u_portalLightEnabled;
+#ifdef PORTAL_LIGHT
 uniform vec3 u_portalPos;
-uniform vec3 u_portalColor;
 uniform float u_portalRadius;
+#endif
+#if defined(PORTAL_LIGHT) || defined(LIGHTMAP)
+uniform vec3 u_portalColor;
+#endif
+
+#ifdef LIGHTMAP
+// Baked by LightmapBaker: rgb = ambient and overhead light, a = portal light intensity
+in vec2 LightmapCoord;
+uniform sampler2D u_lightmap;
+#endif
+
+#ifdef LIGHT_GRID
+// Flood-filled by LightGrid over the maze plan: rgb = light, a = 1 in open texels, 0 in walls
+uniform sampler2D u_lightGrid;
+uniform vec2 u_lightGridScale;   // Texture coordinates per world unit along x and z
+uniform float u_lightGridOffset; // Half a texel in world units
+#endif
+
+#ifdef CLUSTERED_LIGHTS
+// Per-frame constants, streamed once per frame (see Renderer::uploadFrameData)
+layout(std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPosTime;  // xyz = camera position, w = time
+};
+
+// Must match kMaxPointLights and ClusteredLighting::kTiles*/kSlices
+#define MAX_POINT_LIGHTS 256
+#define CLUSTER_TILES_X 16
+#define CLUSTER_TILES_Y 9
+#define CLUSTER_SLICES 24
+struct PointLight {
+    vec4 positionRadius;  // xyz = world position, w = radius
+    vec4 color;
+};
+layout(std140) uniform PointLights {
+    PointLight pointLights[MAX_POINT_LIGHTS];
+};
+
+uniform usamplerBuffer u_clusterTable;   // Per cluster: offset and count in u_clusterLights
+uniform usamplerBuffer u_clusterLights;  // Light indices, grouped by cluster
+uniform vec2 u_clusterTileScale;         // Tiles per pixel
+uniform vec2 u_clusterSlice;             // Slice = log(view depth) * x + y
+#endif
 
 void main() {
     // Sample texture
+#ifdef TEXTURE_ARRAY
+    vec4 texColor = texture(textureSampler, vec3(TexCoord, Layer));
+#else
     vec4 texColor = texture(textureSampler, TexCoord);
+#endif
     
     vec3 norm = normalize(Normal);
+#if defined(SPECULAR) || defined(FLASHLIGHT)
     vec3 viewDir = normalize(viewPos - FragPos);
+#endif
     
     // =====================================================
     // 1. AMBIENT LIGHTING (Base darkness)
     // =====================================================
+#ifdef LIGHTMAP
+    // Baked with occlusion, together with the overhead light and its bounce
+    vec4 baked = texture(u_lightmap, LightmapCoord);
+    vec3 ambient = baked.rgb * texColor.rgb;
+#else
     vec3 ambient = material.ambient * lightColor * texColor.rgb;
+#endif
     
     // =====================================================
     // 2. DIFFUSE LIGHTING (Overhead light - very subtle)
     // =====================================================
     vec3 lightDir = normalize(lightPos - FragPos);
+#ifdef LIGHTMAP
+    vec3 diffuse = vec3(0.0);  // In the lightmap
+#else
     float diff = max(dot(norm, lightDir), 0.0);
     vec3 diffuse = material.diffuse * diff * lightColor * texColor.rgb;
+#endif
     
     // =====================================================
     // 3. SPECULAR LIGHTING (Subtle highlights)
     // =====================================================
+#ifdef SPECULAR
     vec3 reflectDir = reflect(-lightDir, norm);
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
     vec3 specular = material.specular * spec * lightColor;
+#else
+    vec3 specular = vec3(0.0);
+#endif
     
     // =====================================================
     // 4. FLASHLIGHT (Main light source)
     // =====================================================
     vec3 flashlightContribution = vec3(0.0);
     
-    if (u_flashlightEnabled) {
+#ifdef FLASHLIGHT
+    {
         vec3 flashDir = normalize(u_flashlightPos - FragPos);
         float distance = length(u_flashlightPos - FragPos);
         
@@ -93,19 +162,30 @@ void main() {
         vec3 flashDiffuse = flashDiff * texColor.rgb * u_flashlightIntensity;
         
         // Flashlight specular
+#ifdef SPECULAR
         vec3 flashReflect = reflect(-flashDir, norm);
         float flashSpec = pow(max(dot(viewDir, flashReflect), 0.0), material.shininess * 2.0);
         vec3 flashSpecular = flashSpec * vec3(0.3);
+#else
+        vec3 flashSpecular = vec3(0.0);
+#endif
         
         flashlightContribution = (flashDiffuse + flashSpecular) * intensity * attenuation;
     }
+#endif
     
     // =====================================================
     // 5. PORTAL LIGHT (Cyan glow on nearby surfaces)
     // =====================================================
     vec3 portalContribution = vec3(0.0);
     
-    if (u_portalLightEnabled) {
+#ifdef LIGHTMAP
+    // Shadowed and bounced in the lightmap; only the pulsing colour is live
+    portalContribution = u_portalColor * baked.a;
+#endif
+    
+#ifdef PORTAL_LIGHT
+    {
         vec3 portalDir = u_portalPos - FragPos;
         float portalDist = length(portalDir);
         portalDir = normalize(portalDir);
@@ -119,28 +199,66 @@ void main() {
             portalContribution = u_portalColor * portalDiff * portalAttenuation * 0.8;
         }
     }
+#endif
     
     // =====================================================
-    // 6. COMBINE ALL LIGHTING
+    // 6. POINT LIGHTS (Portal, orbs; from the light grid, or only those in this cluster)
     // =====================================================
-    vec3 result = ambient + diffuse + specular + flashlightContribution + portalContribution;
+    vec3 pointContribution = vec3(0.0);
     
+#ifdef LIGHT_GRID
+    {
+        // Walls read the texel in front of them; dividing by the open
+        // fraction keeps wall texels out of the filter
+        vec2 gridPos = FragPos.xz + norm.xz * u_lightGridOffset;
+        vec4 grid = texture(u_lightGrid, gridPos * u_lightGridScale);
+        pointContribution = grid.rgb / max(grid.a, 1e-3);
+    }
+#endif
+    
+#ifdef CLUSTERED_LIGHTS
+    {
+        float viewDepth = -(view * vec4(FragPos, 1.0)).z;
+        ivec3 cluster = ivec3(ivec2(gl_FragCoord.xy * u_clusterTileScale),
+                              int(floor(log(viewDepth) * u_clusterSlice.x + u_clusterSlice.y)));
+        cluster = clamp(cluster, ivec3(0), ivec3(CLUSTER_TILES_X, CLUSTER_TILES_Y, CLUSTER_SLICES) - 1);
+        int clusterIndex = cluster.x + CLUSTER_TILES_X * (cluster.y + CLUSTER_TILES_Y * cluster.z);
+        
+        uvec2 range = texelFetch(u_clusterTable, clusterIndex).rg;
+        for (uint i = 0u; i < range.y; ++i) {
+            PointLight light = pointLights[texelFetch(u_clusterLights, int(range.x + i)).r];
+            vec3 toLight = light.positionRadius.xyz - FragPos;
+            float lightDist = length(toLight);
+            
+            // Same falloff as the portal light: quadratic, zero at the radius
+            if (lightDist < light.positionRadius.w) {
+                float lightDiff = max(dot(norm, toLight / lightDist), 0.0);
+                float falloff = 1.0 - lightDist / light.positionRadius.w;
+                pointContribution += light.color.rgb * lightDiff * falloff * falloff;
+            }
+        }
+    }
+#endif
+    
+    // =====================================================
+    // 7. COMBINE ALL LIGHTING
     // =====================================================
-    // 7. FOG (Distance-based darkness)
+    vec3 result = ambient + diffuse + specular + flashlightContribution + portalContribution + pointContribution;
+    
     // =====================================================
-    if (u_fogEnabled) {
+    // 8. FOG (Distance-based darkness)
+    // =====================================================
+#ifdef FOG
+    {
         float distance = length(viewPos - FragPos);
         
         // Linear fog
         float fogFactor = (u_fogEnd - distance) / (u_fogEnd - u_fogStart);
         fogFactor = clamp(fogFactor, 0.0, 1.0);
         
-        // Exponential fog (optional, looks better)
-        // fogFactor = exp(-u_fogDensity * distance);
-        // fogFactor = clamp(fogFactor, 0.0, 1.0);
-        
         result = mix(u_fogColor, result, fogFactor);
     }
+#endif
     
     FragColor = vec4(result, 1.0);
 }
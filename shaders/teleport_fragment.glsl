@@ -6,40 +6,17 @@ in vec3 Normal;
 in vec3 FragPos;
 in vec3 WorldPos;
 
-uniform sampler2D textureSampler;
+uniform sampler2D u_noise;     // Tileable fBm (NoiseTexture), bound repeating
 uniform float u_time;
 uniform vec3 u_portalCenter; // Center position of the portal
 
-// Noise function for procedural effects
-float hash(vec2 p) {
-    return fract(sin(dot(p, vec2(127.1, 311.7))) * 43758.5453);
-}
-
-float noise(vec2 p) {
-    vec2 i = floor(p);
-    vec2 f = fract(p);
-    f = f * f * (3.0 - 2.0 * f);
-    
-    float a = hash(i);
-    float b = hash(i + vec2(1.0, 0.0));
-    float c = hash(i + vec2(0.0, 1.0));
-    float d = hash(i + vec2(1.0, 1.0));
-    
-    return mix(mix(a, b, f.x), mix(c, d, f.x), f.y);
-}
+// Lattice cells of the noise's first octave across one tile of u_noise
+const float NOISE_PERIOD = 16.0;
 
-// Fractal Brownian Motion for complex patterns
+// Fractal Brownian Motion for complex patterns: 4 octaves of value noise,
+// precomputed, so one filtered fetch instead of 16 hashes per call
 float fbm(vec2 p) {
-    float value = 0.0;
-    float amplitude = 0.5;
-    float frequency = 1.0;
-    
-    for(int i = 0; i < 4; i++) {
-        value += amplitude * noise(p * frequency);
-        frequency *= 2.0;
-        amplitude *= 0.5;
-    }
-    return value;
+    return texture(u_noise, p / NOISE_PERIOD).r;
 }
 
 void main() {
@@ -96,11 +73,11 @@ void main() {
     // === COMBINE ALL EFFECTS ===
     vec3 finalColor = vec3(0.0);
     
-    // Core cylinder with flowing texture
+    // Core cylinder with flowing noise; one tile wraps exactly once around it
     vec2 flowingUV = TexCoord;
     flowingUV.y -= u_time * 0.3;
-    vec4 texColor = texture(textureSampler, flowingUV);
-    finalColor += texColor.rgb * coreColor * cylinderGlow * 0.8;
+    float flow = texture(u_noise, flowingUV).r;
+    finalColor += flow * coreColor * cylinderGlow * 0.8;
     
     // Add vertical beams (brightest)
     finalColor += coreColor * beamIntensity * 2.0;
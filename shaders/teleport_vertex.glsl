@@ -9,8 +9,13 @@ out vec3 FragPos;
 out vec3 WorldPos;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+// Per-frame constants, streamed once per frame (see Renderer::uploadFrameData)
+layout(std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPosTime;  // xyz = camera position, w = time
+};
 
 void main() {
     vec4 worldPosition = model * vec4(aPos, 1.0);
@@ -0,0 +1,36 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+uniform sampler2D sceneTexture;
+uniform vec2 u_uvScale;     // Rendered area / texture size
+uniform vec2 u_texelSize;   // 1 / texture size
+uniform float u_sharpness;  // 0 = plain bilinear
+
+void main() {
+    // Stay half a texel inside the rendered area so bilinear taps never
+    // read the stale part of the texture
+    vec2 maxUv = u_uvScale - 0.5 * u_texelSize;
+    vec2 uv = min(TexCoord * u_uvScale, maxUv);
+
+    vec3 center = texture(sceneTexture, uv).rgb;
+    if (u_sharpness <= 0.0) {
+        FragColor = vec4(center, 1.0);
+        return;
+    }
+
+    // Unsharp mask over the 4 neighbours restores edges softened by the upscale
+    vec3 north = texture(sceneTexture, min(uv + vec2(0.0, u_texelSize.y), maxUv)).rgb;
+    vec3 south = texture(sceneTexture, max(uv - vec2(0.0, u_texelSize.y), 0.5 * u_texelSize)).rgb;
+    vec3 east = texture(sceneTexture, min(uv + vec2(u_texelSize.x, 0.0), maxUv)).rgb;
+    vec3 west = texture(sceneTexture, max(uv - vec2(u_texelSize.x, 0.0), 0.5 * u_texelSize)).rgb;
+
+    vec3 blur = (north + south + east + west) * 0.25;
+    vec3 sharpened = center + (center - blur) * u_sharpness;
+
+    // Clamp to the local range so sharpening cannot ring
+    vec3 lo = min(center, min(min(north, south), min(east, west)));
+    vec3 hi = max(center, max(max(north, south), max(east, west)));
+    FragColor = vec4(clamp(sharpened, lo, hi), 1.0);
+}
@@ -2,14 +2,28 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoord;
+layout (location = 3) in float aLayer;
+layout (location = 4) in vec2 aLightmapCoord;
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoord;
+flat out float Layer;  // Material layer for TEXTURE_ARRAY
+#ifdef LIGHTMAP
+out vec2 LightmapCoord;
+#endif
+
+// Must match depth_vertex.glsl exactly, so the depth pre-pass and this pass agree
+invariant gl_Position;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+// Per-frame constants, streamed once per frame (see Renderer::uploadFrameData)
+layout(std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPosTime;  // xyz = camera position, w = time
+};
 
 void main() {
     vec4 worldPos = model * vec4(aPos, 1.0);
@@ -20,4 +34,8 @@ void main() {
     // Transform normal to world space
     Normal = mat3(transpose(inverse(model))) * aNormal;
     TexCoord = aTexCoord;
+    Layer = aLayer;
+#ifdef LIGHTMAP
+    LightmapCoord = aLightmapCoord;
+#endif
 }